@@ -40,6 +40,72 @@ namespace Nv {
 namespace Blast{
 
 
+/**
+Improve the geometric accuracy of a closest node found by chunk centroid distance, by looking on which side of its
+closest bond the point lies. Bond normals are expected to be directed from the lower to higher node index.
+
+\param[in]	point						the point to test against
+\param[in]	closestNode					the node with the chunk centroid closest to point, must not be the world chunk
+\param[in]	adjacencyPartition			the actor's SupportGraph adjacency partition
+\param[in]	adjacentNodeIndices			the actor's SupportGraph adjacent node indices
+\param[in]	adjacentBondIndices			the actor's SupportGraph adjacent bond indices
+\param[in]	assetBonds					the actor's asset bonds
+\param[in]	bondHealths					the actor's bond healths
+\param[in]	supportChunkHealths			the actor's graph chunks healths
+\param[in]	chunkIndices				maps node index to chunk index in SupportGraph
+
+\return		closestNode or the neighbor across its closest bond
+*/
+NV_FORCE_INLINE	uint32_t refineClosestNode(const float point[4], uint32_t closestNode,
+	const uint32_t* adjacencyPartition, const uint32_t* adjacentNodeIndices, const uint32_t* adjacentBondIndices,
+	const NvBlastBond* assetBonds, const float* bondHealths,
+	const float* supportChunkHealths, const uint32_t* chunkIndices)
+{
+	// expects bond normals to point from the smaller to the larger node index
+
+	const uint32_t nodeIndex = closestNode;
+	float minDist = std::numeric_limits<float>().max();
+
+	const uint32_t startIndex = adjacencyPartition[nodeIndex];
+	const uint32_t stopIndex = adjacencyPartition[nodeIndex + 1];
+
+	for (uint32_t adjacentIndex = startIndex; adjacentIndex < stopIndex; adjacentIndex++)
+	{
+		const uint32_t neighbourIndex = adjacentNodeIndices[adjacentIndex];
+		const uint32_t neighbourChunk = chunkIndices[neighbourIndex];
+		if (!isInvalidIndex(neighbourChunk)) // Invalid if neighbor is the world chunk
+		{
+			const uint32_t bondIndex = adjacentBondIndices[adjacentIndex];
+			// do not follow broken bonds, since it means that neighbor is not actually connected in the graph
+			if (bondHealths[bondIndex] > 0.0f && supportChunkHealths[neighbourIndex] > 0.0f)
+			{
+				const NvBlastBond& bond = assetBonds[bondIndex];
+
+				const float* centroid = bond.centroid;
+				float d[3]; VecMath::sub(point, centroid, d);
+				float dist = VecMath::dot(d, d);
+
+				if (dist < minDist)
+				{
+					minDist = dist;
+					float s = VecMath::dot(d, bond.normal);
+					if (nodeIndex < neighbourIndex)
+					{
+						closestNode = s < 0.0f ? nodeIndex : neighbourIndex;
+					}
+					else
+					{
+						closestNode = s < 0.0f ? neighbourIndex : nodeIndex;
+					}
+				}
+			}
+		}
+	}
+
+	return closestNode;
+}
+
+
 /**
 Find the closest node to point in the graph. Uses primarily distance to chunk centroids.
 Bond normals are expected to be directed from the lower to higher node index.
@@ -100,53 +166,9 @@ NV_FORCE_INLINE	uint32_t findClosestNode(const float point[4],
 	// as long as the world chunk is not input as a single-node graph actor
 	NVBLAST_ASSERT(!isInvalidIndex(chunkIndices[closestNode]));
 
-	bool iterateOnBonds = true;
-	if (iterateOnBonds)
-	{
-		// improve geometric accuracy by looking on which side of the closest bond the point lies
-		// expects bond normals to point from the smaller to the larger node index
-
-		nodeIndex = closestNode;
-		minDist = std::numeric_limits<float>().max();
-
-		const uint32_t startIndex = adjacencyPartition[nodeIndex];
-		const uint32_t stopIndex = adjacencyPartition[nodeIndex + 1];
-
-		for (uint32_t adjacentIndex = startIndex; adjacentIndex < stopIndex; adjacentIndex++)
-		{
-			const uint32_t neighbourIndex = adjacentNodeIndices[adjacentIndex];
-			const uint32_t neighbourChunk = chunkIndices[neighbourIndex];
-			if (!isInvalidIndex(neighbourChunk)) // Invalid if neighbor is the world chunk
-			{
-				const uint32_t bondIndex = adjacentBondIndices[adjacentIndex];
-				// do not follow broken bonds, since it means that neighbor is not actually connected in the graph
-				if (bondHealths[bondIndex] > 0.0f && supportChunkHealths[neighbourIndex] > 0.0f)
-				{
-					const NvBlastBond& bond = assetBonds[bondIndex];
-
-					const float* centroid = bond.centroid;
-					float d[3]; VecMath::sub(point, centroid, d);
-					float dist = VecMath::dot(d, d);
-
-					if (dist < minDist)
-					{
-						minDist = dist;
-						float s = VecMath::dot(d, bond.normal);
-						if (nodeIndex < neighbourIndex)
-						{
-							closestNode = s < 0.0f ? nodeIndex : neighbourIndex;
-						}
-						else
-						{
-							closestNode = s < 0.0f ? neighbourIndex : nodeIndex;
-						}
-					}
-				}
-			}
-		}
-	}
-
-	return closestNode;
+	// improve geometric accuracy by looking on which side of the closest bond the point lies
+	return refineClosestNode(point, closestNode, adjacencyPartition, adjacentNodeIndices, adjacentBondIndices,
+		assetBonds, bondHealths, supportChunkHealths, chunkIndices);
 }
 
 
@@ -19,14 +19,24 @@ SET(COMMON_FILES
 
 SET(PUBLIC_FILES
 	${SHADERS_EXT_INCLUDE_DIR}/NvBlastExtDamageShaders.h
+	${SHADERS_EXT_INCLUDE_DIR}/NvBlastExtDamageField.h
+	${SHADERS_EXT_INCLUDE_DIR}/NvBlastExtDamageCoalescer.h
 )
 
 SET(EXT_SOURCE_FILES
 	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageShaders.cpp
+	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageExpression.cpp
 	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageAcceleratorInternal.h
 	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageAcceleratorAABBTree.h
 	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageAcceleratorAABBTree.cpp
+	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageAcceleratorBVH4.h
+	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageAcceleratorBVH4.cpp
+	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageNodeTree.h
+	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageNodeTree.cpp
 	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageAccelerators.cpp
+	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamageField.cpp
+	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamagePattern.h
+	${SHADERS_EXT_SOURCE_DIR}/NvBlastExtDamagePattern.cpp
 )
 
 ADD_LIBRARY(NvBlastExtShaders ${BLAST_EXT_SHARED_LIB_TYPE} 
@@ -22,6 +22,8 @@ SET(COMMON_FILES
 	
 	${COMMON_SOURCE_DIR}/NvBlastAssert.cpp
 	${COMMON_SOURCE_DIR}/NvBlastAssert.h
+	${COMMON_SOURCE_DIR}/NvBlastTime.cpp
+	${COMMON_SOURCE_DIR}/NvBlastTime.h
 )
 
 SET(STRESS_SOURCE_FILES
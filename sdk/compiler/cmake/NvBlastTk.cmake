@@ -68,6 +68,8 @@ SET(TOOLKIT_FILES
 	${TOOLKIT_DIR}/source/NvBlastTkGUID.h
 	${TOOLKIT_DIR}/source/NvBlastTkJointImpl.cpp
 	${TOOLKIT_DIR}/source/NvBlastTkJointImpl.h
+	${TOOLKIT_DIR}/source/NvBlastTkScratchPool.cpp
+	${TOOLKIT_DIR}/source/NvBlastTkScratchPool.h
 	${TOOLKIT_DIR}/source/NvBlastTkTaskImpl.cpp
 	${TOOLKIT_DIR}/source/NvBlastTkTaskImpl.h
 	${TOOLKIT_DIR}/source/NvBlastTkTypeImpl.h
@@ -32,6 +32,7 @@
 #include "NvBlastTkFramework.h"
 #include "PxConvexMeshGeometry.h"
 #include "PxTransform.h"
+#include "PxMat33.h"
 #include "NvBlastPreprocessor.h"
 
 
@@ -115,6 +116,20 @@ struct ExtPxChunk
 };
 
 
+/**
+Physics Chunk mass properties.
+
+Combined mass properties of the chunk's subchunks at unit density, in actor space. Precomputed by the asset so that
+actor mass properties can be combined from those of their chunks instead of being integrated over the convexes at split.
+*/
+struct ExtPxChunkMassProperties
+{
+	physx::PxMat33	inertiaTensor;		//!<	inertia tensor about the center of mass
+	physx::PxVec3	centerOfMass;		//!<	center of mass
+	float			mass;				//!<	mass at unit density, the volume. 0 for chunks without subchunks.
+};
+
+
 /**
 Asset.
 
@@ -207,6 +222,13 @@ public:
 	*/
 	virtual const ExtPxSubchunk*	getSubchunks() const = 0;
 
+	/**
+	Access asset's array of chunk mass properties, of size getChunkCount(). @see ExtPxChunkMassProperties.
+
+	\return	a pointer to an array of chunk mass properties, or nullptr if they haven't been computed.
+	*/
+	virtual const ExtPxChunkMassProperties*	getChunkMassProperties() const = 0;
+
 	/**
 	Get the default NvBlastActorDesc to be used when creating family from this asset. It is called 'default', 
 	because it can be overwritten in ExtPxManager::createFamily(...) function.
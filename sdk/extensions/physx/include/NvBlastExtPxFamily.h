@@ -204,6 +204,32 @@ public:
 	*/
 	virtual const ExtPxActorDescTemplate*	getPxActorDesc() const = 0;
 
+	/**
+	Enable or disable recycling of PhysX objects across splits. Disabled by default.
+
+	When enabled, the subchunk PxShapes of a destroyed actor are detached from its PxRigidDynamic and kept, to be attached
+	to the new actor containing the subchunk instead of being created again. Its PxRigidDynamic is pooled and reused for a
+	new actor, unless joints or shapes other than subchunk shapes are still attached to it.
+
+	Recycled shapes keep their geometry and local pose, their material, flags, filter data and offsets are set again from
+	the shape desc template, or reset to the new shape defaults if there is none. Shapes not reclaimed by the new actors of
+	a split are released, and at most 32 PxRigidDynamics are pooled. Recycled PxRigidDynamics get their pose, flags,
+	velocities and mass properties set again, other changes made to them by the user are kept and should be undone in
+	ExtPxListener::onActorDestroyed.
+
+	Disabling releases the recycled objects.
+
+	\param[in] enabled			true to recycle PxShapes and PxRigidDynamics.
+	*/
+	virtual void							setRecyclingEnabled(bool enabled) = 0;
+
+	/**
+	Get if PhysX objects are recycled across splits. @see setRecyclingEnabled.
+
+	\return true if recycling is enabled.
+	*/
+	virtual bool							isRecyclingEnabled() const = 0;
+
 	/**
 	The default material associated with this actor family.
 
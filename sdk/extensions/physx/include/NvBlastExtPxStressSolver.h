@@ -33,6 +33,13 @@
 #include "common/PxRenderBuffer.h"
 
 
+// Forward declarations
+namespace physx
+{
+class PxTaskManager;
+}
+
+
 namespace Nv
 {
 namespace Blast
@@ -49,6 +56,10 @@ Uses ExtPxFamily and ExtStressSolver. see #ExtStressSolver for more details.
 Works on both dynamic and static actor's within family.
 For static actors it applies gravity.
 For dynamic actors it applies centrifugal force.
+
+The update can be run synchronously with update(), or on a task with beginUpdate() and endUpdate(), e.g. around 
+PxScene::simulate() and PxScene::fetchResults(). With one frame latency, the solve task runs until the next 
+beginUpdate() and its damage is applied one frame late.
 */
 class NV_DLL_EXPORT ExtPxStressSolver
 {
@@ -88,6 +99,40 @@ public:
 	\param[in]	doDamage		If 'true' damage will be applied after stress solver.
 	*/
 	virtual void							update(bool doDamage = true) = 0;
+
+	/**
+	Start updating stress solver on a task.
+
+	Forces are applied on the calling thread, stress is then calculated on a task submitted to the task manager.
+	While the task runs, damage which creates or destroys actors in the family waits for it to end.
+
+	\param[in]	taskManager		The task manager to submit the task to, e.g. PxScene::getTaskManager().
+
+	\return true if the task was started, false if the previous beginUpdate() wasn't ended with endUpdate().
+	*/
+	virtual bool							beginUpdate(physx::PxTaskManager& taskManager) = 0;
+
+	/**
+	End the update started with beginUpdate().
+
+	Waits for the task to end, then optionally applies damage. With one frame latency, doesn't wait and damage is applied 
+	by the next beginUpdate() or update() call instead.
+
+	\param[in]	doDamage		If 'true' damage will be applied after stress solver.
+	*/
+	virtual void							endUpdate(bool doDamage = true) = 0;
+
+	/**
+	Set one frame latency mode for beginUpdate() and endUpdate(). @see endUpdate()
+
+	\param[in]	enabled			If 'true' the task runs until the next beginUpdate() call.
+	*/
+	virtual void							setOneFrameLatency(bool enabled) = 0;
+
+	/**
+	\return true if one frame latency mode is enabled.
+	*/
+	virtual bool							getOneFrameLatency() const = 0;
 };
 
 
@@ -40,6 +40,7 @@
 #include "NvBlastTkAsset.h"
 
 #include "PxRigidBodyExt.h"
+#include "PxMassProperties.h"
 
 
 namespace Nv
@@ -48,6 +49,44 @@ namespace Blast
 {
 
 
+/**
+Set the actor's mass properties from the precomputed ones of its chunks, combined with the parallel axis theorem.
+Returns false if the chunks have no mass.
+*/
+static bool setChunksMassProperties(PxRigidDynamic& rigidDynamic, const ExtPxChunkMassProperties* chunkMassProperties, const uint32_t* chunkIndices, uint32_t chunkCount, float density)
+{
+	float mass = 0.0f;
+	PxVec3 centerOfMass(PxZero);
+	for (uint32_t i = 0; i < chunkCount; ++i)
+	{
+		const ExtPxChunkMassProperties& chunk = chunkMassProperties[chunkIndices[i]];
+		mass += chunk.mass;
+		centerOfMass += chunk.centerOfMass * chunk.mass;
+	}
+
+	if (mass <= 0.0f)
+	{
+		return false;
+	}
+	centerOfMass /= mass;
+
+	PxMat33 inertiaTensor(PxZero);
+	for (uint32_t i = 0; i < chunkCount; ++i)
+	{
+		const ExtPxChunkMassProperties& chunk = chunkMassProperties[chunkIndices[i]];
+		inertiaTensor += PxMassProperties::translateInertia(chunk.inertiaTensor, chunk.mass, chunk.centerOfMass - centerOfMass);
+	}
+
+	PxQuat massFrame;
+	const PxVec3 massSpaceInertia = PxMassProperties::getMassSpaceInertia(inertiaTensor * density, massFrame);
+
+	rigidDynamic.setMass(mass * density);
+	rigidDynamic.setMassSpaceInertiaTensor(massSpaceInertia);
+	rigidDynamic.setCMassLocalPose(PxTransform(centerOfMass, massFrame));
+	return true;
+}
+
+
 ExtPxActorImpl::ExtPxActorImpl(ExtPxFamilyImpl* family, TkActor* tkActor, const PxActorCreateInfo& pxActorInfo)
 	: m_family(family), m_tkActor(tkActor)
 {
@@ -89,16 +128,22 @@ ExtPxActorImpl::ExtPxActorImpl(ExtPxFamilyImpl* family, TkActor* tkActor, const
 		}
 	}
 
-	// create rigidDynamic and setup
+	// create (or reuse) rigidDynamic and setup
 	PxPhysics& physics = m_family->m_manager.m_physics;
-	m_rigidDynamic = physics.createRigidDynamic(pxActorInfo.m_transform);
+	bool isRecycled;
+	m_rigidDynamic = m_family->acquireRigidDynamic(pxActorInfo.m_transform, isRecycled);
 	if (m_family->m_pxActorDescTemplate != nullptr)
 	{
 		m_rigidDynamic->setActorFlags(static_cast<physx::PxActorFlags>(m_family->m_pxActorDescTemplate->flags));
 	}
+	else if (isRecycled)
+	{
+		m_rigidDynamic->setActorFlags(PxActorFlag::eVISUALIZATION);	// new actor default
+	}
 
 	// fill rigidDynamic with shapes
 	PxMaterial* material = m_family->m_spawnSettings.material;
+	const float defaultContactOffset = 0.02f * physics.getTolerancesScale().length;	// PxShape default
 	for (uint32_t i = 0; i < m_chunkIndices.size(); ++i)
 	{
 		uint32_t chunkID = m_chunkIndices[i];
@@ -107,8 +152,18 @@ ExtPxActorImpl::ExtPxActorImpl(ExtPxFamilyImpl* family, TkActor* tkActor, const
 		{
 			const uint32_t subchunkIndex = chunk.firstSubchunkIndex + c;
 			auto& subchunk = pxSubchunks[subchunkIndex];
-			PxShape* shape = physics.createShape(subchunk.geometry, *material);
-			shape->setLocalPose(subchunk.transform);
+			PxShape* shape = m_family->m_isRecyclingEnabled ? m_family->m_recycledShapes[subchunkIndex] : nullptr;
+			const bool isShapeRecycled = shape != nullptr;
+			if (isShapeRecycled)
+			{
+				m_family->m_recycledShapes[subchunkIndex] = nullptr;
+				shape->setMaterials(&material, 1);
+			}
+			else
+			{
+				shape = physics.createShape(subchunk.geometry, *material);
+				shape->setLocalPose(subchunk.transform);
+			}
 
 			const ExtPxShapeDescTemplate* pxShapeDesc = m_family->m_pxShapeDescTemplate;
 			if (pxShapeDesc != nullptr)
@@ -121,6 +176,14 @@ ExtPxActorImpl::ExtPxActorImpl(ExtPxFamilyImpl* family, TkActor* tkActor, const
 			}
 			else
 			{
+				if (isShapeRecycled)
+				{
+					// new shape defaults
+					shape->setFlags(PxShapeFlag::eVISUALIZATION | PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE);
+					shape->setQueryFilterData(PxFilterData());
+					shape->setRestOffset(0.0f);
+					shape->setContactOffset(defaultContactOffset);
+				}
 				shape->setSimulationFilterData(simulationFilterData);
 			}
 
@@ -155,8 +218,12 @@ ExtPxActorImpl::ExtPxActorImpl(ExtPxFamilyImpl* family, TkActor* tkActor, const
 	// store pointer to actor in blast userData
 	m_tkActor->userData = this;
 
-	// update mass properties
-	PxRigidBodyExt::updateMassAndInertia(*m_rigidDynamic, m_family->m_spawnSettings.density);
+	// update mass properties, from the chunks' when the asset has them
+	const ExtPxChunkMassProperties* chunkMassProperties = m_family->m_pxAsset.getChunkMassProperties();
+	if (chunkMassProperties == nullptr || !setChunksMassProperties(*m_rigidDynamic, chunkMassProperties, m_chunkIndices.begin(), m_chunkIndices.size(), m_family->m_spawnSettings.density))
+	{
+		PxRigidBodyExt::updateMassAndInertia(*m_rigidDynamic, m_family->m_spawnSettings.density);
+	}
 
 	// set initial velocities
 	if (!(m_rigidDynamic->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
@@ -171,12 +238,7 @@ ExtPxActorImpl::ExtPxActorImpl(ExtPxFamilyImpl* family, TkActor* tkActor, const
 
 void ExtPxActorImpl::release()
 {
-	if (m_rigidDynamic != nullptr)
-	{
-		m_family->m_manager.unregisterActor(m_rigidDynamic);
-		m_rigidDynamic->release();
-		m_rigidDynamic = nullptr;
-	}
+	const bool recycleShapes = m_family->m_isRecyclingEnabled && m_rigidDynamic != nullptr;
 
 	const ExtPxChunk* pxChunks = m_family->m_pxAsset.getChunks();
 	for (uint32_t chunkID : m_chunkIndices)
@@ -185,11 +247,24 @@ void ExtPxActorImpl::release()
 		for (uint32_t c = 0; c < chunk.subchunkCount; c++)
 		{
 			const uint32_t subchunkIndex = chunk.firstSubchunkIndex + c;
-			m_family->m_subchunkShapes[subchunkIndex] = nullptr;
+			PxShape*& shape = m_family->m_subchunkShapes[subchunkIndex];
+			if (recycleShapes && shape != nullptr)
+			{
+				m_rigidDynamic->detachShape(*shape, false);
+				m_family->m_recycledShapes[subchunkIndex] = shape;
+			}
+			shape = nullptr;
 		}
 	}
 	m_chunkIndices.clear();
 
+	if (m_rigidDynamic != nullptr)
+	{
+		m_family->m_manager.unregisterActor(m_rigidDynamic);
+		m_family->recycleRigidDynamic(*m_rigidDynamic);
+		m_rigidDynamic = nullptr;
+	}
+
 	m_tkActor->userData = nullptr;
 }
 
@@ -37,6 +37,7 @@
 #include "PxIO.h"
 #include "PxPhysics.h"
 #include "PxFileBuf.h"
+#include "PxMassProperties.h"
 #include "cooking/PxCooking.h"
 
 #include <algorithm>
@@ -63,6 +64,7 @@ ExtPxAssetImpl::ExtPxAssetImpl(const ExtPxAssetDesc& desc, TkFramework& framewor
 #endif
 	m_tkAsset = framework.createAsset(desc);
 	fillPhysicsChunks(desc.pxChunks, desc.chunkCount);
+	updateChunkMassProperties();
 }
 
 ExtPxAssetImpl::ExtPxAssetImpl(const TkAssetDesc& desc, ExtPxChunk* pxChunks, ExtPxSubchunk* pxSubchunks, TkFramework& framework)
@@ -77,6 +79,7 @@ ExtPxAssetImpl::ExtPxAssetImpl(const TkAssetDesc& desc, ExtPxChunk* pxChunks, Ex
 #endif
 	m_tkAsset = framework.createAsset(desc);
 	fillPhysicsChunks(pxChunks, pxSubchunks, desc.chunkCount);
+	updateChunkMassProperties();
 }
 
 ExtPxAssetImpl::ExtPxAssetImpl(TkAsset* asset, ExtPxAssetDesc::ChunkDesc* chunks, uint32_t chunkCount)
@@ -92,6 +95,7 @@ ExtPxAssetImpl::ExtPxAssetImpl(TkAsset* asset, ExtPxAssetDesc::ChunkDesc* chunks
 #endif
 	m_tkAsset = asset;		
 	fillPhysicsChunks(chunks, chunkCount);
+	updateChunkMassProperties();
 }
 
 
@@ -167,6 +171,38 @@ void ExtPxAssetImpl::fillPhysicsChunks(ExtPxAssetDesc::ChunkDesc* pxChunks, uint
 	}
 }
 
+void ExtPxAssetImpl::updateChunkMassProperties()
+{
+	Array<PxMassProperties>::type subchunkMassProperties;
+	Array<PxTransform>::type subchunkTransforms;
+
+	m_chunkMassProperties.resize(m_chunks.size());
+	for (uint32_t i = 0; i < m_chunks.size(); ++i)
+	{
+		const ExtPxChunk& chunk = m_chunks[i];
+
+		subchunkMassProperties.clear();
+		subchunkTransforms.clear();
+		for (uint32_t k = 0; k < chunk.subchunkCount; ++k)
+		{
+			const ExtPxSubchunk& subchunk = m_subchunks[chunk.firstSubchunkIndex + k];
+			if (subchunk.geometry.convexMesh != nullptr)
+			{
+				subchunkMassProperties.pushBack(PxMassProperties(subchunk.geometry));
+				subchunkTransforms.pushBack(subchunk.transform);
+			}
+		}
+
+		const PxMassProperties massProperties = subchunkMassProperties.empty() ? PxMassProperties() :
+			PxMassProperties::sum(subchunkMassProperties.begin(), subchunkTransforms.begin(), subchunkMassProperties.size());
+
+		ExtPxChunkMassProperties& chunkMassProperties = m_chunkMassProperties[i];
+		chunkMassProperties.inertiaTensor = massProperties.inertiaTensor;
+		chunkMassProperties.centerOfMass = massProperties.centerOfMass;
+		chunkMassProperties.mass = massProperties.mass;
+	}
+}
+
 
 NV_INLINE bool serializeConvexMesh(const PxConvexMesh& convexMesh, PxCooking& cooking, Array<uint32_t>::type& indicesScratch, 
 	Array<PxHullPolygon>::type hullPolygonsScratch, PxOutputStream& stream)
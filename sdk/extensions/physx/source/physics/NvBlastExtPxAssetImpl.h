@@ -93,6 +93,11 @@ public:
 		return m_subchunks.begin();
 	}
 
+	virtual const ExtPxChunkMassProperties*	getChunkMassProperties() const override
+	{
+		return m_chunkMassProperties.size() == m_chunks.size() && !m_chunks.empty() ? m_chunkMassProperties.begin() : nullptr;
+	}
+
 	virtual NvBlastActorDesc&		getDefaultActorDesc() override
 	{
 		return m_defaultActorDesc;
@@ -138,6 +143,11 @@ public:
 	*/
 	Array<float>::type&				getSupportChunkHealthsArray() { return m_supportChunkHealths; }
 
+	/**
+	Compute the chunk mass properties from the subchunks. Used for serialization, once chunks and subchunks are filled.
+	*/
+	void							updateChunkMassProperties();
+
 private:
 
 	////////   initialization   /////////
@@ -150,6 +160,7 @@ private:
 	TkAsset*					 m_tkAsset;
 	Array<ExtPxChunk>::type		 m_chunks;
 	Array<ExtPxSubchunk>::type	 m_subchunks;
+	Array<ExtPxChunkMassProperties>::type m_chunkMassProperties;
 	Array<float>::type			 m_bondHealths;
 	Array<float>::type			 m_supportChunkHealths;
 	NvBlastExtDamageAccelerator* m_accelerator;
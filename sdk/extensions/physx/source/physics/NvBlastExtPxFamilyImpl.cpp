@@ -40,6 +40,8 @@
 
 #include "PxRigidDynamic.h"
 #include "PxScene.h"
+#include "PxShape.h"
+#include "PxPhysics.h"
 
 #include <algorithm>
 
@@ -58,6 +60,7 @@ ExtPxFamilyImpl::ExtPxFamilyImpl(ExtPxManagerImpl& manager, TkFamily& tkFamily,
 	, m_pxActorDescTemplate(nullptr)
 	, m_material(nullptr)
 	, m_isSpawned(false)
+	, m_isRecyclingEnabled(false)
 {
 	m_subchunkShapes.resize(static_cast<uint32_t>(m_pxAsset.getSubchunkCount()));
 
@@ -84,6 +87,8 @@ ExtPxFamilyImpl::~ExtPxFamilyImpl()
 		destroyActors(actors.begin(), actors.size());
 	}
 
+	releaseRecycled();
+
 	m_tkFamily.release();
 }
 
@@ -223,6 +228,12 @@ void ExtPxFamilyImpl::receive(const TkEvent* events, uint32_t eventCount)
 		totalNewActorsCount = cappedNewActorsCount;	// In case it's used below
 	}
 
+	// shapes not claimed by the new actors (culled or invisible chunks) aren't kept around
+	if (m_isRecyclingEnabled)
+	{
+		releaseRecycledShapes();
+	}
+
 	for (uint32_t i = 0; i < eventCount; ++i)
 	{
 		const TkEvent& e = events[i];
@@ -292,6 +303,74 @@ void ExtPxFamilyImpl::destroyActors(ExtPxActor** actors, uint32_t count)
 	}
 }
 
+void ExtPxFamilyImpl::setRecyclingEnabled(bool enabled)
+{
+	if (enabled)
+	{
+		m_recycledShapes.resize(m_subchunkShapes.size(), nullptr);
+	}
+	else
+	{
+		releaseRecycled();
+	}
+	m_isRecyclingEnabled = enabled;
+}
+
+PxRigidDynamic* ExtPxFamilyImpl::acquireRigidDynamic(const PxTransform& pose, bool& isRecycled)
+{
+	isRecycled = !m_recycledRigidDynamics.empty();
+	if (!isRecycled)
+	{
+		return m_manager.m_physics.createRigidDynamic(pose);
+	}
+
+	PxRigidDynamic* rigidDynamic = m_recycledRigidDynamics.back();
+	m_recycledRigidDynamics.popBack();
+	rigidDynamic->setGlobalPose(pose);
+	rigidDynamic->setWakeCounter(m_spawnSettings.scene->getWakeCounterResetValue());
+	return rigidDynamic;
+}
+
+void ExtPxFamilyImpl::recycleRigidDynamic(PxRigidDynamic& rigidDynamic)
+{
+	// joints are only moved to the new actors after the split, and user shapes aren't ours to keep
+	if (!m_isRecyclingEnabled || rigidDynamic.getNbConstraints() > 0 || rigidDynamic.getNbShapes() > 0
+		|| m_recycledRigidDynamics.size() >= RECYCLED_RIGID_DYNAMICS_MAX_COUNT)
+	{
+		rigidDynamic.release();
+		return;
+	}
+
+	rigidDynamic.setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, false);
+	rigidDynamic.setLinearVelocity(PxVec3(PxZero));
+	rigidDynamic.setAngularVelocity(PxVec3(PxZero));
+	m_recycledRigidDynamics.pushBack(&rigidDynamic);
+}
+
+void ExtPxFamilyImpl::releaseRecycledShapes()
+{
+	for (PxShape*& shape : m_recycledShapes)
+	{
+		if (shape != nullptr)
+		{
+			shape->release();
+			shape = nullptr;
+		}
+	}
+}
+
+void ExtPxFamilyImpl::releaseRecycled()
+{
+	releaseRecycledShapes();
+	m_recycledShapes.reset();
+
+	for (PxRigidDynamic* rigidDynamic : m_recycledRigidDynamics)
+	{
+		rigidDynamic->release();
+	}
+	m_recycledRigidDynamics.reset();
+}
+
 void ExtPxFamilyImpl::dispatchActorCreated(ExtPxActor& actor)
 {
 	for (ExtPxListener* listener : m_listeners)
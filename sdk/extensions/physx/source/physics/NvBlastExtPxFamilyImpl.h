@@ -128,6 +128,13 @@ public:
 		return m_pxActorDescTemplate;
 	}
 
+	virtual void							setRecyclingEnabled(bool enabled) override;
+
+	virtual bool							isRecyclingEnabled() const override
+	{
+		return m_isRecyclingEnabled;
+	}
+
 	virtual const NvBlastExtMaterial*		getMaterial() const override
 	{
 		return m_material;
@@ -161,14 +168,24 @@ public:
 	void									dispatchActorDestroyed(ExtPxActor& actor);
 
 
+	//////// recycling ////////
+
+	PxRigidDynamic*							acquireRigidDynamic(const PxTransform& pose, bool& isRecycled);
+	void									recycleRigidDynamic(PxRigidDynamic& rigidDynamic);
+
+
 private:
 	//////// private methods ////////
 
 	void									createActors(TkActor** tkActors, const PxActorCreateInfo* pxActorInfos, uint32_t count);
 	void									destroyActors(ExtPxActor** actors, uint32_t count);
+	void									releaseRecycledShapes();
+	void									releaseRecycled();
 
 	//////// data ////////
 
+	static const uint32_t					RECYCLED_RIGID_DYNAMICS_MAX_COUNT = 32;
+
 	ExtPxManagerImpl&						m_manager;
 	TkFamily&								m_tkFamily;
 	ExtPxAsset&								m_pxAsset;
@@ -177,12 +194,15 @@ private:
 	const ExtPxActorDescTemplate*			m_pxActorDescTemplate;
 	const NvBlastExtMaterial*				m_material;
 	bool									m_isSpawned;
+	bool									m_isRecyclingEnabled;
 	PxTransform								m_initialTransform;
 	PxVec3									m_initialScale;
 	HashSet<ExtPxActor*>::type			    m_actors;
 	Array<TkActor*>::type				    m_culledActors;
 	InlineArray<ExtPxListener*, 4>::type	m_listeners;
 	Array<PxShape*>::type				    m_subchunkShapes;
+	Array<PxShape*>::type				    m_recycledShapes;
+	Array<PxRigidDynamic*>::type			m_recycledRigidDynamics;
 	Array<TkActor*>::type				    m_newActorsBuffer;
 	Array<PxActorCreateInfo>::type		    m_newActorCreateInfo;
 	Array<PxActor*>::type				    m_physXActorsBuffer;
@@ -54,7 +54,7 @@ using namespace physx;
 
 
 ExtPxStressSolverImpl::ExtPxStressSolverImpl(ExtPxFamily& family, ExtStressSolverSettings settings)
-	: m_family(family)
+	: m_family(family), m_solveSync(0), m_isUpdating(false), m_isSolving(false), m_doDamage(false), m_oneFrameLatency(false)
 {
 	NvBlastFamily* familyLL = const_cast<NvBlastFamily*>(family.getTkFamily().getFamilyLL());
 	NVBLAST_ASSERT(familyLL);
@@ -152,6 +152,7 @@ ExtPxStressSolverImpl::ExtPxStressSolverImpl(ExtPxFamily& family, ExtStressSolve
 
 ExtPxStressSolverImpl::~ExtPxStressSolverImpl()
 {
+	waitForSolve();
 	m_family.unsubscribe(*this);
 	m_solver->release();
 }
@@ -172,6 +173,80 @@ void ExtPxStressSolverImpl::release()
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void ExtPxStressSolverImpl::update(bool doDamage)
+{
+	NVBLAST_CHECK_WARNING(!m_isUpdating, "ExtPxStressSolver::update: called between beginUpdate() and endUpdate().", return);
+
+	finishUpdate();
+
+	applyForces();
+
+	m_solver->update();
+
+	if (doDamage)
+	{
+		applyDamage();
+	}
+}
+
+bool ExtPxStressSolverImpl::beginUpdate(PxTaskManager& taskManager)
+{
+	NVBLAST_CHECK_WARNING(!m_isUpdating, "ExtPxStressSolver::beginUpdate: previous update wasn't ended with endUpdate().", return false);
+
+	// one frame latency: the previous solve task's results are applied now
+	finishUpdate();
+
+	applyForces();
+
+	m_solver->prepareUpdate();
+
+	m_isUpdating = true;
+	m_isSolving = true;
+	m_doDamage = false;
+
+	m_solveSync.setCount(1);
+	m_solveTask.setup(m_solver, &m_solveSync);
+	m_solveTask.setContinuation(taskManager, nullptr);
+	m_solveTask.removeReference();
+
+	return true;
+}
+
+void ExtPxStressSolverImpl::endUpdate(bool doDamage)
+{
+	NVBLAST_CHECK_WARNING(m_isUpdating, "ExtPxStressSolver::endUpdate: no update started with beginUpdate().", return);
+
+	m_isUpdating = false;
+	m_doDamage = doDamage;
+
+	if (!m_oneFrameLatency)
+	{
+		finishUpdate();
+	}
+}
+
+void ExtPxStressSolverImpl::waitForSolve()
+{
+	if (m_isSolving)
+	{
+		m_solveSync.wait();
+	}
+}
+
+void ExtPxStressSolverImpl::finishUpdate()
+{
+	if (m_isSolving)
+	{
+		m_solveSync.wait();
+		m_isSolving = false;
+
+		if (m_doDamage)
+		{
+			applyDamage();
+		}
+	}
+}
+
+void ExtPxStressSolverImpl::applyForces()
 {
 	for (auto it = m_actors.getIterator(); !it.done(); ++it)
 	{
@@ -193,10 +268,11 @@ void ExtPxStressSolverImpl::update(bool doDamage)
 			m_solver->addAngularVelocity(*actor->getTkActor().getActorLL(), fromPxShared(localCenterMass), fromPxShared(localAngularVelocity));
 		}
 	}
+}
 
-	m_solver->update();
-
-	if (doDamage && m_solver->getOverstressedBondCount() > 0)
+void ExtPxStressSolverImpl::applyDamage()
+{
+	if (m_solver->getOverstressedBondCount() > 0)
 	{
 		NvBlastFractureBuffers commands;
 		m_solver->generateFractureCommands(commands);
@@ -214,6 +290,9 @@ void ExtPxStressSolverImpl::update(bool doDamage)
 
 void ExtPxStressSolverImpl::onActorCreated(ExtPxFamily& /*family*/, ExtPxActor& actor)
 {
+	// damage from outside of the stress solver, the solver can't be notified while solving
+	waitForSolve();
+
 	if (m_solver->notifyActorCreated(*actor.getTkActor().getActorLL()))
 	{
 		m_actors.insert(&actor);
@@ -222,6 +301,8 @@ void ExtPxStressSolverImpl::onActorCreated(ExtPxFamily& /*family*/, ExtPxActor&
 
 void ExtPxStressSolverImpl::onActorDestroyed(ExtPxFamily& /*family*/, ExtPxActor& actor)
 {
+	waitForSolve();
+
 	m_solver->notifyActorDestroyed(*actor.getTkActor().getActorLL());
 	m_actors.erase(&actor);
 }
@@ -31,6 +31,7 @@
 
 #include "NvBlastExtPxStressSolver.h"
 #include "NvBlastExtPxListener.h"
+#include "NvBlastExtPxTaskImpl.h"
 #include "NvBlastArray.h"
 #include "NvBlastHashSet.h"
 
@@ -59,6 +60,20 @@ public:
 
 	virtual void							update(bool doDamage) override;
 
+	virtual bool							beginUpdate(physx::PxTaskManager& taskManager) override;
+
+	virtual void							endUpdate(bool doDamage) override;
+
+	virtual void							setOneFrameLatency(bool enabled) override
+	{
+		m_oneFrameLatency = enabled;
+	}
+
+	virtual bool							getOneFrameLatency() const override
+	{
+		return m_oneFrameLatency;
+	}
+
 
 	//////// ExtPxListener interface ////////
 
@@ -70,12 +85,63 @@ public:
 private:
 	~ExtPxStressSolverImpl();
 
+	/**
+	Runs ExtStressSolver::solveUpdate().
+	*/
+	class SolveTask : public physx::PxLightCpuTask
+	{
+	public:
+		SolveTask() : PxLightCpuTask(), m_solver(nullptr), m_sync(nullptr) {}
+
+		void setup(ExtStressSolver* solver, ExtTaskSync* sync)
+		{
+			m_solver = solver;
+			m_sync = sync;
+		}
+
+		virtual void run() override
+		{
+			m_solver->solveUpdate();
+		}
+
+		virtual void release() override
+		{
+			PxLightCpuTask::release();
+
+			// release the sync last
+			m_sync->notify();
+		}
+
+		virtual const char* getName() const override { return "BlastStressSolveTask"; }
+
+	private:
+		ExtStressSolver*	m_solver;
+		ExtTaskSync*		m_sync;
+	};
+
+
+	//////// private methods ////////
+
+	void						applyForces();
+
+	void						applyDamage();
+
+	void						waitForSolve();
+
+	void						finishUpdate();
+
 
 	//////// data ////////
 
 	ExtPxFamily&				m_family;
 	ExtStressSolver*			m_solver;
 	HashSet<ExtPxActor*>::type  m_actors;
+	SolveTask					m_solveTask;
+	ExtTaskSync					m_solveSync;
+	bool						m_isUpdating;		//!< beginUpdate() called, endUpdate() not yet
+	bool						m_isSolving;		//!< solve task started, its results not yet applied
+	bool						m_doDamage;			//!< apply damage once the solve task ends
+	bool						m_oneFrameLatency;
 };
 
 
@@ -231,14 +231,23 @@ void ExtSyncImpl::applySyncBuffer(TkFramework& framework, const ExtSyncEvent** b
 					std::vector<ExtPxActor*> actors(pxFamily->getActorCount());
 					pxFamily->getActors(actors.data(), static_cast<uint32_t>(actors.size()));
 
+					// index actors by their TkActor index, so that every actor data entry is matched in constant time
+					std::vector<ExtPxActor*> actorsByIndex;
+					for (ExtPxActor* physicsActor : actors)
+					{
+						const uint32_t actorIndex = physicsActor->getTkActor().getIndex();
+						if (actorIndex >= actorsByIndex.size())
+						{
+							actorsByIndex.resize(actorIndex + 1, nullptr);
+						}
+						actorsByIndex[actorIndex] = physicsActor;
+					}
+
 					for (auto data : physicsEvent->data)
 					{
-						for (ExtPxActor* physicsaActor : actors)
+						if (data.actorIndex < actorsByIndex.size() && actorsByIndex[data.actorIndex] != nullptr)
 						{
-							if (data.actorIndex == physicsaActor->getTkActor().getIndex())
-							{
-								physicsaActor->getPhysXActor().setGlobalPose(data.transform);
-							}
+							actorsByIndex[data.actorIndex]->getPhysXActor().setGlobalPose(data.transform);
 						}
 					}
 				}
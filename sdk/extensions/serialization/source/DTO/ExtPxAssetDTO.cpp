@@ -110,6 +110,8 @@ Nv::Blast::ExtPxAsset* ExtPxAssetDTO::deserialize(Nv::Blast::Serialization::ExtP
 		ExtPxSubchunkDTO::deserializeInto(readerSubchunks[i], &subchunks[i]);
 	}
 
+	asset->updateChunkMassProperties();
+
 	NvBlastActorDesc& actorDesc = asset->getDefaultActorDesc();
 
 	actorDesc.uniformInitialBondHealth = reader.getUniformInitialBondHealth();
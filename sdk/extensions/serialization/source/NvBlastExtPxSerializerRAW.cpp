@@ -185,6 +185,8 @@ ExtPxAsset* deserializeExtPxAsset(ExtIStream& stream, TkFramework& framework, ph
 		}
 	}
 
+	asset->updateChunkMassProperties();
+
 	// checking if it's the end, so it will be binary compatible with asset before m_defaultActorDesc was added
 	if (!stream.eof())
 	{
@@ -0,0 +1,71 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#ifndef NVBLASTEXTDAMAGECOALESCER_H
+#define NVBLASTEXTDAMAGECOALESCER_H
+
+#include "NvBlastExtDamageShaders.h"
+#include "NvBlastTkGroup.h"
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+
+/**
+Damage coalescer for the shaders of this extension, see TkGroup::setDamageCoalescer and NvBlastExtDamageCombineParams.
+
+Merges the damage queued on a TkActor with the falloff, cutter, capsule falloff, cone falloff, box falloff or frustum falloff
+program into one pass stacking all the damage descriptions. With TkGroup::setMaxDamageCount, the combined damage is scaled
+down instead of dropped.
+
+Header only, for users of both the toolkit and this extension.
+*/
+class ExtDamageCoalescer : public TkDamageCoalescer
+{
+public:
+	virtual size_t getCombinedParamsSize(const NvBlastDamageProgram& program, const void* const* programParams, uint32_t paramsCount) const override
+	{
+		return NvBlastExtDamageGetCombinedParamsSize(&program, programParams, paramsCount);
+	}
+
+	virtual void combineParams(void* combinedParams, const NvBlastDamageProgram& program, const void* const* programParams, uint32_t paramsCount, float damageScale) const override
+	{
+		NvBlastExtDamageCombineParams(combinedParams, &program, programParams, paramsCount, damageScale);
+	}
+};
+
+
+} // namespace Blast
+} // namespace Nv
+
+
+#endif // NVBLASTEXTDAMAGECOALESCER_H
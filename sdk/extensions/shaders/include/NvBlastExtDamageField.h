@@ -0,0 +1,205 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#ifndef NVBLASTEXTDAMAGEFIELD_H
+#define NVBLASTEXTDAMAGEFIELD_H
+
+#include "NvBlastTypes.h"
+#include "NvBlastExtDamageShaders.h"
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+
+/**
+Damage field settings.
+
+fractureThreshold:
+A bond is fractured once its accumulated damage reaches fractureThreshold times its current health. With 1 damage is
+only applied when it breaks bonds, lower values also apply part of the damage to bonds that stay intact.
+
+flushInterval:
+Every flushInterval seconds of update() time, all the accumulated damage is applied whatever the threshold, so that
+damage below it eventually shows in bond healths (e.g. for the stress solver). 0 to never flush.
+*/
+struct ExtDamageFieldSettings
+{
+	float	fractureThreshold;	//!<	fraction of the bond's current health the accumulated damage must reach to be fractured, range: (0, 1]
+	float	flushInterval;		//!<	time in seconds between two applications of all the accumulated damage, 0 to never flush
+
+	ExtDamageFieldSettings() :
+		fractureThreshold(1.0f),
+		flushInterval(0.0f)
+	{}
+};
+
+
+/**
+Damage Field.
+
+Accumulates continuous damage (beams, fire, erosion) on the bonds of a family, in asset space, without running a damage
+shader and fracture pass per source and frame. Only the bonds which received damage are stored, and fracture commands
+are only generated for the bonds that reached the threshold or when the flush interval elapsed.
+Subsupport chunks are not damaged.
+
+Basic usage:
+1. Create it with create function once for family, optionally with the asset's damage accelerator to find bonds fast.
+2. Every frame: Deposit damage with the add functions, damage amounts being scaled by the frame time by the user.
+3. Every frame: Call update() with the frame time.
+4. If getPendingBondCount() > 0 use generateFractureCommands() functions to get FractureCommands and apply them.
+
+The accumulated damage of the bonds written to fracture commands is consumed, the commands are expected to be applied.
+*/
+class NV_DLL_EXPORT ExtDamageField
+{
+public:
+	//////// creation ////////
+
+	/**
+	Create a new ExtDamageField.
+
+	\param[in]	family			The family to accumulate damage on.
+	\param[in]	accelerator		The asset's damage accelerator used to find the bonds in damage volumes, NULL to test every bond.
+	\param[in]	settings		The settings to be set on ExtDamageField.
+
+	\return the new ExtDamageField if successful, NULL otherwise.
+	*/
+	static ExtDamageField*					create(NvBlastFamily& family, NvBlastExtDamageAccelerator* accelerator = nullptr, ExtDamageFieldSettings settings = ExtDamageFieldSettings());
+
+
+	//////// interface ////////
+
+	/**
+	Release this damage field.
+	*/
+	virtual void							release() = 0;
+
+	/**
+	Set damage field settings.
+
+	\param[in]	settings		The settings to be set on ExtDamageField.
+	*/
+	virtual void							setSettings(const ExtDamageFieldSettings& settings) = 0;
+
+	/**
+	Get damage field settings.
+
+	\return the pointer to settings currently set.
+	*/
+	virtual const ExtDamageFieldSettings&	getSettings() const = 0;
+
+	/**
+	Accumulate radial falloff damage, as NvBlastExtFalloffGraphShader would apply it to bond centroids.
+
+	\param[in]	desc			The damage to add, in asset space.
+	*/
+	virtual void							addRadialDamage(const NvBlastExtRadialDamageDesc& desc) = 0;
+
+	/**
+	Accumulate capsule falloff damage, as NvBlastExtCapsuleFalloffGraphShader would apply it to bond centroids.
+
+	\param[in]	desc			The damage to add, in asset space.
+	*/
+	virtual void							addCapsuleDamage(const NvBlastExtCapsuleRadialDamageDesc& desc) = 0;
+
+	/**
+	Accumulate damage on one bond.
+
+	\param[in]	bondIndex		The index of the bond in the asset.
+	\param[in]	damage			The damage to add.
+	*/
+	virtual void							addBondDamage(uint32_t bondIndex, float damage) = 0;
+
+	/**
+	Advance the flush interval clock, drop the damage accumulated on bonds broken since and find the bonds to fracture.
+
+	\param[in]	dt				The time elapsed since the last update, in seconds.
+	*/
+	virtual void							update(float dt) = 0;
+
+	/**
+	\return the number of bonds to fracture found by the last update().
+	*/
+	virtual uint32_t						getPendingBondCount() const = 0;
+
+	/**
+	\return the number of bonds with accumulated damage.
+	*/
+	virtual uint32_t						getAccumulatedBondCount() const = 0;
+
+	/**
+	Get the damage accumulated on a bond.
+
+	\param[in]	bondIndex		The index of the bond in the asset.
+
+	\return the accumulated damage, 0 if there is none.
+	*/
+	virtual float							getAccumulatedDamage(uint32_t bondIndex) const = 0;
+
+	/**
+	Generate fracture commands for whole family.
+
+	IMPORTANT: NvBlastFractureBuffers::bondFractures will point to internal damage field memory which will be valid till next call
+	of any of generateFractureCommands() functions or damage field release() call.
+
+	\param[in]	commands				Pointer to command buffer to fill.
+	*/
+	virtual void							generateFractureCommands(NvBlastFractureBuffers& commands) = 0;
+
+	/**
+	Generate fracture commands for every actor in family.
+
+	Actors and commands buffer must be passed in order to be filled. The pending bonds of the actors which don't fit
+	in the buffer are kept for the next call.
+
+	IMPORTANT: NvBlastFractureBuffers::bondFractures will point to internal damage field memory which will be valid till next call
+	of any of generateFractureCommands() functions or damage field release() call.
+
+	\param[out]	actorBuffer		A user-supplied array of NvBlastActor pointers to fill.
+	\param[out]	commandsBuffer	A user-supplied array of NvBlastFractureBuffers to fill.
+	\param[in]	bufferSize		The number of elements available to write into buffer.
+
+	\return the number of actors and command buffers written to the buffer.
+	*/
+	virtual uint32_t						generateFractureCommandsPerActor(const NvBlastActor** actorBuffer, NvBlastFractureBuffers* commandsBuffer, uint32_t bufferSize) = 0;
+
+	/**
+	Clear all the accumulated damage.
+	*/
+	virtual void							reset() = 0;
+};
+
+} // namespace Blast
+} // namespace Nv
+
+
+#endif // ifndef NVBLASTEXTDAMAGEFIELD_H
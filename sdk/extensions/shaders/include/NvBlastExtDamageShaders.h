@@ -50,6 +50,15 @@ public:
 	virtual Nv::Blast::DebugBuffer fillDebugRender(int depth = -1, bool segments = false) = 0;
 };
 
+/**
+Create a damage accelerator for the asset's bonds. One accelerator can be shared by all the families of the asset.
+
+\param[in]	asset	The asset to build the accelerator for.
+\param[in]	type	0: none, returns NULL. 1: binary AABB tree. 2: 4-wide BVH, tests 4 boxes at once with SIMD, faster on large assets.
+					Other values create a binary AABB tree.
+
+\return the new accelerator.
+*/
 NVBLAST_API NvBlastExtDamageAccelerator* NvBlastExtDamageAcceleratorCreate(const NvBlastAsset* asset, int type);
 
 
@@ -69,15 +78,19 @@ The idea of this 'hint' is that damage parameters are basically 2 entities: mate
 
 Also this damage program hints that there could be more than one damage event happening and processed per one shader call (for efficiency reasons).
 So different damage descriptions can be stacked and passed in one shader call (while material is kept the same obviously).
+The falloff, cutter, capsule falloff, cone falloff, box falloff and frustum falloff shaders, and the programs compiled by
+NvBlastExtDamageExpressionCompile(), sum the damage of all damageDescCount descriptions. The shear, triangle intersection,
+impact spread and pattern shaders only use the first one.
 */
 struct NvBlastExtProgramParams
 {
-	NvBlastExtProgramParams(const void*	desc, const void* material_ = nullptr, NvBlastExtDamageAccelerator* accelerator_ = nullptr)
-		: damageDesc(desc), material(material_), accelerator(accelerator_) {}
+	NvBlastExtProgramParams(const void*	desc, const void* material_ = nullptr, NvBlastExtDamageAccelerator* accelerator_ = nullptr, uint32_t descCount = 1)
+		: damageDesc(desc), material(material_), accelerator(accelerator_), damageDescCount(descCount) {}
 
 	const void*	damageDesc;			//!<	array of damage descriptions
 	const void*	material;			//!<	pointer to material
 	NvBlastExtDamageAccelerator*	accelerator;
+	uint32_t	damageDescCount;	//!<	number of damage descriptions in damageDesc
 };
 
 
@@ -175,6 +188,101 @@ NVBLAST_API void NvBlastExtCapsuleFalloffGraphShader(NvBlastFractureBuffers* com
 NVBLAST_API void NvBlastExtCapsuleFalloffSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params);
 
 
+///////////////////////////////////////////////////////////////////////////////
+//  Cone Damage
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+Cone Damage Desc
+*/
+struct NvBlastExtConeDamageDesc
+{
+	float	damage;			//!<	normalized damage amount, range: [0, 1] (maximum health value to be reduced)
+	float	position0[3];	//!<	cone apex position, origin of the blast
+	float	position1[3];	//!<	cone base center position, the blast reaches it
+	float	angle;			//!<	cone half angle, in radians, range: [0, PI/2), clamped to it
+	float	minRadius;		//!<	inner distance to the cone of damage action
+	float	maxRadius;		//!<	outer distance to the cone of damage action
+};
+
+/**
+Cone Falloff damage for both graph and subgraph shaders, for directional blasts.
+
+For every bond/chunk damage is calculated from the distance to the solid cone described in NvBlastExtConeDamageDesc.
+If distance is smaller then minRadius, full compressive amount of damage is applied. From minRadius to maxRadius it linearly falls off to zero.
+
+NOTE: The signature of shader functions are equal to NvBlastGraphShaderFunction and NvBlastSubgraphShaderFunction respectively.
+They are not expected to be called directly.
+@see NvBlastGraphShaderFunction, NvBlastSubgraphShaderFunction
+*/
+NVBLAST_API void NvBlastExtConeFalloffGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params);
+NVBLAST_API void NvBlastExtConeFalloffSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params);
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Box Damage
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+Oriented Box Damage Desc
+*/
+struct NvBlastExtBoxDamageDesc
+{
+	float	damage;			//!<	normalized damage amount, range: [0, 1] (maximum health value to be reduced)
+	float	position[3];	//!<	box center position
+	float	halfExtents[3];	//!<	box half extents
+	float	rotation[4];	//!<	box orientation quaternion (x, y, z, w)
+	float	minRadius;		//!<	inner distance to the box of damage action
+	float	maxRadius;		//!<	outer distance to the box of damage action
+};
+
+/**
+Oriented Box Falloff damage for both graph and subgraph shaders.
+
+For every bond/chunk damage is calculated from the distance to the box described in NvBlastExtBoxDamageDesc.
+If distance is smaller then minRadius, full compressive amount of damage is applied. From minRadius to maxRadius it linearly falls off to zero.
+
+NOTE: The signature of shader functions are equal to NvBlastGraphShaderFunction and NvBlastSubgraphShaderFunction respectively.
+They are not expected to be called directly.
+@see NvBlastGraphShaderFunction, NvBlastSubgraphShaderFunction
+*/
+NVBLAST_API void NvBlastExtBoxFalloffGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params);
+NVBLAST_API void NvBlastExtBoxFalloffSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params);
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Frustum Damage
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+Frustum Damage Desc
+
+The frustum is the intersection of the half spaces dot(normal, p) + d <= 0 of its planes, normals pointing out of it.
+Planes are in order: left, right, bottom, top, near, far (any convex hexahedron with that topology works).
+*/
+struct NvBlastExtFrustumDamageDesc
+{
+	float	damage;			//!<	normalized damage amount, range: [0, 1] (maximum health value to be reduced)
+	float	planes[6][4];	//!<	frustum planes (normal x, y, z, d), unit normals pointing outward
+	float	minRadius;		//!<	inner distance to the frustum planes of damage action
+	float	maxRadius;		//!<	outer distance to the frustum planes of damage action
+};
+
+/**
+Frustum Falloff damage for both graph and subgraph shaders.
+
+For every bond/chunk damage is calculated from the largest distance to the planes of the frustum described in
+NvBlastExtFrustumDamageDesc (0 inside). If distance is smaller then minRadius, full compressive amount of damage is
+applied. From minRadius to maxRadius it linearly falls off to zero.
+
+NOTE: The signature of shader functions are equal to NvBlastGraphShaderFunction and NvBlastSubgraphShaderFunction respectively.
+They are not expected to be called directly.
+@see NvBlastGraphShaderFunction, NvBlastSubgraphShaderFunction
+*/
+NVBLAST_API void NvBlastExtFrustumFalloffGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params);
+NVBLAST_API void NvBlastExtFrustumFalloffSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params);
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //  Shear Damage
 ///////////////////////////////////////////////////////////////////////////////
@@ -274,4 +382,194 @@ NVBLAST_API void NvBlastExtImpactSpreadGraphShader(NvBlastFractureBuffers* comma
 NVBLAST_API void NvBlastExtImpactSpreadSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params);
 
 
+///////////////////////////////////////////////////////////////////////////////
+//  Pattern Damage
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+Precomputed damage pattern: a set of triangles, typically the faces of the cells of a DamagePattern made by the
+authoring PatternGenerator (uniform, beam, radial or Voronoi), with a bounding volume hierarchy built once.
+One pattern is meant to be instanced by any number of NvBlastExtPatternDamageDesc, on any actor of any asset.
+*/
+class NvBlastExtDamagePattern
+{
+public:
+	virtual void release() = 0;
+};
+
+/**
+Create a damage pattern.
+
+\param[in]	vertices		The triangle vertices, in pattern space.
+\param[in]	indices			3 vertex indices per triangle.
+\param[in]	triangleCount	The number of triangles.
+
+\return the new pattern.
+*/
+NVBLAST_API NvBlastExtDamagePattern* NvBlastExtDamagePatternCreate(const NvcVec3* vertices, const uint32_t* indices, uint32_t triangleCount);
+
+/**
+Pattern Damage Desc
+*/
+struct NvBlastExtPatternDamageDesc
+{
+	float							damage;		//!<	normalized damage amount, range: [0, 1] (maximum health value to be reduced)
+	NvcTransform					pose;		//!<	pattern space to actor space transform
+	float							scale;		//!<	uniform scale of the pattern, applied before pose
+	const NvBlastExtDamagePattern*	pattern;	//!<	the pattern to apply
+};
+
+/**
+Pattern damage for both graph and subgraph shaders.
+
+Every bond is considered to be a segment connecting two chunk centroids, as in the triangle intersection shaders. Bonds
+which segment intersects any of the pattern's triangles get full damage. Segments are transformed into pattern space
+and tested against the pattern's hierarchy, so the cost grows with the number of bonds in the pattern bounds and
+the log of the pattern's triangle count. The damage accelerator, when passed, is used to find these bonds.
+
+NOTE: The signature of shader functions are equal to NvBlastGraphShaderFunction and NvBlastSubgraphShaderFunction respectively.
+They are not expected to be called directly.
+@see NvBlastGraphShaderFunction, NvBlastSubgraphShaderFunction
+*/
+NVBLAST_API void NvBlastExtPatternGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params);
+NVBLAST_API void NvBlastExtPatternSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params);
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Damage Expressions
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+Damage expression shape, the distance used by the profile is the distance to it (0 inside).
+*/
+struct NvBlastExtDamageShape
+{
+	enum Enum
+	{
+		SPHERE,		//!< point position0
+		CAPSULE,	//!< segment (position0, position1)
+		BOX,		//!< oriented box at position0 with halfExtents and rotation
+		CONE,		//!< solid cone with apex position0, base center position1 and half angle
+	};
+};
+
+/**
+Damage expression profile, the damage fraction applied as a function of the distance to the shape.
+*/
+struct NvBlastExtDamageProfile
+{
+	enum Enum
+	{
+		FALLOFF,	//!< full damage under minRadius, linear falloff to 0 at maxRadius
+		CUTTER,		//!< full damage between minRadius and maxRadius, 0 elsewhere
+		CURVE,		//!< curve sampled uniformly from minRadius to maxRadius, first sample under minRadius, 0 beyond maxRadius
+	};
+};
+
+#define NVBLASTEXT_DAMAGE_CURVE_MAX_SIZE 8
+
+/**
+Damage expression.
+
+Declares a damage type: a shape, a profile and filters. NvBlastExtDamageExpressionCompile() selects the damage program
+specialized for it, which runs the same code paths as the built-in radial shaders (accelerator, damage stacking), so
+new damage types need no shader code.
+
+It can be filled from text with NvBlastExtDamageExpressionParse(). The text is a list of whitespace separated
+key=value tokens, numbers being separated by commas. Omitted keys keep their default value. For example:
+
+	"shape=capsule profile=curve curve=1,1,0.5,0.1 normal=0,1,0,0.7 material=1"
+
+	shape=sphere|capsule|box|cone
+	profile=falloff|cutter|curve
+	curve=v0,v1,...				up to NVBLASTEXT_DAMAGE_CURVE_MAX_SIZE samples
+	normal=x,y,z,minDot			only damage bonds with |dot(bond normal, normal)| >= minDot
+	material=0|1				normalize damage with the NvBlastExtMaterial passed in NvBlastExtProgramParams
+*/
+struct NvBlastExtDamageExpression
+{
+	NvBlastExtDamageExpression() :
+		shape(NvBlastExtDamageShape::SPHERE), profile(NvBlastExtDamageProfile::FALLOFF), curveSize(0), minNormalDot(0.0f), useMaterial(false)
+	{
+		normal[0] = normal[1] = normal[2] = 0.0f;
+	}
+
+	NvBlastExtDamageShape::Enum		shape;
+	NvBlastExtDamageProfile::Enum	profile;
+	float							curve[NVBLASTEXT_DAMAGE_CURVE_MAX_SIZE];	//!<	CURVE profile samples
+	uint32_t						curveSize;		//!<	number of curve samples, at least 1 for the CURVE profile
+	float							normal[3];		//!<	normal filter direction, zero to disable the normal filter
+	float							minNormalDot;	//!<	normal filter threshold
+	bool							useMaterial;	//!<	material filter, see NvBlastExtMaterial::getNormalizedDamage()
+};
+
+/**
+Damage desc of the programs compiled from damage expressions. The fields a shape doesn't use are ignored.
+Stacked descs can use different expressions of the program's shape and profile, the filters of each desc's expression
+apply to its own damage. Descs with a NULL expression do no damage.
+*/
+struct NvBlastExtShapeDamageDesc
+{
+	float								damage;			//!<	damage amount, normalized by the material when the expression uses it
+	float								position0[3];	//!<	sphere center, capsule point A, box center or cone apex
+	float								position1[3];	//!<	capsule point B or cone base center
+	float								halfExtents[3];	//!<	box half extents
+	float								rotation[4];	//!<	box orientation quaternion (x, y, z, w)
+	float								angle;			//!<	cone half angle, in radians, range: [0, PI/2), clamped to it
+	float								minRadius;		//!<	inner distance to the shape of the profile
+	float								maxRadius;		//!<	outer distance to the shape of the profile
+	const NvBlastExtDamageExpression*	expression;		//!<	the expression the program was compiled from
+};
+
+/**
+Fill a damage expression from text, see NvBlastExtDamageExpression for the format.
+
+\param[out]	expression	The expression to fill, keys not in text keep their value.
+\param[in]	text		The expression text.
+
+\return true if the whole text was valid.
+*/
+NVBLAST_API bool NvBlastExtDamageExpressionParse(NvBlastExtDamageExpression* expression, const char* text);
+
+/**
+Select the damage program specialized for an expression, to be used with NvBlastExtShapeDamageDesc.
+
+\param[out]	program		The program to fill.
+\param[in]	expression	The expression to compile.
+
+\return true if the expression is valid.
+*/
+NVBLAST_API bool NvBlastExtDamageExpressionCompile(NvBlastDamageProgram* program, const NvBlastExtDamageExpression* expression);
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Damage Coalescing
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+The size of the NvBlastExtProgramParams combining the damage of several NvBlastExtProgramParams queued with the same program.
+
+Supported are the falloff, cutter, capsule falloff, cone falloff, box falloff and frustum falloff programs. The combined params
+stack the damage descriptions of all the params, which must share the same material and accelerator.
+
+\param[in]	program			The damage program the params were queued with.
+\param[in]	programParams	The NvBlastExtProgramParams to combine.
+\param[in]	paramsCount		The number of params to combine.
+
+\return the size in bytes of the combined params, 0 if the program is not supported or the params cannot be combined.
+*/
+NVBLAST_API size_t NvBlastExtDamageGetCombinedParamsSize(const NvBlastDamageProgram* program, const void* const* programParams, uint32_t paramsCount);
+
+/**
+Combine NvBlastExtProgramParams queued with the same program into a single NvBlastExtProgramParams with all their damage descriptions.
+
+\param[out]	combinedParams	Memory of NvBlastExtDamageGetCombinedParamsSize bytes, the combined NvBlastExtProgramParams is placed at its start.
+\param[in]	program			The damage program the params were queued with.
+\param[in]	programParams	The NvBlastExtProgramParams to combine.
+\param[in]	paramsCount		The number of params to combine.
+\param[in]	damageScale		Scale applied to the damage amount of every damage description.
+*/
+NVBLAST_API void NvBlastExtDamageCombineParams(void* combinedParams, const NvBlastDamageProgram* program, const void* const* programParams, uint32_t paramsCount, float damageScale);
+
+
 #endif // NVBLASTEXTDAMAGESHADERS_H
@@ -110,6 +110,9 @@ void ExtDamageAcceleratorAABBTree::build(const NvBlastAsset* asset)
 
 	int rootIndex = N > 0 ? createNode(0, N - 1, 0) : -1;
 	m_root = rootIndex >= 0 ? &m_nodes[rootIndex] : nullptr;
+
+	setBondBounds(m_root ? m_root->pointsBound : PxBounds3::empty(), N);
+	buildNodeTree(asset);
 }
 
 int ExtDamageAcceleratorAABBTree::createNode(uint32_t startIdx, uint32_t endIdx, uint32_t depth)
@@ -237,7 +240,7 @@ void ExtDamageAcceleratorAABBTree::findSegmentsInBounds(const Node& node, Result
 		for (uint32_t i = node.first; i <= node.last; i++)
 		{
 			const uint32_t idx = m_indices[i];
-			if (bounds.contains(m_segments[idx].p0) || bounds.contains(m_segments[idx].p1))
+			if (segmentOverlapsBounds(m_segments[idx].p0, m_segments[idx].p1, bounds))
 				pushResult(callback, idx);
 		}
 
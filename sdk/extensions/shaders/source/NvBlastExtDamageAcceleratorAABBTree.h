@@ -60,25 +60,18 @@ public:
 
 	virtual void findBondCentroidsInBounds(const physx::PxBounds3& bounds, ResultCallback& resultCallback) const override
 	{
-		const_cast<ExtDamageAcceleratorAABBTree*>(this)->findInBounds(bounds, resultCallback, false);
+		findInBounds(bounds, resultCallback, false);
 	}
 
 	virtual void findBondSegmentsInBounds(const physx::PxBounds3& bounds, ResultCallback& resultCallback) const override
 	{
-		const_cast<ExtDamageAcceleratorAABBTree*>(this)->findInBounds(bounds, resultCallback, true);
-
+		findInBounds(bounds, resultCallback, true);
 	}
 
 	virtual void findBondSegmentsPlaneIntersected(const physx::PxPlane& plane, ResultCallback& resultCallback) const override;
 
 	virtual Nv::Blast::DebugBuffer fillDebugRender(int depth, bool segments) override;
 
-	virtual void* getImmediateScratch(size_t size) override
-	{
-		m_scratch.resizeUninitialized(size);
-		return m_scratch.begin();
-	}
-
 
 private:
 	// no copy/assignment
@@ -139,8 +132,6 @@ private:
 	Array<BondData>::type		          m_bonds;
 
 	Array<Nv::Blast::DebugLine>::type     m_debugLineBuffer;
-
-	Array<char>::type					  m_scratch;
 };
 
 
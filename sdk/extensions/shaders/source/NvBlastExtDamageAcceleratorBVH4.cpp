@@ -0,0 +1,542 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+#include "NvBlastExtDamageAcceleratorBVH4.h"
+#include "NvBlastIndexFns.h"
+#include "NvBlastAssert.h"
+#include "NvBlastGlobals.h"
+#include "PxVec4.h"
+#include "PsVecMath.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace physx;
+using namespace physx::shdfnd::aos;
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Creation
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtDamageAcceleratorBVH4* ExtDamageAcceleratorBVH4::create(const NvBlastAsset* asset)
+{
+	ExtDamageAcceleratorBVH4* tree = NVBLAST_NEW(Nv::Blast::ExtDamageAcceleratorBVH4) ();
+	tree->build(asset);
+	return tree;
+}
+
+
+void ExtDamageAcceleratorBVH4::release()
+{
+	NVBLAST_DELETE(this, ExtDamageAcceleratorBVH4);
+}
+
+
+void ExtDamageAcceleratorBVH4::build(const NvBlastAsset* asset)
+{
+	NVBLAST_ASSERT(m_nodes.empty());
+
+	const NvBlastSupportGraph graph = NvBlastAssetGetSupportGraph(asset, logLL);
+	const NvBlastBond* bonds = NvBlastAssetGetBonds(asset, logLL);
+	const NvBlastChunk* chunks = NvBlastAssetGetChunks(asset, logLL);
+	const uint32_t N = NvBlastAssetGetBondCount(asset, logLL);
+
+	m_bonds.reserve(N);
+
+	for (uint32_t node0 = 0; node0 < graph.nodeCount; ++node0)
+	{
+		for (uint32_t j = graph.adjacencyPartition[node0]; j < graph.adjacencyPartition[node0 + 1]; ++j)
+		{
+			const uint32_t bondIndex = graph.adjacentBondIndices[j];
+			const uint32_t node1 = graph.adjacentNodeIndices[j];
+			if (node0 < node1)
+			{
+				const NvBlastBond& bond = bonds[bondIndex];
+				BondData data;
+				data.point = reinterpret_cast<const PxVec3&>(bond.centroid);
+				data.bond = bondIndex;
+				data.node0 = node0;
+				data.node1 = node1;
+
+				// filling bond segments as a connection of 2 chunk centroids, same as ExtDamageAcceleratorAABBTree
+				const uint32_t chunk0 = graph.chunkIndices[node0];
+				const uint32_t chunk1 = graph.chunkIndices[node1];
+				data.segment.p0 = reinterpret_cast<const PxVec3&>(chunks[chunk0].centroid);
+				if (isInvalidIndex(chunk1))
+				{
+					// for world node we don't have it's centroid, so approximate with projection on bond normal 
+					const PxVec3 normal = reinterpret_cast<const PxVec3&>(bond.normal);
+					data.segment.p1 = data.segment.p0 + normal * (data.point - data.segment.p0).dot(normal) * 2;
+				}
+				else
+				{
+					data.segment.p1 = reinterpret_cast<const PxVec3&>(chunks[chunk1].centroid);
+				}
+				m_bonds.pushBack(data);
+			}
+		}
+	}
+
+	PxBounds3 bounds = PxBounds3::empty();
+	for (const BondData& bond : m_bonds)
+	{
+		bounds.include(bond.point);
+	}
+	setBondBounds(bounds, m_bonds.size());
+	buildNodeTree(asset);
+
+	if (m_bonds.size() > 0)
+	{
+		m_nodes.reserve(m_bonds.size() / LEAF_SIZE + 1);
+		createNode(0, m_bonds.size(), 0);
+	}
+}
+
+uint32_t ExtDamageAcceleratorBVH4::createNode(uint32_t first, uint32_t count, uint32_t depth)
+{
+	const uint32_t nodeIndex = m_nodes.size();
+	m_nodes.pushBack(Node());
+
+	// split the largest range until there are 4 of them or all are small enough for leaves
+	Range ranges[4] = { { first, count } };
+	uint32_t rangeCount = 1;
+	while (rangeCount < 4)
+	{
+		uint32_t largest = 0;
+		for (uint32_t i = 1; i < rangeCount; ++i)
+		{
+			if (ranges[i].count > ranges[largest].count)
+			{
+				largest = i;
+			}
+		}
+		if (ranges[largest].count <= LEAF_SIZE)
+		{
+			break;
+		}
+
+		const uint32_t leftCount = split(ranges[largest].first, ranges[largest].count);
+		ranges[rangeCount].first = ranges[largest].first + leftCount;
+		ranges[rangeCount].count = ranges[largest].count - leftCount;
+		ranges[largest].count = leftCount;
+		rangeCount++;
+	}
+
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		if (i >= rangeCount)
+		{
+			// unused child, skipped by the traversals: empty bounds still overlap queries with infinite bounds
+			setChild(m_nodes[nodeIndex], i, invalidIndex<uint32_t>(), 0, 0);
+		}
+		else if (ranges[i].count <= LEAF_SIZE || depth + 1 >= MAX_DEPTH)
+		{
+			setChild(m_nodes[nodeIndex], i, ranges[i].first, ranges[i].first, ranges[i].count);
+			m_nodes[nodeIndex].count[i] = ranges[i].count;
+		}
+		else
+		{
+			const uint32_t child = createNode(ranges[i].first, ranges[i].count, depth + 1);
+			setChild(m_nodes[nodeIndex], i, child, ranges[i].first, ranges[i].count);
+		}
+	}
+
+	return nodeIndex;
+}
+
+void ExtDamageAcceleratorBVH4::setChild(Node& node, uint32_t i, uint32_t child, uint32_t first, uint32_t count) const
+{
+	PxBounds3 pointsBound = PxBounds3::empty();
+	PxBounds3 segmentsBound = PxBounds3::empty();
+	for (uint32_t j = first; j < first + count; ++j)
+	{
+		pointsBound.include(m_bonds[j].point);
+		segmentsBound.include(m_bonds[j].segment.p0);
+		segmentsBound.include(m_bonds[j].segment.p1);
+	}
+
+	for (uint32_t axis = 0; axis < 3; ++axis)
+	{
+		node.pointsMin[axis][i] = pointsBound.minimum[axis];
+		node.pointsMax[axis][i] = pointsBound.maximum[axis];
+		node.segmentsMin[axis][i] = segmentsBound.minimum[axis];
+		node.segmentsMax[axis][i] = segmentsBound.maximum[axis];
+	}
+	node.child[i] = child;
+	node.count[i] = 0;
+}
+
+static float surfaceArea(const PxBounds3& bounds)
+{
+	const PxVec3 d = bounds.getDimensions();
+	return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+uint32_t ExtDamageAcceleratorBVH4::split(uint32_t first, uint32_t count)
+{
+	BondData* bonds = m_bonds.begin() + first;
+
+	// bin on the axis of biggest centroid extent
+	PxBounds3 centroidBounds = PxBounds3::empty();
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		centroidBounds.include(bonds[i].point);
+	}
+	const PxVec3 extents = centroidBounds.getDimensions();
+	uint32_t axis = extents.y > extents.x ? 1 : 0;
+	if (extents.z > extents[axis])
+	{
+		axis = 2;
+	}
+
+	if (extents[axis] > 0.0f)
+	{
+		struct Bin
+		{
+			PxBounds3	bounds;
+			uint32_t	count;
+		};
+
+		const float binMin = centroidBounds.minimum[axis];
+		const float binScale = BIN_COUNT * 0.9999f / extents[axis];
+		auto binIndex = [&](const BondData& bond) { return static_cast<uint32_t>((bond.point[axis] - binMin) * binScale); };
+
+		Bin bins[BIN_COUNT];
+		for (Bin& bin : bins)
+		{
+			bin.bounds = PxBounds3::empty();
+			bin.count = 0;
+		}
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			Bin& bin = bins[binIndex(bonds[i])];
+			bin.bounds.include(bonds[i].segment.p0);
+			bin.bounds.include(bonds[i].segment.p1);
+			bin.count++;
+		}
+
+		// SAH cost of splitting between bins i - 1 and i
+		float rightArea[BIN_COUNT];
+		uint32_t rightCount[BIN_COUNT];
+		PxBounds3 bounds = PxBounds3::empty();
+		uint32_t binnedCount = 0;
+		for (uint32_t i = BIN_COUNT - 1; i > 0; --i)
+		{
+			bounds.include(bins[i].bounds);
+			binnedCount += bins[i].count;
+			rightArea[i] = surfaceArea(bounds);
+			rightCount[i] = binnedCount;
+		}
+
+		bounds = PxBounds3::empty();
+		binnedCount = 0;
+		float bestCost = FLT_MAX;
+		uint32_t bestBin = 0;
+		for (uint32_t i = 1; i < BIN_COUNT; ++i)
+		{
+			bounds.include(bins[i - 1].bounds);
+			binnedCount += bins[i - 1].count;
+			if (binnedCount == 0 || rightCount[i] == 0)
+			{
+				continue;
+			}
+			const float cost = surfaceArea(bounds) * binnedCount + rightArea[i] * rightCount[i];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestBin = i;
+			}
+		}
+
+		if (bestBin > 0)
+		{
+			const BondData* mid = std::partition(bonds, bonds + count, [&](const BondData& bond) { return binIndex(bond) < bestBin; });
+			return static_cast<uint32_t>(mid - bonds);
+		}
+	}
+
+	// centroids can't be told apart along the axis, split at the median
+	const uint32_t mid = count / 2;
+	std::nth_element(bonds, bonds + mid, bonds + count, [axis](const BondData& lhs, const BondData& rhs)
+	{
+		return lhs.point[axis] < rhs.point[axis];
+	});
+	return mid;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//														Queries
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExtDamageAcceleratorBVH4::findBondCentroidsInBounds(const physx::PxBounds3& bounds, ResultCallback& resultCallback) const
+{
+	findInBounds(bounds, resultCallback, false);
+}
+
+void ExtDamageAcceleratorBVH4::findBondSegmentsInBounds(const physx::PxBounds3& bounds, ResultCallback& resultCallback) const
+{
+	findInBounds(bounds, resultCallback, true);
+}
+
+void ExtDamageAcceleratorBVH4::findInBounds(const physx::PxBounds3& bounds, ResultCallback& callback, bool segments) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	const Vec4V queryMin[3] = { V4Load(bounds.minimum.x), V4Load(bounds.minimum.y), V4Load(bounds.minimum.z) };
+	const Vec4V queryMax[3] = { V4Load(bounds.maximum.x), V4Load(bounds.maximum.y), V4Load(bounds.maximum.z) };
+
+	uint32_t stack[STACK_SIZE];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		const float (*childMin)[4] = segments ? node.segmentsMin : node.pointsMin;
+		const float (*childMax)[4] = segments ? node.segmentsMax : node.pointsMax;
+
+		// test the 4 children at once
+		BoolV overlap = BTTTT();
+		BoolV inside = BTTTT();
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			const Vec4V min = V4LoadU(childMin[axis]);
+			const Vec4V max = V4LoadU(childMax[axis]);
+			overlap = BAnd(overlap, BAnd(V4IsGrtrOrEq(queryMax[axis], min), V4IsGrtrOrEq(max, queryMin[axis])));
+			inside = BAnd(inside, BAnd(V4IsGrtrOrEq(min, queryMin[axis]), V4IsGrtrOrEq(queryMax[axis], max)));
+		}
+		const uint32_t overlapMask = BGetBitMask(overlap);
+		const uint32_t insideMask = BGetBitMask(inside) & overlapMask;
+
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			if (!(overlapMask & (1 << i)) || isInvalidIndex(node.child[i]))
+			{
+				continue;
+			}
+
+			if (node.count[i] == 0)
+			{
+				if (stackSize == STACK_SIZE)
+				{
+					NVBLAST_LOG_ERROR("ExtDamageAcceleratorBVH4::findInBounds: traversal stack overflow, results are incomplete.");
+					continue;
+				}
+				stack[stackSize++] = node.child[i];
+				continue;
+			}
+
+			const BondData* bond = m_bonds.begin() + node.child[i];
+			const BondData* end = bond + node.count[i];
+			if (insideMask & (1 << i))
+			{
+				// leaf bounds inside the query, simply add all bonds
+				for (; bond < end; ++bond)
+				{
+					pushResult(callback, *bond);
+				}
+			}
+			else
+			{
+				for (; bond < end; ++bond)
+				{
+					if (segments ? segmentOverlapsBounds(bond->segment.p0, bond->segment.p1, bounds) : bounds.contains(bond->point))
+					{
+						pushResult(callback, *bond);
+					}
+				}
+			}
+		}
+	}
+
+	callback.dispatch();
+}
+
+static bool segmentIntersectsPlane(const PxVec3& v1, const PxVec3& v2, const PxPlane& p)
+{
+	const bool s1 = p.distance(v1) > 0.f;
+	const bool s2 = p.distance(v2) > 0.f;
+	return (s1 && !s2) || (s2 && !s1);
+}
+
+void ExtDamageAcceleratorBVH4::findBondSegmentsPlaneIntersected(const physx::PxPlane& plane, ResultCallback& resultCallback) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	const Vec4V normal[3] = { V4Load(plane.n.x), V4Load(plane.n.y), V4Load(plane.n.z) };
+	const Vec4V absNormal[3] = { V4Load(PxAbs(plane.n.x)), V4Load(PxAbs(plane.n.y)), V4Load(PxAbs(plane.n.z)) };
+	const Vec4V distance = V4Load(plane.d);
+	const Vec4V half = V4Load(0.5f);
+
+	uint32_t stack[STACK_SIZE];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+
+		// box intersects the plane if the center's distance is within the box's projected radius
+		Vec4V s = distance;
+		Vec4V r = V4Zero();
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			const Vec4V min = V4LoadU(node.segmentsMin[axis]);
+			const Vec4V max = V4LoadU(node.segmentsMax[axis]);
+			s = V4MulAdd(normal[axis], V4Mul(V4Add(min, max), half), s);
+			r = V4MulAdd(absNormal[axis], V4Mul(V4Sub(max, min), half), r);
+		}
+		const uint32_t hitMask = BGetBitMask(V4IsGrtrOrEq(r, V4Max(s, V4Neg(s))));
+
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			if (!(hitMask & (1 << i)) || isInvalidIndex(node.child[i]))
+			{
+				continue;
+			}
+
+			if (node.count[i] == 0)
+			{
+				if (stackSize == STACK_SIZE)
+				{
+					NVBLAST_LOG_ERROR("ExtDamageAcceleratorBVH4::findBondSegmentsPlaneIntersected: traversal stack overflow, results are incomplete.");
+					continue;
+				}
+				stack[stackSize++] = node.child[i];
+				continue;
+			}
+
+			const BondData* bond = m_bonds.begin() + node.child[i];
+			const BondData* end = bond + node.count[i];
+			for (; bond < end; ++bond)
+			{
+				if (segmentIntersectsPlane(bond->segment.p0, bond->segment.p1, plane))
+				{
+					pushResult(resultCallback, *bond);
+				}
+			}
+		}
+	}
+
+	resultCallback.dispatch();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Debug Render
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t PxVec4ToU32Color(const PxVec4& color)
+{
+	uint32_t c = 0;
+	c |= (int)(color.w * 255); c <<= 8;
+	c |= (int)(color.z * 255); c <<= 8;
+	c |= (int)(color.y * 255); c <<= 8;
+	c |= (int)(color.x * 255);
+	return c;
+}
+
+Nv::Blast::DebugBuffer ExtDamageAcceleratorBVH4::fillDebugRender(int depth, bool segments)
+{
+	Nv::Blast::DebugBuffer debugBuffer = { nullptr, 0 };
+
+	m_debugLineBuffer.clear();
+
+	if (!m_nodes.empty())
+	{
+		fillDebugBuffer(m_nodes[0], 0, depth, segments);
+	}
+
+	debugBuffer.lines = m_debugLineBuffer.begin();
+	debugBuffer.lineCount = m_debugLineBuffer.size();
+
+	return debugBuffer;
+}
+
+void ExtDamageAcceleratorBVH4::fillDebugBuffer(const Node& node, int currentDepth, int depth, bool segments)
+{
+	const PxVec4 LEAF_COLOR(1.0f, 1.0f, 1.0f, 1.0f);
+
+	for (uint32_t c = 0; c < 4; ++c)
+	{
+		const float (*childMin)[4] = segments ? node.segmentsMin : node.pointsMin;
+		const float (*childMax)[4] = segments ? node.segmentsMax : node.pointsMax;
+		const PxBounds3 bounds(PxVec3(childMin[0][c], childMin[1][c], childMin[2][c]), PxVec3(childMax[0][c], childMax[1][c], childMax[2][c]));
+		if (isInvalidIndex(node.child[c]) || bounds.isEmpty())
+		{
+			continue;
+		}
+
+		// draw child box
+		if (depth < 0 || currentDepth == depth)
+		{
+			const PxVec3 center = bounds.getCenter();
+			const PxVec3 extents = bounds.getExtents();
+
+			const int vs[] = { 0,3,5,6 };
+			for (int i = 0; i < 4; i++)
+			{
+				int v = vs[i];
+				for (int d = 1; d < 8; d <<= 1)
+				{
+					auto flip = [](int x, int k) { return ((x >> k) & 1) * 2.f - 1.f; };
+					const float s = std::pow(0.99f, currentDepth);
+					PxVec3 p0 = center + s * extents.multiply(PxVec3(flip(v, 0), flip(v, 1), flip(v, 2)));
+					PxVec3 p1 = center + s * extents.multiply(PxVec3(flip(v^d, 0), flip(v^d, 1), flip(v^d, 2)));
+					m_debugLineBuffer.pushBack(Nv::Blast::DebugLine(
+						reinterpret_cast<NvcVec3&>(p0), 
+						reinterpret_cast<NvcVec3&>(p1), 
+						PxVec4ToU32Color(LEAF_COLOR * (1.f - (currentDepth + 1) * 0.1f)))
+					);
+				}
+			}
+		}
+
+		if (node.count[c] == 0)
+		{
+			fillDebugBuffer(m_nodes[node.child[c]], currentDepth + 1, depth, segments);
+		}
+	}
+}
+
+
+} // namespace Blast
+} // namespace Nv
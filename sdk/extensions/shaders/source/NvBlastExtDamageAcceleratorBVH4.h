@@ -0,0 +1,150 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+#pragma once
+
+#include "NvBlastExtDamageAcceleratorInternal.h"
+#include "NvBlast.h"
+#include "NvBlastArray.h"
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+/**
+4-wide bounding volume hierarchy over the bond centroids and segments.
+
+Built with a binned SAH split, every node stores the bounds of its 4 children in SoA layout so that one query tests
+the 4 children at once with SIMD. Traversal is iterative, with a fixed size stack on the query's call stack.
+Bonds are stored in leaf order to keep leaf tests in cache.
+*/
+class ExtDamageAcceleratorBVH4 final : public ExtDamageAcceleratorInternal
+{
+public:
+	//////// ctor ////////
+
+	ExtDamageAcceleratorBVH4()
+	{
+	}
+
+	virtual ~ExtDamageAcceleratorBVH4()
+	{
+	}
+
+	static ExtDamageAcceleratorBVH4* create(const NvBlastAsset* asset);
+
+
+	//////// interface ////////
+
+	virtual void release() override;
+
+	virtual void findBondCentroidsInBounds(const physx::PxBounds3& bounds, ResultCallback& resultCallback) const override;
+
+	virtual void findBondSegmentsInBounds(const physx::PxBounds3& bounds, ResultCallback& resultCallback) const override;
+
+	virtual void findBondSegmentsPlaneIntersected(const physx::PxPlane& plane, ResultCallback& resultCallback) const override;
+
+	virtual Nv::Blast::DebugBuffer fillDebugRender(int depth, bool segments) override;
+
+
+private:
+	// no copy/assignment
+	ExtDamageAcceleratorBVH4(ExtDamageAcceleratorBVH4&);
+	ExtDamageAcceleratorBVH4& operator=(const ExtDamageAcceleratorBVH4& tree);
+
+	enum
+	{
+		LEAF_SIZE = 8,		//!< max bonds per leaf
+		BIN_COUNT = 16,		//!< SAH bins per split
+		MAX_DEPTH = 32,		//!< build stops splitting below, bounds the traversal stack
+		STACK_SIZE = 3 * MAX_DEPTH + 4
+	};
+
+	// 4-wide node, child bounds in SoA layout. Unused children have empty bounds.
+	struct Node
+	{
+		float		pointsMin[3][4];
+		float		pointsMax[3][4];
+		float		segmentsMin[3][4];
+		float		segmentsMax[3][4];
+		uint32_t	child[4];		//!< node index for inner children, first bond in m_bonds for leaves, invalid index for unused children
+		uint32_t	count[4];		//!< bond count for leaves, 0 for inner or unused children
+	};
+
+	struct Segment
+	{
+		physx::PxVec3	p0;
+		physx::PxVec3	p1;
+	};
+
+	struct BondData
+	{
+		physx::PxVec3	point;
+		Segment			segment;
+		uint32_t		bond;
+		uint32_t		node0;
+		uint32_t		node1;
+	};
+
+	struct Range
+	{
+		uint32_t		first;
+		uint32_t		count;
+	};
+
+
+	void build(const NvBlastAsset* asset);
+
+	uint32_t createNode(uint32_t first, uint32_t count, uint32_t depth);
+
+	uint32_t split(uint32_t first, uint32_t count);
+
+	void setChild(Node& node, uint32_t i, uint32_t child, uint32_t first, uint32_t count) const;
+
+	void pushResult(ResultCallback& callback, const BondData& bond) const
+	{
+		callback.push(bond.bond, bond.node0, bond.node1);
+	}
+
+	void findInBounds(const physx::PxBounds3& bounds, ResultCallback& callback, bool segments) const;
+
+	void fillDebugBuffer(const Node& node, int currentDepth, int depth, bool segments);
+
+
+	//////// data ////////
+
+	Array<Node>::type						m_nodes;	//!< root is m_nodes[0]
+	Array<BondData>::type					m_bonds;	//!< in leaf order
+	Array<Nv::Blast::DebugLine>::type		m_debugLineBuffer;
+};
+
+
+} // namespace Blast
+} // namespace Nv
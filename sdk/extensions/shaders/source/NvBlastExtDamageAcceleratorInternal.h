@@ -28,8 +28,13 @@
 #pragma once
 
 #include "NvBlastExtDamageShaders.h"
+#include "NvBlastGlobals.h"
+#include "NvBlastArray.h"
+#include "NvBlastExtDamageNodeTree.h"
 #include "PxBounds3.h"
 
+#include <mutex>
+
 
 namespace Nv
 {
@@ -51,12 +56,31 @@ public:
 	{
 	public:
 		ResultCallback(QueryBondData* buffer, uint32_t count) :
-			m_bondBuffer(buffer), m_bondMaxCount(count), m_bondCount(0) {}
+			m_bondBuffer(buffer), m_bondMaxCount(count), m_bondCount(0), m_nodeActorIndices(nullptr), m_actorIndex(0) {}
 
 		virtual void processResults(const QueryBondData* bondBuffer, uint32_t count) = 0;
 
+		/**
+		Only report the bonds of one actor. Tested as bonds are pushed: the query's traversal still visits the subtrees and
+		leaves of other actors (the accelerator is shared by all families of the asset, so it can't know actors), the filter
+		only keeps their bonds out of the buffer and processResults().
+
+		\param[in]	nodeActorIndices	The family's map from node index to actor index, kept up to date by splits.
+		\param[in]	actorIndex			The actor's index.
+		*/
+		void setActorFilter(const uint32_t* nodeActorIndices, uint32_t actorIndex)
+		{
+			m_nodeActorIndices = nodeActorIndices;
+			m_actorIndex = actorIndex;
+		}
+
 		void push(uint32_t bond, uint32_t node0, uint32_t node1)
 		{
+			if (m_nodeActorIndices != nullptr && m_nodeActorIndices[node0] != m_actorIndex)
+			{
+				return;
+			}
+
 			m_bondBuffer[m_bondCount].bond = bond;
 			m_bondBuffer[m_bondCount].node0 = node0;
 			m_bondBuffer[m_bondCount].node1 = node1;
@@ -81,14 +105,181 @@ public:
 		uint32_t	   m_bondMaxCount;
 
 		uint32_t	   m_bondCount;
+
+		const uint32_t* m_nodeActorIndices;
+		uint32_t		m_actorIndex;
+	};
+
+	typedef Array<char>::type ScratchBuffer;
+
+	/**
+	Scratch memory for a shader call, taken from the accelerator's pool and given back when going out of scope.
+	Thread safe: concurrent shader calls (e.g. damaging different families of the same asset) each get their own memory.
+	*/
+	class ScopedScratch
+	{
+	public:
+		ScopedScratch(ExtDamageAcceleratorInternal& accelerator, size_t size) : m_accelerator(accelerator)
+		{
+			m_buffer = accelerator.acquireScratch();
+			m_buffer->resizeUninitialized(static_cast<uint32_t>(size));
+		}
+
+		~ScopedScratch()
+		{
+			m_accelerator.releaseScratch(m_buffer);
+		}
+
+		void* get()
+		{
+			return m_buffer->begin();
+		}
+
+	private:
+		ScopedScratch(const ScopedScratch&);
+		ScopedScratch& operator=(const ScopedScratch&);
+
+		ExtDamageAcceleratorInternal&	m_accelerator;
+		ScratchBuffer*					m_buffer;
 	};
 
+	ExtDamageAcceleratorInternal() : m_bondBounds(physx::PxBounds3::empty()), m_bondCount(0) {}
+
+	virtual ~ExtDamageAcceleratorInternal()
+	{
+		for (ScratchBuffer* buffer : m_scratchPool)
+		{
+			NVBLAST_DELETE(buffer, ScratchBuffer);
+		}
+	}
+
+	// Queries are const and thread safe. Segments are the chunk centroid to chunk centroid bond segments, found by
+	// bounds queries when any part of them is inside the bounds.
 	virtual void findBondCentroidsInBounds(const physx::PxBounds3& bounds, ResultCallback& resultCallback) const = 0;
 	virtual void findBondSegmentsInBounds(const physx::PxBounds3& bounds, ResultCallback& resultCallback) const = 0;
 	virtual void findBondSegmentsPlaneIntersected(const physx::PxPlane& plane, ResultCallback& resultCallback) const = 0;
 
-	// Non-thread safe! Multiple calls return the same memory.
-	virtual void* getImmediateScratch(size_t size) = 0;
+	/**
+	Find the healthy node of an actor with the chunk centroid closest to point.
+
+	\return		the node index, or invalid index if the actor has no healthy node with a chunk.
+	*/
+	uint32_t findClosestNode(const physx::PxVec3& point, const NvBlastGraphShaderActor* actor) const
+	{
+		return m_nodeTree.findClosestNode(point, actor);
+	}
+
+	/**
+	Estimated number of bonds found by a bounds query, of all actors, assuming bonds are spread evenly in the asset bounds.
+	*/
+	float estimateBondCountInBounds(const physx::PxBounds3& bounds) const
+	{
+		float ratio = 1.0f;
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			const float size = m_bondBounds.maximum[axis] - m_bondBounds.minimum[axis];
+			const float overlap = physx::PxMin(bounds.maximum[axis], m_bondBounds.maximum[axis]) - physx::PxMax(bounds.minimum[axis], m_bondBounds.minimum[axis]);
+			if (overlap < 0.0f)
+			{
+				return 0.0f;
+			}
+			if (size > 0.0f)
+			{
+				ratio *= physx::PxMin(overlap / size, 1.0f);
+			}
+		}
+		return ratio * m_bondCount;
+	}
+
+	/**
+	Estimated number of bonds found by a plane query: a slice through the bonds.
+	*/
+	float estimateBondCountOnPlane() const
+	{
+		return physx::PxPow(static_cast<float>(m_bondCount), 2.0f / 3.0f);
+	}
+
+protected:
+	/**
+	To be called by the implementations once built, for the estimates.
+	*/
+	void setBondBounds(const physx::PxBounds3& bounds, uint32_t bondCount)
+	{
+		m_bondBounds = bounds;
+		m_bondCount = bondCount;
+	}
+
+	/**
+	To be called by the implementations on build, for the closest node query.
+	*/
+	void buildNodeTree(const NvBlastAsset* asset)
+	{
+		m_nodeTree.build(asset);
+	}
+
+	/**
+	Segment to box overlap, slab test on the part of the segment between the bounds planes of each axis.
+	*/
+	static bool segmentOverlapsBounds(const physx::PxVec3& p0, const physx::PxVec3& p1, const physx::PxBounds3& bounds)
+	{
+		if (bounds.contains(p0) || bounds.contains(p1))
+		{
+			return true;
+		}
+
+		const physx::PxVec3 dir = p1 - p0;
+		float tMin = 0.0f;
+		float tMax = 1.0f;
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			if (dir[axis] == 0.0f)
+			{
+				if (p0[axis] < bounds.minimum[axis] || p0[axis] > bounds.maximum[axis])
+				{
+					return false;
+				}
+				continue;
+			}
+
+			const float invDir = 1.0f / dir[axis];
+			const float t0 = (bounds.minimum[axis] - p0[axis]) * invDir;
+			const float t1 = (bounds.maximum[axis] - p0[axis]) * invDir;
+			tMin = physx::PxMax(tMin, physx::PxMin(t0, t1));
+			tMax = physx::PxMin(tMax, physx::PxMax(t0, t1));
+			if (tMin > tMax)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	ScratchBuffer* acquireScratch()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_scratchMutex);
+			if (m_scratchPool.size() > 0)
+			{
+				ScratchBuffer* buffer = m_scratchPool.back();
+				m_scratchPool.popBack();
+				return buffer;
+			}
+		}
+		return NVBLAST_NEW(ScratchBuffer);
+	}
+
+	void releaseScratch(ScratchBuffer* buffer)
+	{
+		std::lock_guard<std::mutex> lock(m_scratchMutex);
+		m_scratchPool.pushBack(buffer);
+	}
+
+	physx::PxBounds3					m_bondBounds;	//!< bounds of all bond centroids
+	uint32_t							m_bondCount;
+	ExtDamageNodeTree					m_nodeTree;		//!< support chunk centroids, for the closest node query
+	std::mutex							m_scratchMutex;
+	Array<ScratchBuffer*>::type			m_scratchPool;	//!< free scratch buffers, one per shader call that ran concurrently
 };
 
 
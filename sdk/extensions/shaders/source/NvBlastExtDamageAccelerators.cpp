@@ -29,6 +29,7 @@
 //#include "NvBlastExtDamageAcceleratorOctree.h"
 //#include "NvBlastExtDamageAcceleratorKdtree.h"
 #include "NvBlastExtDamageAcceleratorAABBTree.h"
+#include "NvBlastExtDamageAcceleratorBVH4.h"
 
 NvBlastExtDamageAccelerator* NvBlastExtDamageAcceleratorCreate(const NvBlastAsset* asset, int type)
 {
@@ -36,6 +37,8 @@ NvBlastExtDamageAccelerator* NvBlastExtDamageAcceleratorCreate(const NvBlastAsse
 	{
 		case 0:
 			return nullptr;
+		case 2:
+			return Nv::Blast::ExtDamageAcceleratorBVH4::create(asset);
 		default:
 			return Nv::Blast::ExtDamageAcceleratorAABBTree::create(asset);
 			break;
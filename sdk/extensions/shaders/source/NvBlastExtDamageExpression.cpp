@@ -0,0 +1,157 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#include "NvBlastExtDamageShaders.h"
+#include "NvBlastGlobals.h"
+#include <cstdlib>
+#include <cstring>
+
+
+/**
+Parse up to maxCount comma separated floats from [begin, end), returns the count parsed or -1 on error (empty value
+or trailing comma included).
+*/
+static int parseFloats(const char* begin, const char* end, float* values, uint32_t maxCount)
+{
+	uint32_t count = 0;
+	const char* c = begin;
+	while (c < end)
+	{
+		if (count == maxCount)
+		{
+			return -1;
+		}
+		char* next;
+		values[count++] = strtof(c, &next);
+		if (next == c || next > end || (next < end && (*next != ',' || next + 1 == end)))
+		{
+			return -1;
+		}
+		c = next + 1;
+	}
+	return static_cast<int>(count);
+}
+
+static bool matchValue(const char* value, size_t valueLength, const char* name)
+{
+	return valueLength == strlen(name) && strncmp(value, name, valueLength) == 0;
+}
+
+static bool parseToken(NvBlastExtDamageExpression& expression, const char* key, size_t keyLength, const char* value, const char* end)
+{
+	const size_t valueLength = end - value;
+
+	if (matchValue(key, keyLength, "shape"))
+	{
+		if (matchValue(value, valueLength, "sphere"))		expression.shape = NvBlastExtDamageShape::SPHERE;
+		else if (matchValue(value, valueLength, "capsule"))	expression.shape = NvBlastExtDamageShape::CAPSULE;
+		else if (matchValue(value, valueLength, "box"))		expression.shape = NvBlastExtDamageShape::BOX;
+		else if (matchValue(value, valueLength, "cone"))	expression.shape = NvBlastExtDamageShape::CONE;
+		else return false;
+		return true;
+	}
+
+	if (matchValue(key, keyLength, "profile"))
+	{
+		if (matchValue(value, valueLength, "falloff"))		expression.profile = NvBlastExtDamageProfile::FALLOFF;
+		else if (matchValue(value, valueLength, "cutter"))	expression.profile = NvBlastExtDamageProfile::CUTTER;
+		else if (matchValue(value, valueLength, "curve"))	expression.profile = NvBlastExtDamageProfile::CURVE;
+		else return false;
+		return true;
+	}
+
+	if (matchValue(key, keyLength, "curve"))
+	{
+		float values[NVBLASTEXT_DAMAGE_CURVE_MAX_SIZE];
+		const int count = parseFloats(value, end, values, NVBLASTEXT_DAMAGE_CURVE_MAX_SIZE);
+		if (count <= 0)
+		{
+			return false;
+		}
+		memcpy(expression.curve, values, count * sizeof(float));
+		expression.curveSize = static_cast<uint32_t>(count);
+		return true;
+	}
+
+	if (matchValue(key, keyLength, "normal"))
+	{
+		float values[4];
+		if (parseFloats(value, end, values, 4) != 4)
+		{
+			return false;
+		}
+		expression.normal[0] = values[0];
+		expression.normal[1] = values[1];
+		expression.normal[2] = values[2];
+		expression.minNormalDot = values[3];
+		return true;
+	}
+
+	if (matchValue(key, keyLength, "material"))
+	{
+		if (matchValue(value, valueLength, "0"))		expression.useMaterial = false;
+		else if (matchValue(value, valueLength, "1"))	expression.useMaterial = true;
+		else return false;
+		return true;
+	}
+
+	return false;
+}
+
+bool NvBlastExtDamageExpressionParse(NvBlastExtDamageExpression* expression, const char* text)
+{
+	NVBLAST_CHECK_ERROR(expression != nullptr, "NvBlastExtDamageExpressionParse: NULL expression pointer input.", return false);
+	NVBLAST_CHECK_ERROR(text != nullptr, "NvBlastExtDamageExpressionParse: NULL text pointer input.", return false);
+
+	bool success = true;
+	const char* c = text;
+	while (*c != '\0')
+	{
+		if (*c == ' ' || *c == '\t' || *c == '\n' || *c == '\r')
+		{
+			c++;
+			continue;
+		}
+
+		const char* token = c;
+		while (*c != '\0' && *c != ' ' && *c != '\t' && *c != '\n' && *c != '\r')
+		{
+			c++;
+		}
+
+		const char* separator = static_cast<const char*>(memchr(token, '=', c - token));
+		if (separator == nullptr || !parseToken(*expression, token, separator - token, separator + 1, c))
+		{
+			NVBLAST_LOG_ERROR("NvBlastExtDamageExpressionParse: invalid token.");
+			success = false;
+		}
+	}
+
+	return success;
+}
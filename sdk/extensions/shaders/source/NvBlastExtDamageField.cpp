@@ -0,0 +1,503 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#include "NvBlastExtDamageField.h"
+#include "NvBlastExtDamageAcceleratorInternal.h"
+#include "NvBlast.h"
+#include "NvBlastGlobals.h"
+#include "NvBlastArray.h"
+#include "NvBlastAssert.h"
+#include "NvBlastIndexFns.h"
+#include "NvBlastMath.h"
+#include "PxBounds3.h"
+
+#include <algorithm>
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+using namespace physx;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Damage Functions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static float falloff(float minRadius, float maxRadius, float distance, float damage)
+{
+	if (distance > maxRadius) return 0.0f;
+	if (distance < minRadius) return damage;
+
+	return (1.0f - (distance - minRadius) / (maxRadius - minRadius)) * damage;
+}
+
+static float radialDamage(const float pos[3], const NvBlastExtRadialDamageDesc& desc)
+{
+	return falloff(desc.minRadius, desc.maxRadius, VecMath::dist(pos, desc.position), desc.damage);
+}
+
+static float capsuleDamage(const float pos[3], const NvBlastExtCapsuleRadialDamageDesc& desc)
+{
+	// distance from pos to segment (position0, position1)
+	float v[3]; VecMath::sub(desc.position1, desc.position0, v);
+	float w[3]; VecMath::sub(pos, desc.position0, w);
+	const float c1 = VecMath::dot(v, w);
+	const float c2 = VecMath::dot(v, v);
+	float distance;
+	if (c1 <= 0.0f)
+	{
+		distance = VecMath::length(w);
+	}
+	else if (c2 <= c1)
+	{
+		distance = VecMath::dist(pos, desc.position1);
+	}
+	else
+	{
+		VecMath::mul(v, c1 / c2);
+		distance = VecMath::dist(v, w);
+	}
+	return falloff(desc.minRadius, desc.maxRadius, distance, desc.damage);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//												ExtDamageFieldImpl Definition
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ExtDamageFieldImpl final : public ExtDamageField
+{
+	NV_NOCOPY(ExtDamageFieldImpl)
+
+public:
+	ExtDamageFieldImpl(NvBlastFamily& family, NvBlastExtDamageAccelerator* accelerator, ExtDamageFieldSettings settings);
+
+
+	//////// ExtDamageField interface ////////
+
+	virtual void							release() override;
+
+	virtual void							setSettings(const ExtDamageFieldSettings& settings) override
+	{
+		m_settings = settings;
+	}
+
+	virtual const ExtDamageFieldSettings&	getSettings() const override
+	{
+		return m_settings;
+	}
+
+	virtual void							addRadialDamage(const NvBlastExtRadialDamageDesc& desc) override;
+	virtual void							addCapsuleDamage(const NvBlastExtCapsuleRadialDamageDesc& desc) override;
+	virtual void							addBondDamage(uint32_t bondIndex, float damage) override;
+
+	virtual void							update(float dt) override;
+
+	virtual uint32_t						getPendingBondCount() const override
+	{
+		return m_pendingBonds.size();
+	}
+
+	virtual uint32_t						getAccumulatedBondCount() const override
+	{
+		return m_entries.size();
+	}
+
+	virtual float							getAccumulatedDamage(uint32_t bondIndex) const override;
+
+	virtual void							generateFractureCommands(NvBlastFractureBuffers& commands) override;
+	virtual uint32_t						generateFractureCommandsPerActor(const NvBlastActor** actorBuffer, NvBlastFractureBuffers* commandsBuffer, uint32_t bufferSize) override;
+
+	virtual void							reset() override;
+
+
+private:
+	~ExtDamageFieldImpl() {}
+
+
+	//////// private methods ////////
+
+	template<typename DescT, float(*damageFn)(const float[3], const DescT&)>
+	void									addDamage(const DescT& desc, const PxBounds3& bounds);
+
+	void									accumulate(uint32_t bondIndex, float damage);
+
+	void									removeEntry(uint32_t entryIndex);
+
+	bool									consumeBondFractureData(uint32_t bondIndex, NvBlastBondFractureData& data);
+
+	const NvBlastActor*						getBondActor(uint32_t bondIndex) const;
+
+
+	//////// data ////////
+
+	struct BondNodes
+	{
+		uint32_t	node0;
+		uint32_t	node1;
+	};
+
+	struct Entry
+	{
+		uint32_t	bondIndex;
+		float		damage;
+	};
+
+	struct ActorBond
+	{
+		const NvBlastActor*	actor;
+		uint32_t			bondIndex;
+
+		bool operator<(const ActorBond& other) const
+		{
+			return actor < other.actor;
+		}
+	};
+
+	NvBlastFamily&							m_family;
+	ExtDamageAcceleratorInternal*			m_accelerator;
+	ExtDamageFieldSettings					m_settings;
+	NvBlastSupportGraph						m_graph;
+	const NvBlastBond*						m_bonds;
+	const float*							m_bondHealths;
+	Array<BondNodes>::type					m_bondNodes;		//!< support graph nodes of every bond
+	Array<uint32_t>::type					m_bondEntries;		//!< index in m_entries of every bond, invalid index if it has no damage
+	Array<Entry>::type						m_entries;			//!< the bonds with accumulated damage
+	Array<uint32_t>::type					m_pendingBonds;		//!< the bonds to fracture found by update()
+	Array<ActorBond>::type					m_actorBonds;
+	Array<NvBlastBondFractureData>::type	m_bondFractureBuffer;
+	float									m_flushTime;		//!< time since the last flush
+	bool									m_isFlushPending;	//!< flush interval elapsed, all accumulated damage is pending
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Creation
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtDamageFieldImpl::ExtDamageFieldImpl(NvBlastFamily& family, NvBlastExtDamageAccelerator* accelerator, ExtDamageFieldSettings settings)
+	: m_family(family), m_accelerator(static_cast<ExtDamageAcceleratorInternal*>(accelerator)), m_settings(settings), m_flushTime(0.0f), m_isFlushPending(false)
+{
+	const NvBlastAsset* asset = NvBlastFamilyGetAsset(&m_family, logLL);
+	NVBLAST_ASSERT(asset);
+
+	m_graph = NvBlastAssetGetSupportGraph(asset, logLL);
+	m_bonds = NvBlastAssetGetBonds(asset, logLL);
+	const uint32_t bondCount = NvBlastAssetGetBondCount(asset, logLL);
+
+	{
+		NvBlastActor* actor;
+		NvBlastFamilyGetActors(&actor, 1, &family, logLL);
+		m_bondHealths = NvBlastActorGetBondHealths(actor, logLL);
+	}
+
+	m_bondNodes.resizeUninitialized(bondCount);
+	for (uint32_t node0 = 0; node0 < m_graph.nodeCount; ++node0)
+	{
+		for (uint32_t adjacencyIndex = m_graph.adjacencyPartition[node0]; adjacencyIndex < m_graph.adjacencyPartition[node0 + 1]; adjacencyIndex++)
+		{
+			const uint32_t node1 = m_graph.adjacentNodeIndices[adjacencyIndex];
+			if (node0 < node1)
+			{
+				BondNodes& nodes = m_bondNodes[m_graph.adjacentBondIndices[adjacencyIndex]];
+				nodes.node0 = node0;
+				nodes.node1 = node1;
+			}
+		}
+	}
+
+	m_bondEntries.resize(bondCount, invalidIndex<uint32_t>());
+}
+
+ExtDamageField* ExtDamageField::create(NvBlastFamily& family, NvBlastExtDamageAccelerator* accelerator, ExtDamageFieldSettings settings)
+{
+	return NVBLAST_NEW(ExtDamageFieldImpl) (family, accelerator, settings);
+}
+
+void ExtDamageFieldImpl::release()
+{
+	NVBLAST_DELETE(this, ExtDamageFieldImpl);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Accumulation
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExtDamageFieldImpl::addRadialDamage(const NvBlastExtRadialDamageDesc& desc)
+{
+	const PxVec3& position = reinterpret_cast<const PxVec3&>(desc.position);
+	addDamage<NvBlastExtRadialDamageDesc, radialDamage>(desc, PxBounds3::centerExtents(position, PxVec3(desc.maxRadius)));
+}
+
+void ExtDamageFieldImpl::addCapsuleDamage(const NvBlastExtCapsuleRadialDamageDesc& desc)
+{
+	PxBounds3 bounds = PxBounds3::empty();
+	bounds.include(reinterpret_cast<const PxVec3&>(desc.position0));
+	bounds.include(reinterpret_cast<const PxVec3&>(desc.position1));
+	bounds.fattenFast(desc.maxRadius);
+	addDamage<NvBlastExtCapsuleRadialDamageDesc, capsuleDamage>(desc, bounds);
+}
+
+template<typename DescT, float(*damageFn)(const float[3], const DescT&)>
+void ExtDamageFieldImpl::addDamage(const DescT& desc, const PxBounds3& bounds)
+{
+	if (m_accelerator)
+	{
+		const uint32_t CALLBACK_BUFFER_SIZE = 1000;
+
+		class AcceleratorCallback : public ExtDamageAcceleratorInternal::ResultCallback
+		{
+		public:
+			AcceleratorCallback(ExtDamageFieldImpl& field, const DescT& desc) :
+				ExtDamageAcceleratorInternal::ResultCallback(m_buffer, CALLBACK_BUFFER_SIZE),
+				m_field(field), m_desc(desc)
+			{
+			}
+
+			virtual void processResults(const ExtDamageAcceleratorInternal::QueryBondData* bondBuffer, uint32_t count) override
+			{
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const uint32_t bondIndex = bondBuffer[i].bond;
+					m_field.accumulate(bondIndex, damageFn(m_field.m_bonds[bondIndex].centroid, m_desc));
+				}
+			}
+
+		private:
+			ExtDamageFieldImpl& m_field;
+			const DescT& m_desc;
+
+			ExtDamageAcceleratorInternal::QueryBondData m_buffer[CALLBACK_BUFFER_SIZE];
+		};
+
+		AcceleratorCallback cb(*this, desc);
+		m_accelerator->findBondCentroidsInBounds(bounds, cb);
+	}
+	else
+	{
+		for (uint32_t bondIndex = 0; bondIndex < m_bondNodes.size(); bondIndex++)
+		{
+			accumulate(bondIndex, damageFn(m_bonds[bondIndex].centroid, desc));
+		}
+	}
+}
+
+void ExtDamageFieldImpl::addBondDamage(uint32_t bondIndex, float damage)
+{
+	NVBLAST_CHECK_ERROR(bondIndex < m_bondNodes.size(), "ExtDamageField::addBondDamage: bondIndex out of range.", return);
+
+	accumulate(bondIndex, damage);
+}
+
+void ExtDamageFieldImpl::accumulate(uint32_t bondIndex, float damage)
+{
+	if (damage <= 0.0f || m_bondHealths[bondIndex] <= 0.0f)
+	{
+		return;
+	}
+
+	uint32_t& entryIndex = m_bondEntries[bondIndex];
+	if (isInvalidIndex(entryIndex))
+	{
+		entryIndex = m_entries.size();
+		Entry entry = { bondIndex, 0.0f };
+		m_entries.pushBack(entry);
+	}
+	m_entries[entryIndex].damage += damage;
+}
+
+void ExtDamageFieldImpl::removeEntry(uint32_t entryIndex)
+{
+	m_bondEntries[m_entries[entryIndex].bondIndex] = invalidIndex<uint32_t>();
+	m_entries.replaceWithLast(entryIndex);
+	if (entryIndex < m_entries.size())
+	{
+		m_bondEntries[m_entries[entryIndex].bondIndex] = entryIndex;
+	}
+}
+
+float ExtDamageFieldImpl::getAccumulatedDamage(uint32_t bondIndex) const
+{
+	NVBLAST_CHECK_ERROR(bondIndex < m_bondNodes.size(), "ExtDamageField::getAccumulatedDamage: bondIndex out of range.", return 0.0f);
+
+	const uint32_t entryIndex = m_bondEntries[bondIndex];
+	return isInvalidIndex(entryIndex) ? 0.0f : m_entries[entryIndex].damage;
+}
+
+void ExtDamageFieldImpl::update(float dt)
+{
+	m_flushTime += dt;
+	if (m_settings.flushInterval > 0.0f && m_flushTime >= m_settings.flushInterval)
+	{
+		// kept until fracture commands are generated
+		m_isFlushPending = true;
+		m_flushTime = 0.0f;
+	}
+
+	m_pendingBonds.clear();
+	for (uint32_t entryIndex = 0; entryIndex < m_entries.size();)
+	{
+		const Entry& entry = m_entries[entryIndex];
+		const float bondHealth = m_bondHealths[entry.bondIndex];
+		if (bondHealth <= 0.0f)
+		{
+			// broken since the damage was added
+			removeEntry(entryIndex);
+			continue;
+		}
+
+		if (m_isFlushPending || entry.damage >= m_settings.fractureThreshold * bondHealth)
+		{
+			m_pendingBonds.pushBack(entry.bondIndex);
+		}
+		entryIndex++;
+	}
+}
+
+void ExtDamageFieldImpl::reset()
+{
+	for (const Entry& entry : m_entries)
+	{
+		m_bondEntries[entry.bondIndex] = invalidIndex<uint32_t>();
+	}
+	m_entries.clear();
+	m_pendingBonds.clear();
+	m_flushTime = 0.0f;
+	m_isFlushPending = false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Fracture
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ExtDamageFieldImpl::consumeBondFractureData(uint32_t bondIndex, NvBlastBondFractureData& data)
+{
+	const uint32_t entryIndex = m_bondEntries[bondIndex];
+	if (isInvalidIndex(entryIndex))
+	{
+		return false;
+	}
+
+	// the bond may have been broken since update()
+	const bool isIntact = m_bondHealths[bondIndex] > 0.0f;
+	if (isIntact)
+	{
+		data.userdata = 0;
+		data.nodeIndex0 = m_bondNodes[bondIndex].node0;
+		data.nodeIndex1 = m_bondNodes[bondIndex].node1;
+		data.health = m_entries[entryIndex].damage;
+	}
+	removeEntry(entryIndex);
+	return isIntact;
+}
+
+const NvBlastActor* ExtDamageFieldImpl::getBondActor(uint32_t bondIndex) const
+{
+	// one of the nodes can be the world node, which has no chunk
+	const BondNodes& nodes = m_bondNodes[bondIndex];
+	const uint32_t chunkIndex = !isInvalidIndex(m_graph.chunkIndices[nodes.node0]) ? m_graph.chunkIndices[nodes.node0] : m_graph.chunkIndices[nodes.node1];
+	return NvBlastFamilyGetChunkActor(&m_family, chunkIndex, logLL);
+}
+
+void ExtDamageFieldImpl::generateFractureCommands(NvBlastFractureBuffers& commands)
+{
+	m_bondFractureBuffer.clear();
+
+	for (const uint32_t bondIndex : m_pendingBonds)
+	{
+		NvBlastBondFractureData data;
+		if (consumeBondFractureData(bondIndex, data))
+		{
+			m_bondFractureBuffer.pushBack(data);
+		}
+	}
+	m_pendingBonds.clear();
+	m_isFlushPending = false;
+
+	commands.chunkFractureCount = 0;
+	commands.chunkFractures = nullptr;
+	commands.bondFractureCount = m_bondFractureBuffer.size();
+	commands.bondFractures = m_bondFractureBuffer.size() > 0 ? m_bondFractureBuffer.begin() : nullptr;
+}
+
+uint32_t ExtDamageFieldImpl::generateFractureCommandsPerActor(const NvBlastActor** actorBuffer, NvBlastFractureBuffers* commandsBuffer, uint32_t bufferSize)
+{
+	// group pending bonds by actor
+	m_actorBonds.clear();
+	for (const uint32_t bondIndex : m_pendingBonds)
+	{
+		if (!isInvalidIndex(m_bondEntries[bondIndex]) && m_bondHealths[bondIndex] > 0.0f)
+		{
+			ActorBond actorBond = { getBondActor(bondIndex), bondIndex };
+			m_actorBonds.pushBack(actorBond);
+		}
+	}
+	std::sort(m_actorBonds.begin(), m_actorBonds.end());
+	m_pendingBonds.clear();
+	m_isFlushPending = false;
+
+	m_bondFractureBuffer.resizeUninitialized(m_actorBonds.size());
+
+	uint32_t index = 0;
+	uint32_t i = 0;
+	for (; i < m_actorBonds.size() && index < bufferSize; ++index)
+	{
+		const NvBlastActor* actor = m_actorBonds[i].actor;
+		const uint32_t first = i;
+		while (i < m_actorBonds.size() && m_actorBonds[i].actor == actor)
+		{
+			consumeBondFractureData(m_actorBonds[i].bondIndex, m_bondFractureBuffer[i]);
+			i++;
+		}
+
+		NvBlastFractureBuffers& nextCommand = commandsBuffer[index];
+		nextCommand.chunkFractureCount = 0;
+		nextCommand.chunkFractures = nullptr;
+		nextCommand.bondFractureCount = i - first;
+		nextCommand.bondFractures = m_bondFractureBuffer.begin() + first;
+		actorBuffer[index] = actor;
+	}
+
+	// keep the bonds of the actors which didn't fit for the next call
+	for (; i < m_actorBonds.size(); ++i)
+	{
+		m_pendingBonds.pushBack(m_actorBonds[i].bondIndex);
+	}
+
+	return index;
+}
+
+
+} // namespace Blast
+} // namespace Nv
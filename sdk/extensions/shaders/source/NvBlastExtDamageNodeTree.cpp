@@ -0,0 +1,161 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#include "NvBlastExtDamageNodeTree.h"
+#include "NvBlast.h"
+#include "NvBlastGlobals.h"
+#include "NvBlastIndexFns.h"
+#include "PxBounds3.h"
+#include <algorithm>
+#include <limits>
+
+using namespace physx;
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+void ExtDamageNodeTree::build(const NvBlastAsset* asset)
+{
+	const NvBlastSupportGraph graph = NvBlastAssetGetSupportGraph(asset, logLL);
+	const NvBlastChunk* chunks = NvBlastAssetGetChunks(asset, logLL);
+
+	m_nodes.clear();
+	m_nodes.reserve(graph.nodeCount);
+	for (uint32_t nodeIndex = 0; nodeIndex < graph.nodeCount; ++nodeIndex)
+	{
+		const uint32_t chunkIndex = graph.chunkIndices[nodeIndex];
+		if (!isInvalidIndex(chunkIndex)) // Invalid if this is the world chunk
+		{
+			Node node;
+			node.position = reinterpret_cast<const PxVec3&>(chunks[chunkIndex].centroid);
+			node.nodeIndex = nodeIndex;
+			node.axis = 0;
+			m_nodes.pushBack(node);
+		}
+	}
+
+	createNode(0, m_nodes.size());
+}
+
+
+void ExtDamageNodeTree::createNode(uint32_t begin, uint32_t end)
+{
+	if (begin >= end)
+	{
+		return;
+	}
+
+	PxBounds3 bounds = PxBounds3::empty();
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		bounds.include(m_nodes[i].position);
+	}
+	const PxVec3 extents = bounds.getDimensions();
+	const uint32_t axis = extents.x >= extents.y ? (extents.x >= extents.z ? 0 : 2) : (extents.y >= extents.z ? 1 : 2);
+
+	const uint32_t middle = (begin + end) / 2;
+	std::nth_element(m_nodes.begin() + begin, m_nodes.begin() + middle, m_nodes.begin() + end, [axis](const Node& lhs, const Node& rhs)
+	{
+		return lhs.position[axis] < rhs.position[axis];
+	});
+	m_nodes[middle].axis = axis;
+
+	createNode(begin, middle);
+	createNode(middle + 1, end);
+}
+
+
+uint32_t ExtDamageNodeTree::findClosestNode(const PxVec3& point, const NvBlastGraphShaderActor* actor) const
+{
+	struct Range
+	{
+		uint32_t	begin;
+		uint32_t	end;
+		float		distSq;	//!< lower bound of the distance to the range's nodes
+	};
+
+	uint32_t closestNode = invalidIndex<uint32_t>();
+	float minDistSq = std::numeric_limits<float>::max();
+
+	Range stack[STACK_SIZE];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = { 0, m_nodes.size(), 0.0f };
+
+	while (stackSize > 0)
+	{
+		const Range range = stack[--stackSize];
+		if (range.distSq >= minDistSq)
+		{
+			continue;
+		}
+
+		uint32_t begin = range.begin;
+		uint32_t end = range.end;
+		while (begin < end)
+		{
+			const uint32_t middle = (begin + end) / 2;
+			const Node& node = m_nodes[middle];
+
+			const float distSq = (point - node.position).magnitudeSquared();
+			if (distSq < minDistSq && actor->nodeActorIndices[node.nodeIndex] == actor->actorIndex && actor->supportChunkHealths[node.nodeIndex] > 0.0f)
+			{
+				minDistSq = distSq;
+				closestNode = node.nodeIndex;
+			}
+
+			// descend to the side of the point, visit the other side later if it can still be closer
+			const float delta = point[node.axis] - node.position[node.axis];
+			const bool nearIsLower = delta < 0.0f;
+			const uint32_t farBegin = nearIsLower ? middle + 1 : begin;
+			const uint32_t farEnd = nearIsLower ? end : middle;
+			if (farBegin < farEnd && delta * delta < minDistSq)
+			{
+				if (stackSize == STACK_SIZE)
+				{
+					NVBLAST_LOG_ERROR("ExtDamageNodeTree::findClosestNode: traversal stack overflow, result may not be the closest node.");
+				}
+				else
+				{
+					stack[stackSize++] = { farBegin, farEnd, delta * delta };
+				}
+			}
+			begin = nearIsLower ? begin : middle + 1;
+			end = nearIsLower ? middle : end;
+		}
+	}
+
+	return closestNode;
+}
+
+
+} // namespace Blast
+} // namespace Nv
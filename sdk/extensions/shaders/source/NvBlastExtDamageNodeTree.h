@@ -0,0 +1,83 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#pragma once
+
+#include "NvBlastTypes.h"
+#include "NvBlastArray.h"
+#include "PxVec3.h"
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+/**
+Balanced kd-tree over the support chunk centroids of an asset, for closest node queries.
+
+Implicit layout: every range of the node array is split at its middle element, the split axis being the largest
+extent of the range. The world chunk is not stored.
+*/
+class ExtDamageNodeTree
+{
+public:
+	void build(const NvBlastAsset* asset);
+
+	/**
+	Find the node closest to point by chunk centroid distance, among the healthy nodes of an actor. Thread safe.
+
+	\param[in]	point	The point to test against.
+	\param[in]	actor	The actor whose nodes are searched.
+
+	\return		the node index, or invalid index if the actor has no healthy node with a chunk.
+	*/
+	uint32_t findClosestNode(const physx::PxVec3& point, const NvBlastGraphShaderActor* actor) const;
+
+private:
+	enum
+	{
+		STACK_SIZE = 32		//!< the tree is balanced, the query's stack holds at most one range per level
+	};
+
+	struct Node
+	{
+		physx::PxVec3	position;	//!< chunk centroid
+		uint32_t		nodeIndex;	//!< support graph node index
+		uint32_t		axis;		//!< split axis of the range this node is the middle of
+	};
+
+	void createNode(uint32_t begin, uint32_t end);
+
+	Array<Node>::type	m_nodes;
+};
+
+
+} // namespace Blast
+} // namespace Nv
@@ -0,0 +1,241 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#include "NvBlastExtDamagePattern.h"
+#include "NvBlastAssert.h"
+#include <algorithm>
+
+using namespace physx;
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Creation
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtDamagePatternImpl* ExtDamagePatternImpl::create(const NvcVec3* vertices, const uint32_t* indices, uint32_t triangleCount)
+{
+	ExtDamagePatternImpl* pattern = NVBLAST_NEW(Nv::Blast::ExtDamagePatternImpl) ();
+	pattern->build(vertices, indices, triangleCount);
+	return pattern;
+}
+
+
+void ExtDamagePatternImpl::release()
+{
+	NVBLAST_DELETE(this, ExtDamagePatternImpl);
+}
+
+
+void ExtDamagePatternImpl::build(const NvcVec3* vertices, const uint32_t* indices, uint32_t triangleCount)
+{
+	m_emptyBounds = PxBounds3::empty();
+
+	m_triangles.resizeUninitialized(triangleCount);
+	for (uint32_t i = 0; i < triangleCount; ++i)
+	{
+		m_triangles[i].a = reinterpret_cast<const PxVec3&>(vertices[indices[3 * i + 0]]);
+		m_triangles[i].b = reinterpret_cast<const PxVec3&>(vertices[indices[3 * i + 1]]);
+		m_triangles[i].c = reinterpret_cast<const PxVec3&>(vertices[indices[3 * i + 2]]);
+	}
+
+	if (triangleCount > 0)
+	{
+		m_nodes.reserve(2 * (triangleCount / LEAF_SIZE + 1));
+		m_nodes.pushBack(Node());
+		createNode(0, 0, triangleCount, 0);
+	}
+}
+
+
+void ExtDamagePatternImpl::createNode(uint32_t nodeIndex, uint32_t first, uint32_t count, uint32_t depth)
+{
+	PxBounds3 bounds = PxBounds3::empty();
+	PxBounds3 centroidBounds = PxBounds3::empty();
+	for (uint32_t i = first; i < first + count; ++i)
+	{
+		const Triangle& triangle = m_triangles[i];
+		bounds.include(triangle.a);
+		bounds.include(triangle.b);
+		bounds.include(triangle.c);
+		centroidBounds.include((triangle.a + triangle.b + triangle.c) * (1.0f / 3.0f));
+	}
+	m_nodes[nodeIndex].bounds = bounds;
+
+	if (count <= LEAF_SIZE || depth + 1 >= MAX_DEPTH)
+	{
+		m_nodes[nodeIndex].first = first;
+		m_nodes[nodeIndex].count = count;
+		return;
+	}
+
+	// median split on the largest axis of the centroids
+	const PxVec3 extents = centroidBounds.getDimensions();
+	const uint32_t axis = extents.x >= extents.y ? (extents.x >= extents.z ? 0 : 2) : (extents.y >= extents.z ? 1 : 2);
+	const uint32_t leftCount = count / 2;
+	std::nth_element(m_triangles.begin() + first, m_triangles.begin() + first + leftCount, m_triangles.begin() + first + count, [axis](const Triangle& lhs, const Triangle& rhs)
+	{
+		return lhs.a[axis] + lhs.b[axis] + lhs.c[axis] < rhs.a[axis] + rhs.b[axis] + rhs.c[axis];
+	});
+
+	const uint32_t child = m_nodes.size();
+	m_nodes.pushBack(Node());
+	m_nodes.pushBack(Node());
+	m_nodes[nodeIndex].first = child;
+	m_nodes[nodeIndex].count = 0;
+
+	createNode(child, first, leftCount, depth + 1);
+	createNode(child + 1, first + leftCount, count - leftCount, depth + 1);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Queries
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool intersectSegmentBounds(const PxVec3& p0, const PxVec3& dir, const PxBounds3& bounds)
+{
+	float tMin = 0.0f;
+	float tMax = 1.0f;
+	for (uint32_t axis = 0; axis < 3; ++axis)
+	{
+		if (PxAbs(dir[axis]) < 1e-12f)
+		{
+			if (p0[axis] < bounds.minimum[axis] || p0[axis] > bounds.maximum[axis])
+			{
+				return false;
+			}
+		}
+		else
+		{
+			const float invDir = 1.0f / dir[axis];
+			float t0 = (bounds.minimum[axis] - p0[axis]) * invDir;
+			float t1 = (bounds.maximum[axis] - p0[axis]) * invDir;
+			if (t0 > t1)
+			{
+				std::swap(t0, t1);
+			}
+			tMin = PxMax(tMin, t0);
+			tMax = PxMin(tMax, t1);
+			if (tMin > tMax)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool intersectSegmentTriangle(const PxVec3& p0, const PxVec3& dir, const PxVec3& a, const PxVec3& b, const PxVec3& c)
+{
+	const PxVec3 ab = b - a;
+	const PxVec3 ac = c - a;
+	const PxVec3 pvec = dir.cross(ac);
+	const float det = ab.dot(pvec);
+	if (PxAbs(det) < 1e-12f)
+	{
+		// segment parallel to the triangle
+		return false;
+	}
+	const float invDet = 1.0f / det;
+
+	const PxVec3 tvec = p0 - a;
+	const float u = tvec.dot(pvec) * invDet;
+	if (u < 0.0f || u > 1.0f)
+	{
+		return false;
+	}
+
+	const PxVec3 qvec = tvec.cross(ab);
+	const float v = dir.dot(qvec) * invDet;
+	if (v < 0.0f || u + v > 1.0f)
+	{
+		return false;
+	}
+
+	const float t = ac.dot(qvec) * invDet;
+	return t >= 0.0f && t <= 1.0f;
+}
+
+bool ExtDamagePatternImpl::intersectsSegment(const PxVec3& p0, const PxVec3& p1) const
+{
+	if (m_nodes.size() == 0)
+	{
+		return false;
+	}
+
+	const PxVec3 dir = p1 - p0;
+
+	uint32_t stack[STACK_SIZE];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if (!intersectSegmentBounds(p0, dir, node.bounds))
+		{
+			continue;
+		}
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; ++i)
+			{
+				const Triangle& triangle = m_triangles[i];
+				if (intersectSegmentTriangle(p0, dir, triangle.a, triangle.b, triangle.c))
+				{
+					return true;
+				}
+			}
+		}
+		else
+		{
+			NVBLAST_ASSERT(stackSize + 2 <= STACK_SIZE);
+			stack[stackSize++] = node.first + 1;
+			stack[stackSize++] = node.first;
+		}
+	}
+
+	return false;
+}
+
+
+} // namespace Blast
+} // namespace Nv
+
+
+NvBlastExtDamagePattern* NvBlastExtDamagePatternCreate(const NvcVec3* vertices, const uint32_t* indices, uint32_t triangleCount)
+{
+	return Nv::Blast::ExtDamagePatternImpl::create(vertices, indices, triangleCount);
+}
@@ -0,0 +1,125 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#pragma once
+
+#include "NvBlastExtDamageShaders.h"
+#include "NvBlastArray.h"
+#include "PxBounds3.h"
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+/**
+Damage pattern triangles in a binary bounding volume hierarchy, for segment intersection queries.
+
+Built with a median split on the largest axis, triangles are stored in leaf order. Queries are const, iterative with
+a fixed size stack, and thus thread safe: one pattern can be used by concurrent shader calls.
+*/
+class ExtDamagePatternImpl final : public NvBlastExtDamagePattern
+{
+public:
+	//////// ctor ////////
+
+	ExtDamagePatternImpl()
+	{
+	}
+
+	virtual ~ExtDamagePatternImpl()
+	{
+	}
+
+	static ExtDamagePatternImpl* create(const NvcVec3* vertices, const uint32_t* indices, uint32_t triangleCount);
+
+
+	//////// interface ////////
+
+	virtual void release() override;
+
+
+	//////// queries ////////
+
+	/**
+	\return the bounds of all the triangles, in pattern space.
+	*/
+	const physx::PxBounds3& getBounds() const
+	{
+		return m_nodes.size() > 0 ? m_nodes[0].bounds : m_emptyBounds;
+	}
+
+	/**
+	\return true if the segment (p0, p1), in pattern space, intersects any triangle.
+	*/
+	bool intersectsSegment(const physx::PxVec3& p0, const physx::PxVec3& p1) const;
+
+
+private:
+	// no copy/assignment
+	ExtDamagePatternImpl(ExtDamagePatternImpl&);
+	ExtDamagePatternImpl& operator=(const ExtDamagePatternImpl& pattern);
+
+	enum
+	{
+		LEAF_SIZE = 4,					//!< max triangles per leaf
+		MAX_DEPTH = 32,					//!< deeper ranges are made leaves whatever their size
+		STACK_SIZE = MAX_DEPTH + 1		//!< one child pushed per level
+	};
+
+	struct Triangle
+	{
+		physx::PxVec3	a;
+		physx::PxVec3	b;
+		physx::PxVec3	c;
+	};
+
+	struct Node
+	{
+		physx::PxBounds3	bounds;
+		uint32_t			first;		//!< first triangle of a leaf, first of the two children of an inner node
+		uint32_t			count;		//!< triangle count of a leaf, 0 for an inner node
+	};
+
+	void build(const NvcVec3* vertices, const uint32_t* indices, uint32_t triangleCount);
+
+	void createNode(uint32_t nodeIndex, uint32_t first, uint32_t count, uint32_t depth);
+
+
+	//////// data ////////
+
+	Array<Node>::type		m_nodes;
+	Array<Triangle>::type	m_triangles;
+	physx::PxBounds3		m_emptyBounds;
+};
+
+
+} // namespace Blast
+} // namespace Nv
@@ -28,6 +28,7 @@
 
 #include "NvBlastExtDamageShaders.h"
 #include "NvBlastExtDamageAcceleratorInternal.h"
+#include "NvBlastExtDamagePattern.h"
 #include "NvBlastIndexFns.h"
 #include "NvBlastMath.h"
 #include "NvBlastGeometry.h"
@@ -117,6 +118,122 @@ float capsuleDistanceDamage(const float pos[3], const void* damageDesc)
 	return damage;
 }
 
+// Distance from 2D point 'p' to 2D line segment '(a, b)'
+float distanceToSegment2D(float px, float py, float ax, float ay, float bx, float by)
+{
+	const float vx = bx - ax, vy = by - ay;
+	const float wx = px - ax, wy = py - ay;
+	const float vv = vx * vx + vy * vy;
+	const float t = vv > 0.0f ? PxClamp((vx * wx + vy * wy) / vv, 0.0f, 1.0f) : 0.0f;
+	const float dx = wx - t * vx, dy = wy - t * vy;
+	return sqrtf(dx * dx + dy * dy);
+}
+
+// Distance from point 'p' to the oriented box, 0 inside
+float distanceToBox(const float p[3], const float center[3], const float halfExtents[3], const float rotation[4])
+{
+	const PxQuat& q = reinterpret_cast<const PxQuat&>(*rotation);
+	const PxVec3 local = q.rotateInv(reinterpret_cast<const PxVec3&>(*p) - reinterpret_cast<const PxVec3&>(*center));
+	const PxVec3 outside(
+		PxMax(PxAbs(local.x) - halfExtents[0], 0.0f),
+		PxMax(PxAbs(local.y) - halfExtents[1], 0.0f),
+		PxMax(PxAbs(local.z) - halfExtents[2], 0.0f));
+	return outside.magnitude();
+}
+
+/**
+Tangent of a cone half angle clamped to [0, PI/2), just below PI/2 so that the base radius stays finite.
+*/
+float coneTanAngle(float angle)
+{
+	const float MAX_CONE_ANGLE = 0.4999f * PxPi;
+	return PxTan(PxClamp(angle, 0.0f, MAX_CONE_ANGLE));
+}
+
+/**
+Distance from point 'p' to the solid cone (apex, base), 0 inside.
+
+Points beyond maxDistance of the apex or base planes are culled, a distance larger than maxDistance is returned for
+them. Otherwise, the cone being symmetric around its axis, the distance is computed in the (axial, radial) half plane
+where the cone is the triangle (0, 0), (h, 0), (h, R).
+*/
+float distanceToCone(const float p[3], const float apex[3], const float base[3], float angle, float maxDistance)
+{
+	const PxVec3& a = reinterpret_cast<const PxVec3&>(*apex);
+	PxVec3 axis = reinterpret_cast<const PxVec3&>(*base) - a;
+	const float h = axis.normalize();
+	const PxVec3 w = reinterpret_cast<const PxVec3&>(*p) - a;
+	if (h == 0.0f)
+	{
+		return w.magnitude();
+	}
+
+	const float t = w.dot(axis);
+	if (t < -maxDistance || t > h + maxDistance)
+	{
+		return PxAbs(t) + maxDistance;
+	}
+
+	const float r = PxSqrt(PxMax((w - axis * t).magnitudeSquared(), 0.0f));
+	const float tanAngle = coneTanAngle(angle);
+	if (t >= 0.0f && t <= h && r <= t * tanAngle)
+	{
+		return 0.0f;
+	}
+
+	const float R = h * tanAngle;
+	return PxMin(distanceToSegment2D(t, r, 0.0f, 0.0f, h, R), distanceToSegment2D(t, r, h, 0.0f, h, R));
+}
+
+/**
+Largest signed distance from point 'p' to the frustum planes, 0 inside. A lower bound of the distance to the frustum,
+exact in front of its faces. Culls on the first plane farther than maxDistance.
+*/
+float distanceToFrustumPlanes(const float p[3], const float planes[6][4], float maxDistance)
+{
+	float distance = 0.0f;
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		const float d = dot(planes[i], p) + planes[i][3];
+		if (d > maxDistance)
+		{
+			return d;
+		}
+		distance = PxMax(distance, d);
+	}
+	return distance;
+}
+
+template <ProfileFunction profileFn>
+float coneDistanceDamage(const float pos[3], const void* damageDesc)
+{
+	const NvBlastExtConeDamageDesc& desc = *static_cast<const NvBlastExtConeDamageDesc*>(damageDesc);
+
+	const float distance = distanceToCone(pos, desc.position0, desc.position1, desc.angle, desc.maxRadius);
+	const float damage = profileFn(desc.minRadius, desc.maxRadius, distance, desc.damage);
+	return damage;
+}
+
+template <ProfileFunction profileFn>
+float boxDistanceDamage(const float pos[3], const void* damageDesc)
+{
+	const NvBlastExtBoxDamageDesc& desc = *static_cast<const NvBlastExtBoxDamageDesc*>(damageDesc);
+
+	const float distance = distanceToBox(pos, desc.position, desc.halfExtents, desc.rotation);
+	const float damage = profileFn(desc.minRadius, desc.maxRadius, distance, desc.damage);
+	return damage;
+}
+
+template <ProfileFunction profileFn>
+float frustumDistanceDamage(const float pos[3], const void* damageDesc)
+{
+	const NvBlastExtFrustumDamageDesc& desc = *static_cast<const NvBlastExtFrustumDamageDesc*>(damageDesc);
+
+	const float distance = distanceToFrustumPlanes(pos, desc.planes, desc.maxRadius);
+	const float damage = profileFn(desc.minRadius, desc.maxRadius, distance, desc.damage);
+	return damage;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //													AABB Functions
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -142,12 +259,174 @@ PxBounds3 capsuleBounds(const void* damageDesc)
 	return b;
 }
 
+PxBounds3 orientedBoxBounds(const float center[3], const float halfExtents[3], const float rotation[4], float radius)
+{
+	const PxMat33 basis(reinterpret_cast<const PxQuat&>(*rotation));
+	PxBounds3 b = PxBounds3::basisExtent(reinterpret_cast<const PxVec3&>(*center), basis, reinterpret_cast<const PxVec3&>(*halfExtents));
+	b.fattenFast(radius);
+	return b;
+}
+
+/**
+Bounds of the apex and of the base disk, whose extent along each world axis is R * sqrt(1 - axis[i]^2).
+*/
+PxBounds3 solidConeBounds(const float apex[3], const float base[3], float angle, float radius)
+{
+	const PxVec3& a = reinterpret_cast<const PxVec3&>(*apex);
+	const PxVec3& c = reinterpret_cast<const PxVec3&>(*base);
+	PxVec3 axis = c - a;
+	const float R = axis.normalize() * coneTanAngle(angle);
+	const PxVec3 diskExtents(
+		R * PxSqrt(PxMax(1.0f - axis.x * axis.x, 0.0f)),
+		R * PxSqrt(PxMax(1.0f - axis.y * axis.y, 0.0f)),
+		R * PxSqrt(PxMax(1.0f - axis.z * axis.z, 0.0f)));
+	PxBounds3 b = PxBounds3::centerExtents(c, diskExtents);
+	b.include(a);
+	b.fattenFast(radius);
+	return b;
+}
+
+PxBounds3 coneBounds(const void* damageDesc)
+{
+	const NvBlastExtConeDamageDesc& desc = *static_cast<const NvBlastExtConeDamageDesc*>(damageDesc);
+	return solidConeBounds(desc.position0, desc.position1, desc.angle, desc.maxRadius);
+}
+
+PxBounds3 boxBounds(const void* damageDesc)
+{
+	const NvBlastExtBoxDamageDesc& desc = *static_cast<const NvBlastExtBoxDamageDesc*>(damageDesc);
+	return orientedBoxBounds(desc.position, desc.halfExtents, desc.rotation, desc.maxRadius);
+}
+
+/**
+Bounds of the corners of the frustum with its planes pushed out by maxRadius, the region where damage is applied.
+Corners are intersections of a near/far, a left/right and a bottom/top plane.
+*/
+PxBounds3 frustumBounds(const void* damageDesc)
+{
+	const NvBlastExtFrustumDamageDesc& desc = *static_cast<const NvBlastExtFrustumDamageDesc*>(damageDesc);
+
+	PxVec3 n[6];
+	float d[6];
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		n[i] = reinterpret_cast<const PxVec3&>(desc.planes[i]);
+		d[i] = desc.planes[i][3] - desc.maxRadius;
+	}
+
+	PxBounds3 b = PxBounds3::empty();
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		const uint32_t p0 = (i & 1), p1 = 2 + ((i >> 1) & 1), p2 = 4 + ((i >> 2) & 1);
+		const PxVec3 n12 = n[p1].cross(n[p2]);
+		const float det = n[p0].dot(n12);
+		if (PxAbs(det) > 1e-6f)
+		{
+			b.include((n12 * d[p0] + n[p2].cross(n[p0]) * d[p1] + n[p0].cross(n[p1]) * d[p2]) * (-1.0f / det));
+		}
+	}
+	return b;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Damage Filters
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+Applied to the damage of each stacked desc on a bond or a chunk, normal is the bond normal or nullptr for chunks.
+*/
+typedef float(*DamageFilterFunction)(float damage, const float* normal, const void* damageDesc, const NvBlastExtProgramParams* programParams);
+
+float noDamageFilter(float damage, const float*, const void*, const NvBlastExtProgramParams*)
+{
+	return damage;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//												Stacked Damage Descriptions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <DamageFunction damageFn, typename DescT, DamageFilterFunction filterFn = noDamageFilter>
+float stackedDamage(const float pos[3], const float* normal, const NvBlastExtProgramParams* programParams)
+{
+	const DescT* descs = static_cast<const DescT*>(programParams->damageDesc);
+	float damage = 0.0f;
+	for (uint32_t i = 0; i < programParams->damageDescCount; i++)
+	{
+		damage += filterFn(damageFn(pos, &descs[i]), normal, &descs[i], programParams);
+	}
+	return damage;
+}
+
+template <BoundFunction boundsFn, typename DescT>
+PxBounds3 stackedBounds(const NvBlastExtProgramParams* programParams)
+{
+	const DescT* descs = static_cast<const DescT*>(programParams->damageDesc);
+	PxBounds3 bounds = PxBounds3::empty();
+	for (uint32_t i = 0; i < programParams->damageDescCount; i++)
+	{
+		bounds.include(boundsFn(&descs[i]));
+	}
+	return bounds;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Acceleration
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+Brute force visits the adjacency of every node of the actor. The accelerator's traversal visits the bonds of every actor
+in the query bounds, then drops other actors' bonds before buffering them. Accelerate when that's estimated to be cheaper.
+*/
+static bool shouldAccelerate(const ExtDamageAcceleratorInternal* accelerator, const NvBlastGraphShaderActor* actor, float queryBondCount)
+{
+	if (accelerator == nullptr || actor->assetNodeCount == 0)
+	{
+		return false;
+	}
+
+	const float ACCELERATED_QUERY_COST = 64.0f;	// traversal, in brute force adjacency visits
+	const float ACCELERATED_BOND_COST = 2.0f;	// per bond found by the query, in brute force adjacency visits
+
+	const float actorAdjacencyCount = static_cast<float>(actor->graphNodeCount) * actor->adjacencyPartition[actor->assetNodeCount] / actor->assetNodeCount;
+	return ACCELERATED_QUERY_COST + ACCELERATED_BOND_COST * queryBondCount < actorAdjacencyCount;
+}
+
+/**
+Find the node closest to point, like findClosestNode, with the accelerator's nearest node query when the actor is big
+enough for the query to beat scanning all of its nodes.
+*/
+static uint32_t findClosestActorNode(const ExtDamageAcceleratorInternal* accelerator, const NvBlastGraphShaderActor* actor, const float point[3])
+{
+	const uint32_t ACTOR_MINIMUM_NODE_COUNT_TO_ACCELERATE = 32;
+	if (accelerator && actor->graphNodeCount >= ACTOR_MINIMUM_NODE_COUNT_TO_ACCELERATE)
+	{
+		const uint32_t closestNode = accelerator->findClosestNode(reinterpret_cast<const PxVec3&>(*point), actor);
+		if (!isInvalidIndex(closestNode))
+		{
+			return refineClosestNode(point, closestNode
+				, actor->adjacencyPartition, actor->adjacentNodeIndices, actor->adjacentBondIndices
+				, actor->assetBonds, actor->familyBondHealths
+				, actor->supportChunkHealths, actor->chunkIndices);
+		}
+	}
+
+	return findClosestNode(point
+		, actor->firstGraphNodeIndex, actor->graphNodeIndexLinks
+		, actor->adjacencyPartition, actor->adjacentNodeIndices, actor->adjacentBondIndices
+		, actor->assetBonds, actor->familyBondHealths
+		, actor->assetChunks, actor->supportChunkHealths, actor->chunkIndices);
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //												Radial Graph Shader Template
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template <DamageFunction damageFn, BoundFunction boundsFn>
+template <DamageFunction damageFn, BoundFunction boundsFn, typename DescT, DamageFilterFunction filterFn = noDamageFilter>
 void RadialProfileGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params)
 {
 	const uint32_t* graphNodeIndexLinks = actor->graphNodeIndexLinks;
@@ -170,7 +449,7 @@ void RadialProfileGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBl
 		{
 			const NvBlastBond& bond = assetBonds[bondIndex];
 
-			const float totalBondDamage = damageFn(bond.centroid, programParams->damageDesc);
+			const float totalBondDamage = stackedDamage<damageFn, DescT, filterFn>(bond.centroid, bond.normal, programParams);
 			if (totalBondDamage > 0.0f)
 			{
 				NvBlastBondFractureData& outCommand = commandBuffers->bondFractures[outCount++];
@@ -182,11 +461,9 @@ void RadialProfileGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBl
 	};
 
 	const ExtDamageAcceleratorInternal* damageAccelerator = programParams->accelerator ? static_cast<const ExtDamageAcceleratorInternal*>(programParams->accelerator) : nullptr;
-	const uint32_t ACTOR_MINIMUM_NODE_COUNT_TO_ACCELERATE = actor->assetNodeCount / 3;
-	if (damageAccelerator && actor->graphNodeCount > ACTOR_MINIMUM_NODE_COUNT_TO_ACCELERATE)
+	const physx::PxBounds3 bounds = damageAccelerator ? stackedBounds<boundsFn, DescT>(programParams) : PxBounds3::empty();
+	if (shouldAccelerate(damageAccelerator, actor, damageAccelerator ? damageAccelerator->estimateBondCountInBounds(bounds) : 0.0f))
 	{
-		physx::PxBounds3 bounds = boundsFn(programParams->damageDesc);
-
 		const uint32_t CALLBACK_BUFFER_SIZE = 1000;
 
 		class AcceleratorCallback : public ExtDamageAcceleratorInternal::ResultCallback
@@ -205,21 +482,19 @@ void RadialProfileGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBl
 			{
 				for (uint32_t i = 0; i < count; i++)
 				{
+					// bonds of other actors are dropped by the callback's actor filter
 					const ExtDamageAcceleratorInternal::QueryBondData& bondData = bondBuffer[i];
-					if (m_actor->nodeActorIndices[bondData.node0] == m_actor->actorIndex)
+					if ((m_actor->familyBondHealths[bondData.bond] > 0.0f))
 					{
-						if ((m_actor->familyBondHealths[bondData.bond] > 0.0f))
+						const NvBlastBond& bond = m_actor->assetBonds[bondData.bond];
+
+						const float totalBondDamage = stackedDamage<damageFn, DescT, filterFn>(bond.centroid, bond.normal, m_programParams);
+						if (totalBondDamage > 0.0f)
 						{
-							const NvBlastBond& bond = m_actor->assetBonds[bondData.bond];
-
-							const float totalBondDamage = damageFn(bond.centroid, m_programParams->damageDesc);
-							if (totalBondDamage > 0.0f)
-							{
-								NvBlastBondFractureData& outCommand = m_commandBuffers->bondFractures[m_outCount++];
-								outCommand.nodeIndex0 = bondData.node0;
-								outCommand.nodeIndex1 = bondData.node1;
-								outCommand.health = totalBondDamage;
-							}
+							NvBlastBondFractureData& outCommand = m_commandBuffers->bondFractures[m_outCount++];
+							outCommand.nodeIndex0 = bondData.node0;
+							outCommand.nodeIndex1 = bondData.node1;
+							outCommand.health = totalBondDamage;
 						}
 					}
 				}
@@ -235,6 +510,7 @@ void RadialProfileGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBl
 		};
 
 		AcceleratorCallback cb(commandBuffers, outCount, actor, programParams);
+		cb.setActorFilter(actor->nodeActorIndices, actor->actorIndex);
 
 		damageAccelerator->findBondCentroidsInBounds(bounds, cb);
 	}
@@ -265,7 +541,7 @@ void RadialProfileGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBl
 //											Radial Single Shader Template
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template <DamageFunction damageFn>
+template <DamageFunction damageFn, typename DescT, DamageFilterFunction filterFn = noDamageFilter>
 void RadialProfileSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params)
 {
 	uint32_t chunkFractureCount = 0;
@@ -275,7 +551,7 @@ void RadialProfileSubgraphShader(NvBlastFractureBuffers* commandBuffers, const N
 	const NvBlastChunk& chunk = assetChunks[chunkIndex];
 	const NvBlastExtProgramParams* programParams = static_cast<const NvBlastExtProgramParams*>(params);
 
-	const float totalDamage = damageFn(chunk.centroid, programParams->damageDesc);
+	const float totalDamage = stackedDamage<damageFn, DescT, filterFn>(chunk.centroid, nullptr, programParams);
 	if (totalDamage > 0.0f && chunkFractureCount < chunkFractureCountMax)
 	{
 		NvBlastChunkFractureData& frac = commandBuffers->chunkFractures[chunkFractureCount++];
@@ -294,32 +570,155 @@ void RadialProfileSubgraphShader(NvBlastFractureBuffers* commandBuffers, const N
 
 void NvBlastExtFalloffGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params)
 {
-	RadialProfileGraphShader<pointDistanceDamage<falloffProfile>, sphereBounds>(commandBuffers, actor, params);
+	RadialProfileGraphShader<pointDistanceDamage<falloffProfile>, sphereBounds, NvBlastExtRadialDamageDesc>(commandBuffers, actor, params);
 }
 
 void NvBlastExtFalloffSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params)
 {
-	RadialProfileSubgraphShader<pointDistanceDamage<falloffProfile>>(commandBuffers, actor, params);
+	RadialProfileSubgraphShader<pointDistanceDamage<falloffProfile>, NvBlastExtRadialDamageDesc>(commandBuffers, actor, params);
 }
 
 void NvBlastExtCutterGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params)
 {
-	RadialProfileGraphShader<pointDistanceDamage<cutterProfile>, sphereBounds>(commandBuffers, actor, params);
+	RadialProfileGraphShader<pointDistanceDamage<cutterProfile>, sphereBounds, NvBlastExtRadialDamageDesc>(commandBuffers, actor, params);
 }
 
 void NvBlastExtCutterSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params)
 {
-	RadialProfileSubgraphShader<pointDistanceDamage<cutterProfile>>(commandBuffers, actor, params);
+	RadialProfileSubgraphShader<pointDistanceDamage<cutterProfile>, NvBlastExtRadialDamageDesc>(commandBuffers, actor, params);
 }
 
 void NvBlastExtCapsuleFalloffGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params)
 {
-	RadialProfileGraphShader<capsuleDistanceDamage<falloffProfile>, capsuleBounds>(commandBuffers, actor, params);
+	RadialProfileGraphShader<capsuleDistanceDamage<falloffProfile>, capsuleBounds, NvBlastExtCapsuleRadialDamageDesc>(commandBuffers, actor, params);
 }
 
 void NvBlastExtCapsuleFalloffSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params)
 {
-	RadialProfileSubgraphShader<capsuleDistanceDamage<falloffProfile>>(commandBuffers, actor, params);
+	RadialProfileSubgraphShader<capsuleDistanceDamage<falloffProfile>, NvBlastExtCapsuleRadialDamageDesc>(commandBuffers, actor, params);
+}
+
+void NvBlastExtConeFalloffGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params)
+{
+	RadialProfileGraphShader<coneDistanceDamage<falloffProfile>, coneBounds, NvBlastExtConeDamageDesc>(commandBuffers, actor, params);
+}
+
+void NvBlastExtConeFalloffSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params)
+{
+	RadialProfileSubgraphShader<coneDistanceDamage<falloffProfile>, NvBlastExtConeDamageDesc>(commandBuffers, actor, params);
+}
+
+void NvBlastExtBoxFalloffGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params)
+{
+	RadialProfileGraphShader<boxDistanceDamage<falloffProfile>, boxBounds, NvBlastExtBoxDamageDesc>(commandBuffers, actor, params);
+}
+
+void NvBlastExtBoxFalloffSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params)
+{
+	RadialProfileSubgraphShader<boxDistanceDamage<falloffProfile>, NvBlastExtBoxDamageDesc>(commandBuffers, actor, params);
+}
+
+void NvBlastExtFrustumFalloffGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params)
+{
+	RadialProfileGraphShader<frustumDistanceDamage<falloffProfile>, frustumBounds, NvBlastExtFrustumDamageDesc>(commandBuffers, actor, params);
+}
+
+void NvBlastExtFrustumFalloffSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params)
+{
+	RadialProfileSubgraphShader<frustumDistanceDamage<falloffProfile>, NvBlastExtFrustumDamageDesc>(commandBuffers, actor, params);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//												Damage Coalescing
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef void(*CopyDescsFunction)(void* descs, const NvBlastExtProgramParams* programParams, float damageScale);
+
+template <typename DescT>
+void copyScaledDescs(void* descs, const NvBlastExtProgramParams* programParams, float damageScale)
+{
+	DescT* dst = static_cast<DescT*>(descs);
+	const DescT* src = static_cast<const DescT*>(programParams->damageDesc);
+	for (uint32_t i = 0; i < programParams->damageDescCount; i++)
+	{
+		dst[i] = src[i];
+		dst[i].damage *= damageScale;
+	}
+}
+
+struct CoalescedProgram
+{
+	NvBlastGraphShaderFunction		graphShaderFunction;
+	NvBlastSubgraphShaderFunction	subgraphShaderFunction;
+	size_t							descSize;
+	CopyDescsFunction				copyDescs;
+};
+
+// programs whose damage descriptions stack, see stackedDamage
+static const CoalescedProgram g_coalescedPrograms[] =
+{
+	{ NvBlastExtFalloffGraphShader, NvBlastExtFalloffSubgraphShader, sizeof(NvBlastExtRadialDamageDesc), copyScaledDescs<NvBlastExtRadialDamageDesc> },
+	{ NvBlastExtCutterGraphShader, NvBlastExtCutterSubgraphShader, sizeof(NvBlastExtRadialDamageDesc), copyScaledDescs<NvBlastExtRadialDamageDesc> },
+	{ NvBlastExtCapsuleFalloffGraphShader, NvBlastExtCapsuleFalloffSubgraphShader, sizeof(NvBlastExtCapsuleRadialDamageDesc), copyScaledDescs<NvBlastExtCapsuleRadialDamageDesc> },
+	{ NvBlastExtConeFalloffGraphShader, NvBlastExtConeFalloffSubgraphShader, sizeof(NvBlastExtConeDamageDesc), copyScaledDescs<NvBlastExtConeDamageDesc> },
+	{ NvBlastExtBoxFalloffGraphShader, NvBlastExtBoxFalloffSubgraphShader, sizeof(NvBlastExtBoxDamageDesc), copyScaledDescs<NvBlastExtBoxDamageDesc> },
+	{ NvBlastExtFrustumFalloffGraphShader, NvBlastExtFrustumFalloffSubgraphShader, sizeof(NvBlastExtFrustumDamageDesc), copyScaledDescs<NvBlastExtFrustumDamageDesc> },
+};
+
+static const CoalescedProgram* findCoalescedProgram(const NvBlastDamageProgram* program)
+{
+	for (const CoalescedProgram& coalesced : g_coalescedPrograms)
+	{
+		// programs for actors without subsupport chunks may leave the subgraph shader out
+		if (program->graphShaderFunction == coalesced.graphShaderFunction &&
+			(program->subgraphShaderFunction == nullptr || program->subgraphShaderFunction == coalesced.subgraphShaderFunction))
+		{
+			return &coalesced;
+		}
+	}
+	return nullptr;
+}
+
+size_t NvBlastExtDamageGetCombinedParamsSize(const NvBlastDamageProgram* program, const void* const* programParams, uint32_t paramsCount)
+{
+	const CoalescedProgram* coalesced = program != nullptr ? findCoalescedProgram(program) : nullptr;
+	if (coalesced == nullptr || programParams == nullptr || paramsCount == 0)
+	{
+		return 0;
+	}
+
+	const NvBlastExtProgramParams* first = static_cast<const NvBlastExtProgramParams*>(programParams[0]);
+	uint32_t descCount = 0;
+	for (uint32_t i = 0; i < paramsCount; i++)
+	{
+		const NvBlastExtProgramParams* params = static_cast<const NvBlastExtProgramParams*>(programParams[i]);
+		if (params == nullptr || params->material != first->material || params->accelerator != first->accelerator)
+		{
+			return 0;
+		}
+		descCount += params->damageDescCount;
+	}
+
+	return sizeof(NvBlastExtProgramParams) + descCount * coalesced->descSize;
+}
+
+void NvBlastExtDamageCombineParams(void* combinedParams, const NvBlastDamageProgram* program, const void* const* programParams, uint32_t paramsCount, float damageScale)
+{
+	const CoalescedProgram* coalesced = findCoalescedProgram(program);
+	NVBLAST_ASSERT(coalesced != nullptr && paramsCount > 0);
+
+	char* descs = static_cast<char*>(combinedParams) + sizeof(NvBlastExtProgramParams);
+	uint32_t descCount = 0;
+	for (uint32_t i = 0; i < paramsCount; i++)
+	{
+		const NvBlastExtProgramParams* params = static_cast<const NvBlastExtProgramParams*>(programParams[i]);
+		coalesced->copyDescs(descs + descCount * coalesced->descSize, params, damageScale);
+		descCount += params->damageDescCount;
+	}
+
+	const NvBlastExtProgramParams* first = static_cast<const NvBlastExtProgramParams*>(programParams[0]);
+	new (combinedParams) NvBlastExtProgramParams(descs, first->material, first->accelerator, descCount);
 }
 
 
@@ -335,8 +734,6 @@ void NvBlastExtShearGraphShader(NvBlastFractureBuffers* commandBuffers, const Nv
 	uint32_t bondFractureCountMax = commandBuffers->bondFractureCount;
 	const NvBlastExtProgramParams* programParams = static_cast<const NvBlastExtProgramParams*>(params);
 	const NvBlastExtShearDamageDesc& desc = *static_cast<const NvBlastExtShearDamageDesc*>(programParams->damageDesc);
-	const uint32_t* graphNodeIndexLinks = actor->graphNodeIndexLinks;
-	const uint32_t firstGraphNodeIndex = actor->firstGraphNodeIndex;
 	const uint32_t* chunkIndices = actor->chunkIndices;
 	const uint32_t*	adjacencyPartition = actor->adjacencyPartition;
 	const uint32_t*	adjacentNodeIndices = actor->adjacentNodeIndices;
@@ -344,13 +741,9 @@ void NvBlastExtShearGraphShader(NvBlastFractureBuffers* commandBuffers, const Nv
 	const NvBlastBond* assetBonds = actor->assetBonds;
 	const NvBlastChunk* assetChunks = actor->assetChunks;
 	const float* familyBondHealths = actor->familyBondHealths;
-	const float* supportChunkHealths = actor->supportChunkHealths;
 
-	uint32_t closestNode = findClosestNode(desc.position
-		, firstGraphNodeIndex, graphNodeIndexLinks
-		, adjacencyPartition, adjacentNodeIndices, adjacentBondIndices
-		, assetBonds, familyBondHealths
-		, assetChunks, supportChunkHealths, chunkIndices);
+	const ExtDamageAcceleratorInternal* damageAccelerator = programParams->accelerator ? static_cast<const ExtDamageAcceleratorInternal*>(programParams->accelerator) : nullptr;
+	uint32_t closestNode = findClosestActorNode(damageAccelerator, actor, desc.position);
 
 	uint32_t nodeIndex = closestNode;
 	float maxDist = 0.0f;
@@ -412,7 +805,10 @@ void NvBlastExtShearGraphShader(NvBlastFractureBuffers* commandBuffers, const Nv
 
 void NvBlastExtShearSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params)
 {
-	RadialProfileSubgraphShader<pointDistanceDamage<falloffProfile, NvBlastExtShearDamageDesc>>(commandBuffers, actor, params);
+	// like the graph shader, only the first desc
+	const NvBlastExtProgramParams* programParams = static_cast<const NvBlastExtProgramParams*>(params);
+	const NvBlastExtProgramParams firstDescParams(programParams->damageDesc, programParams->material, programParams->accelerator);
+	RadialProfileSubgraphShader<pointDistanceDamage<falloffProfile, NvBlastExtShearDamageDesc>, NvBlastExtShearDamageDesc>(commandBuffers, actor, &firstDescParams);
 }
 
 
@@ -482,8 +878,7 @@ void NvBlastExtTriangleIntersectionGraphShader(NvBlastFractureBuffers* commandBu
 	uint32_t outCount = 0;
 
 	const ExtDamageAcceleratorInternal* damageAccelerator = programParams->accelerator ? static_cast<const ExtDamageAcceleratorInternal*>(programParams->accelerator) : nullptr;
-	const uint32_t ACTOR_MINIMUM_NODE_COUNT_TO_ACCELERATE = actor->assetNodeCount / 3;
-	if (damageAccelerator && actor->graphNodeCount > ACTOR_MINIMUM_NODE_COUNT_TO_ACCELERATE)
+	if (shouldAccelerate(damageAccelerator, actor, damageAccelerator ? damageAccelerator->estimateBondCountOnPlane() : 0.0f))
 	{
 		const uint32_t CALLBACK_BUFFER_SIZE = 1000;
 
@@ -508,27 +903,25 @@ void NvBlastExtTriangleIntersectionGraphShader(NvBlastFractureBuffers* commandBu
 
 				for (uint32_t i = 0; i < count; i++)
 				{
+					// bonds of other actors are dropped by the callback's actor filter
 					const ExtDamageAcceleratorInternal::QueryBondData& bondData = bondBuffer[i];
-					if (m_actor->nodeActorIndices[bondData.node0] == m_actor->actorIndex)
+					if ((m_actor->familyBondHealths[bondData.bond] > 0.0f))
 					{
-						if ((m_actor->familyBondHealths[bondData.bond] > 0.0f))
+						const NvBlastBond& bond = m_actor->assetBonds[bondData.bond];
+						const uint32_t chunkIndex0 = m_actor->chunkIndices[bondData.node0];
+						const uint32_t chunkIndex1 = m_actor->chunkIndices[bondData.node1];
+						const physx::PxVec3& c0 = (reinterpret_cast<const physx::PxVec3&>(m_actor->assetChunks[chunkIndex0].centroid));
+						const PxVec3& normal = (reinterpret_cast<const PxVec3&>(bond.normal));
+						const PxVec3& bondCentroid = (reinterpret_cast<const PxVec3&>(bond.centroid));
+						const physx::PxVec3& c1 = isInvalidIndex(chunkIndex1) ? (c0 + normal * (bondCentroid - c0).dot(normal)) :
+							(reinterpret_cast<const physx::PxVec3&>(m_actor->assetChunks[chunkIndex1].centroid));
+
+						if(intersectSegmentTriangle(c0, c1, t0, t1, t2, trianglePlane))
 						{
-							const NvBlastBond& bond = m_actor->assetBonds[bondData.bond];
-							const uint32_t chunkIndex0 = m_actor->chunkIndices[bondData.node0];
-							const uint32_t chunkIndex1 = m_actor->chunkIndices[bondData.node1];
-							const physx::PxVec3& c0 = (reinterpret_cast<const physx::PxVec3&>(m_actor->assetChunks[chunkIndex0].centroid));
-							const PxVec3& normal = (reinterpret_cast<const PxVec3&>(bond.normal));
-							const PxVec3& bondCentroid = (reinterpret_cast<const PxVec3&>(bond.centroid));
-							const physx::PxVec3& c1 = isInvalidIndex(chunkIndex1) ? (c0 + normal * (bondCentroid - c0).dot(normal)) :
-								(reinterpret_cast<const physx::PxVec3&>(m_actor->assetChunks[chunkIndex1].centroid));
-
-							if(intersectSegmentTriangle(c0, c1, t0, t1, t2, trianglePlane))
-							{
-								NvBlastBondFractureData& outCommand = m_commandBuffers->bondFractures[m_outCount++];
-								outCommand.nodeIndex0 = bondData.node0;
-								outCommand.nodeIndex1 = bondData.node1;
-								outCommand.health = m_desc.damage;
-							}
+							NvBlastBondFractureData& outCommand = m_commandBuffers->bondFractures[m_outCount++];
+							outCommand.nodeIndex0 = bondData.node0;
+							outCommand.nodeIndex1 = bondData.node1;
+							outCommand.health = m_desc.damage;
 						}
 					}
 				}
@@ -544,6 +937,7 @@ void NvBlastExtTriangleIntersectionGraphShader(NvBlastFractureBuffers* commandBu
 		};
 
 		AcceleratorCallback cb(commandBuffers, outCount, actor, desc);
+		cb.setActorFilter(actor->nodeActorIndices, actor->actorIndex);
 
 		damageAccelerator->findBondSegmentsPlaneIntersected(trianglePlane, cb);
 	}
@@ -634,8 +1028,6 @@ void NvBlastExtImpactSpreadGraphShader(NvBlastFractureBuffers* commandBuffers, c
 	uint32_t bondFractureCountMax = commandBuffers->bondFractureCount;
 	const NvBlastExtProgramParams* programParams = static_cast<const NvBlastExtProgramParams*>(params);
 	const NvBlastExtImpactSpreadDamageDesc& desc = *static_cast<const NvBlastExtImpactSpreadDamageDesc*>(programParams->damageDesc);
-	const uint32_t* graphNodeIndexLinks = actor->graphNodeIndexLinks;
-	const uint32_t firstGraphNodeIndex = actor->firstGraphNodeIndex;
 	const uint32_t* chunkIndices = actor->chunkIndices;
 	const uint32_t*	adjacencyPartition = actor->adjacencyPartition;
 	const uint32_t*	adjacentNodeIndices = actor->adjacentNodeIndices;
@@ -643,14 +1035,10 @@ void NvBlastExtImpactSpreadGraphShader(NvBlastFractureBuffers* commandBuffers, c
 	const NvBlastBond* assetBonds = actor->assetBonds;
 	const NvBlastChunk* assetChunks = actor->assetChunks;
 	const float* familyBondHealths = actor->familyBondHealths;
-	const float* supportChunkHealths = actor->supportChunkHealths;
 
 	// Find nearest chunk. 
-	uint32_t closestNode = findClosestNode(desc.position
-		, firstGraphNodeIndex, graphNodeIndexLinks
-		, adjacencyPartition, adjacentNodeIndices, adjacentBondIndices
-		, assetBonds, familyBondHealths
-		, assetChunks, supportChunkHealths, chunkIndices);
+	ExtDamageAcceleratorInternal* damageAccelerator = programParams->accelerator ? static_cast<ExtDamageAcceleratorInternal*>(programParams->accelerator) : nullptr;
+	uint32_t closestNode = findClosestActorNode(damageAccelerator, actor, desc.position);
 
 	uint32_t nodeIndex = closestNode;
 
@@ -664,7 +1052,6 @@ void NvBlastExtImpactSpreadGraphShader(NvBlastFractureBuffers* commandBuffers, c
 	}
 
 	// Breadth-first support graph traversal. For radial falloff metric distance is measured along the edges of the graph
-	ExtDamageAcceleratorInternal* damageAccelerator = programParams->accelerator ? static_cast<ExtDamageAcceleratorInternal*>(programParams->accelerator) : nullptr;
 	NVBLAST_ASSERT_WITH_MESSAGE(damageAccelerator, "This shader requires damage accelerator passed");
 	if (damageAccelerator)
 	{
@@ -680,10 +1067,10 @@ void NvBlastExtImpactSpreadGraphShader(NvBlastFractureBuffers* commandBuffers, c
 		const size_t visitedBitmapSize = align16(FixedBitmap::requiredMemorySize(bondCount));
 		const size_t scratchSize = 16 + nodeQueueSize + visitedBitmapSize;
 
-		void* scratch = damageAccelerator->getImmediateScratch(scratchSize);
+		ExtDamageAcceleratorInternal::ScopedScratch scopedScratch(*damageAccelerator, scratchSize);
 
 		// prepare intermediate data on scratch
-		scratch = (void*)align16((size_t)scratch); // Bump to 16-byte alignment
+		void* scratch = (void*)align16((size_t)scopedScratch.get()); // Bump to 16-byte alignment
 		FixedQueue<NodeData>* nodeQueue = new (scratch)FixedQueue<NodeData>(actor->graphNodeCount);
 		scratch = pointerOffset(scratch, align16(nodeQueueSize));
 		FixedBitmap* visitedBitmap = new (scratch)FixedBitmap(bondCount);
@@ -761,3 +1148,360 @@ void NvBlastExtImpactSpreadSubgraphShader(NvBlastFractureBuffers* commandBuffers
 	commandBuffers->bondFractureCount = 0;
 	commandBuffers->chunkFractureCount = chunkFractureCount;
 }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Pattern Shader
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+A pattern placed in actor space by a NvBlastExtPatternDamageDesc. Segments are moved to pattern space rather than the
+pattern to actor space, so that the pattern's hierarchy can be shared by all instances.
+*/
+class PatternInstance
+{
+public:
+	PatternInstance(const NvBlastExtPatternDamageDesc& desc) :
+		m_pattern(*static_cast<const ExtDamagePatternImpl*>(desc.pattern)),
+		m_pose(reinterpret_cast<const PxVec3&>(desc.pose.p), reinterpret_cast<const PxQuat&>(desc.pose.q)),
+		m_scale(desc.scale)
+	{
+		NVBLAST_ASSERT(desc.scale > 0.0f);
+	}
+
+	PxBounds3 getActorBounds() const
+	{
+		const PxBounds3& bounds = m_pattern.getBounds();
+		if (bounds.isEmpty())
+		{
+			return bounds;
+		}
+		return PxBounds3::transformFast(m_pose, PxBounds3(bounds.minimum * m_scale, bounds.maximum * m_scale));
+	}
+
+	bool intersectsSegment(const PxVec3& c0, const PxVec3& c1) const
+	{
+		const float invScale = 1.0f / m_scale;
+		return m_pattern.intersectsSegment(m_pose.transformInv(c0) * invScale, m_pose.transformInv(c1) * invScale);
+	}
+
+private:
+	const ExtDamagePatternImpl&	m_pattern;
+	const PxTransform			m_pose;
+	const float					m_scale;
+};
+
+void NvBlastExtPatternGraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastGraphShaderActor* actor, const void* params)
+{
+	const uint32_t* graphNodeIndexLinks = actor->graphNodeIndexLinks;
+	const uint32_t firstGraphNodeIndex = actor->firstGraphNodeIndex;
+	const uint32_t*	adjacencyPartition = actor->adjacencyPartition;
+	const uint32_t*	adjacentNodeIndices = actor->adjacentNodeIndices;
+	const uint32_t*	adjacentBondIndices = actor->adjacentBondIndices;
+	const NvBlastBond* assetBonds = actor->assetBonds;
+	const NvBlastChunk* assetChunks = actor->assetChunks;
+	const uint32_t* chunkIndices = actor->chunkIndices;
+	const float* familyBondHealths = actor->familyBondHealths;
+	const NvBlastExtProgramParams* programParams = static_cast<const NvBlastExtProgramParams*>(params);
+	const NvBlastExtPatternDamageDesc& desc = *static_cast<const NvBlastExtPatternDamageDesc*>(programParams->damageDesc);
+	const PatternInstance pattern(desc);
+	const PxBounds3 bounds = pattern.getActorBounds();
+
+	uint32_t outCount = 0;
+
+	const ExtDamageAcceleratorInternal* damageAccelerator = programParams->accelerator ? static_cast<const ExtDamageAcceleratorInternal*>(programParams->accelerator) : nullptr;
+	if (bounds.isEmpty())
+	{
+		// empty pattern, no damage
+	}
+	else if (shouldAccelerate(damageAccelerator, actor, damageAccelerator ? damageAccelerator->estimateBondCountInBounds(bounds) : 0.0f))
+	{
+		const uint32_t CALLBACK_BUFFER_SIZE = 1000;
+
+		class AcceleratorCallback : public ExtDamageAcceleratorInternal::ResultCallback
+		{
+		public:
+			AcceleratorCallback(NvBlastFractureBuffers* commandBuffers, uint32_t& outCount, const NvBlastGraphShaderActor* actor, const NvBlastExtPatternDamageDesc& desc, const PatternInstance& pattern) :
+				ExtDamageAcceleratorInternal::ResultCallback(m_buffer, CALLBACK_BUFFER_SIZE),
+				m_actor(actor),
+				m_commandBuffers(commandBuffers),
+				m_outCount(outCount),
+				m_desc(desc),
+				m_pattern(pattern)
+			{
+			}
+
+			virtual void processResults(const ExtDamageAcceleratorInternal::QueryBondData* bondBuffer, uint32_t count) override
+			{
+				for (uint32_t i = 0; i < count; i++)
+				{
+					// bonds of other actors are dropped by the callback's actor filter
+					const ExtDamageAcceleratorInternal::QueryBondData& bondData = bondBuffer[i];
+					if ((m_actor->familyBondHealths[bondData.bond] > 0.0f))
+					{
+						const NvBlastBond& bond = m_actor->assetBonds[bondData.bond];
+						const uint32_t chunkIndex0 = m_actor->chunkIndices[bondData.node0];
+						const uint32_t chunkIndex1 = m_actor->chunkIndices[bondData.node1];
+						const physx::PxVec3& c0 = (reinterpret_cast<const physx::PxVec3&>(m_actor->assetChunks[chunkIndex0].centroid));
+						const PxVec3& normal = (reinterpret_cast<const PxVec3&>(bond.normal));
+						const PxVec3& bondCentroid = (reinterpret_cast<const PxVec3&>(bond.centroid));
+						const physx::PxVec3& c1 = isInvalidIndex(chunkIndex1) ? (c0 + normal * (bondCentroid - c0).dot(normal)) :
+							(reinterpret_cast<const physx::PxVec3&>(m_actor->assetChunks[chunkIndex1].centroid));
+
+						if (m_pattern.intersectsSegment(c0, c1))
+						{
+							NvBlastBondFractureData& outCommand = m_commandBuffers->bondFractures[m_outCount++];
+							outCommand.nodeIndex0 = bondData.node0;
+							outCommand.nodeIndex1 = bondData.node1;
+							outCommand.health = m_desc.damage;
+						}
+					}
+				}
+			}
+
+		private:
+			const NvBlastGraphShaderActor* m_actor;
+			NvBlastFractureBuffers* m_commandBuffers;
+			uint32_t& m_outCount;
+			const NvBlastExtPatternDamageDesc& m_desc;
+			const PatternInstance& m_pattern;
+
+			ExtDamageAcceleratorInternal::QueryBondData m_buffer[CALLBACK_BUFFER_SIZE];
+		};
+
+		AcceleratorCallback cb(commandBuffers, outCount, actor, desc, pattern);
+		cb.setActorFilter(actor->nodeActorIndices, actor->actorIndex);
+
+		damageAccelerator->findBondSegmentsInBounds(bounds, cb);
+	}
+	else
+	{
+		uint32_t currentNodeIndex = firstGraphNodeIndex;
+		while (!Nv::Blast::isInvalidIndex(currentNodeIndex))
+		{
+			for (uint32_t adj = adjacencyPartition[currentNodeIndex]; adj < adjacencyPartition[currentNodeIndex + 1]; adj++)
+			{
+				uint32_t adjacentNodeIndex = adjacentNodeIndices[adj];
+				if (currentNodeIndex < adjacentNodeIndex)
+				{
+					uint32_t bondIndex = adjacentBondIndices[adj];
+					if ((familyBondHealths[bondIndex] > 0.0f))
+					{
+						const NvBlastBond& bond = assetBonds[bondIndex];
+						const uint32_t chunkIndex0 = chunkIndices[currentNodeIndex];
+						const uint32_t chunkIndex1 = chunkIndices[adjacentNodeIndex];
+						const physx::PxVec3& c0 = (reinterpret_cast<const physx::PxVec3&>(assetChunks[chunkIndex0].centroid));
+						const PxVec3& normal = (reinterpret_cast<const PxVec3&>(bond.normal));
+						const PxVec3& bondCentroid = (reinterpret_cast<const PxVec3&>(bond.centroid));
+						const physx::PxVec3& c1 = isInvalidIndex(chunkIndex1) ? (c0 + normal * (bondCentroid - c0).dot(normal)) :
+							(reinterpret_cast<const physx::PxVec3&>(assetChunks[chunkIndex1].centroid));
+
+						if (pattern.intersectsSegment(c0, c1))
+						{
+							NvBlastBondFractureData& outCommand = commandBuffers->bondFractures[outCount++];
+							outCommand.nodeIndex0 = currentNodeIndex;
+							outCommand.nodeIndex1 = adjacentNodeIndex;
+							outCommand.health = desc.damage;
+						}
+					}
+				}
+			}
+			currentNodeIndex = graphNodeIndexLinks[currentNodeIndex];
+		}
+	}
+
+	commandBuffers->bondFractureCount = outCount;
+	commandBuffers->chunkFractureCount = 0;
+}
+
+void NvBlastExtPatternSubgraphShader(NvBlastFractureBuffers* commandBuffers, const NvBlastSubgraphShaderActor* actor, const void* params)
+{
+	uint32_t chunkFractureCount = 0;
+	uint32_t chunkFractureCountMax = commandBuffers->chunkFractureCount;
+	const uint32_t chunkIndex = actor->chunkIndex;
+	const NvBlastChunk* assetChunks = actor->assetChunks;
+	const NvBlastChunk& chunk = assetChunks[chunkIndex];
+	const NvBlastExtProgramParams* programParams = static_cast<const NvBlastExtProgramParams*>(params);
+	const NvBlastExtPatternDamageDesc& desc = *static_cast<const NvBlastExtPatternDamageDesc*>(programParams->damageDesc);
+	const PatternInstance pattern(desc);
+
+	for (uint32_t subChunkIndex = chunk.firstChildIndex; subChunkIndex + 1 < chunk.childIndexStop; subChunkIndex++)
+	{
+		const physx::PxVec3& c0 = (reinterpret_cast<const physx::PxVec3&>(assetChunks[subChunkIndex].centroid));
+		const physx::PxVec3& c1 = (reinterpret_cast<const physx::PxVec3&>(assetChunks[subChunkIndex + 1].centroid));
+		if (chunkFractureCount < chunkFractureCountMax && pattern.intersectsSegment(c0, c1))
+		{
+			NvBlastChunkFractureData& frac = commandBuffers->chunkFractures[chunkFractureCount++];
+			frac.chunkIndex = chunkIndex;
+			frac.health = desc.damage;
+			break;
+		}
+	}
+
+	commandBuffers->bondFractureCount = 0;
+	commandBuffers->chunkFractureCount = chunkFractureCount;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//												Damage Expressions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef float(*ShapeDistanceFunction)(const float pos[3], const NvBlastExtShapeDamageDesc& desc);
+
+float sphereDistance(const float pos[3], const NvBlastExtShapeDamageDesc& desc)
+{
+	return dist(pos, desc.position0);
+}
+
+float capsuleDistance(const float pos[3], const NvBlastExtShapeDamageDesc& desc)
+{
+	return distanceToSegment(pos, desc.position0, desc.position1);
+}
+
+float boxDistance(const float pos[3], const NvBlastExtShapeDamageDesc& desc)
+{
+	return distanceToBox(pos, desc.position0, desc.halfExtents, desc.rotation);
+}
+
+float coneDistance(const float pos[3], const NvBlastExtShapeDamageDesc& desc)
+{
+	return distanceToCone(pos, desc.position0, desc.position1, desc.angle, desc.maxRadius);
+}
+
+PxBounds3 shapeSphereBounds(const void* damageDesc)
+{
+	const NvBlastExtShapeDamageDesc& desc = *static_cast<const NvBlastExtShapeDamageDesc*>(damageDesc);
+	return PxBounds3::centerExtents(reinterpret_cast<const PxVec3&>(desc.position0), PxVec3(desc.maxRadius));
+}
+
+PxBounds3 shapeCapsuleBounds(const void* damageDesc)
+{
+	const NvBlastExtShapeDamageDesc& desc = *static_cast<const NvBlastExtShapeDamageDesc*>(damageDesc);
+	PxBounds3 b = PxBounds3::empty();
+	b.include(reinterpret_cast<const PxVec3&>(desc.position0));
+	b.include(reinterpret_cast<const PxVec3&>(desc.position1));
+	b.fattenFast(desc.maxRadius);
+	return b;
+}
+
+PxBounds3 shapeBoxBounds(const void* damageDesc)
+{
+	const NvBlastExtShapeDamageDesc& desc = *static_cast<const NvBlastExtShapeDamageDesc*>(damageDesc);
+	return orientedBoxBounds(desc.position0, desc.halfExtents, desc.rotation, desc.maxRadius);
+}
+
+PxBounds3 shapeConeBounds(const void* damageDesc)
+{
+	const NvBlastExtShapeDamageDesc& desc = *static_cast<const NvBlastExtShapeDamageDesc*>(damageDesc);
+	return solidConeBounds(desc.position0, desc.position1, desc.angle, desc.maxRadius);
+}
+
+template <ShapeDistanceFunction distanceFn, ProfileFunction profileFn>
+float shapeDamage(const float pos[3], const void* damageDesc)
+{
+	const NvBlastExtShapeDamageDesc& desc = *static_cast<const NvBlastExtShapeDamageDesc*>(damageDesc);
+	return profileFn(desc.minRadius, desc.maxRadius, distanceFn(pos, desc), desc.damage);
+}
+
+template <ShapeDistanceFunction distanceFn>
+float shapeCurveDamage(const float pos[3], const void* damageDesc)
+{
+	const NvBlastExtShapeDamageDesc& desc = *static_cast<const NvBlastExtShapeDamageDesc*>(damageDesc);
+	const float x = distanceFn(pos, desc);
+	if (x > desc.maxRadius) return 0.0f;
+
+	// the program's expression is validated by NvBlastExtDamageExpressionCompile, stacked descs may use another one
+	const NvBlastExtDamageExpression* expression = desc.expression;
+	if (expression == nullptr || expression->curveSize == 0 || expression->curveSize > NVBLASTEXT_DAMAGE_CURVE_MAX_SIZE) return 0.0f;
+
+	const float* curve = expression->curve;
+	const uint32_t last = expression->curveSize - 1;
+	if (x <= desc.minRadius || last == 0) return curve[0] * desc.damage;
+
+	const float s = (x - desc.minRadius) / (desc.maxRadius - desc.minRadius) * last;
+	const uint32_t i = PxMin(static_cast<uint32_t>(s), last - 1);
+	const float y = curve[i] + (curve[i + 1] - curve[i]) * (s - i);
+	return y * desc.damage;
+}
+
+/**
+Filters of each desc's expression, descs without expression do no damage.
+*/
+float expressionFilter(float damage, const float* normal, const void* damageDesc, const NvBlastExtProgramParams* programParams)
+{
+	const NvBlastExtDamageExpression* descExpression = static_cast<const NvBlastExtShapeDamageDesc*>(damageDesc)->expression;
+	if (descExpression == nullptr)
+	{
+		return 0.0f;
+	}
+	const NvBlastExtDamageExpression& expression = *descExpression;
+
+	if (normal != nullptr && PxAbs(dot(normal, expression.normal)) < expression.minNormalDot * length(expression.normal))
+	{
+		return 0.0f;
+	}
+
+	if (expression.useMaterial && programParams->material != nullptr)
+	{
+		return static_cast<const NvBlastExtMaterial*>(programParams->material)->getNormalizedDamage(damage);
+	}
+
+	return damage;
+}
+
+/**
+The filters are read from each desc, so they always run: descs compiled from an expression without filters may be
+stacked with descs of an expression with filters.
+*/
+template <DamageFunction damageFn, BoundFunction boundsFn>
+void setExpressionProgram(NvBlastDamageProgram& program)
+{
+	program.graphShaderFunction = RadialProfileGraphShader<damageFn, boundsFn, NvBlastExtShapeDamageDesc, expressionFilter>;
+	program.subgraphShaderFunction = RadialProfileSubgraphShader<damageFn, NvBlastExtShapeDamageDesc, expressionFilter>;
+}
+
+template <ShapeDistanceFunction distanceFn, BoundFunction boundsFn>
+void setShapeExpressionProgram(NvBlastDamageProgram& program, const NvBlastExtDamageExpression& expression)
+{
+	switch (expression.profile)
+	{
+	case NvBlastExtDamageProfile::FALLOFF:
+		setExpressionProgram<shapeDamage<distanceFn, falloffProfile>, boundsFn>(program);
+		break;
+	case NvBlastExtDamageProfile::CUTTER:
+		setExpressionProgram<shapeDamage<distanceFn, cutterProfile>, boundsFn>(program);
+		break;
+	case NvBlastExtDamageProfile::CURVE:
+		setExpressionProgram<shapeCurveDamage<distanceFn>, boundsFn>(program);
+		break;
+	}
+}
+
+bool NvBlastExtDamageExpressionCompile(NvBlastDamageProgram* program, const NvBlastExtDamageExpression* expression)
+{
+	NVBLAST_CHECK_ERROR(program != nullptr, "NvBlastExtDamageExpressionCompile: NULL program pointer input.", return false);
+	NVBLAST_CHECK_ERROR(expression != nullptr, "NvBlastExtDamageExpressionCompile: NULL expression pointer input.", return false);
+	NVBLAST_CHECK_ERROR(expression->shape <= NvBlastExtDamageShape::CONE, "NvBlastExtDamageExpressionCompile: invalid shape.", return false);
+	NVBLAST_CHECK_ERROR(expression->profile <= NvBlastExtDamageProfile::CURVE, "NvBlastExtDamageExpressionCompile: invalid profile.", return false);
+	NVBLAST_CHECK_ERROR(expression->profile != NvBlastExtDamageProfile::CURVE || (expression->curveSize > 0 && expression->curveSize <= NVBLASTEXT_DAMAGE_CURVE_MAX_SIZE),
+		"NvBlastExtDamageExpressionCompile: curve profile needs 1 to NVBLASTEXT_DAMAGE_CURVE_MAX_SIZE samples.", return false);
+
+	switch (expression->shape)
+	{
+	case NvBlastExtDamageShape::SPHERE:
+		setShapeExpressionProgram<sphereDistance, shapeSphereBounds>(*program, *expression);
+		break;
+	case NvBlastExtDamageShape::CAPSULE:
+		setShapeExpressionProgram<capsuleDistance, shapeCapsuleBounds>(*program, *expression);
+		break;
+	case NvBlastExtDamageShape::BOX:
+		setShapeExpressionProgram<boxDistance, shapeBoxBounds>(*program, *expression);
+		break;
+	case NvBlastExtDamageShape::CONE:
+		setShapeExpressionProgram<coneDistance, shapeConeBounds>(*program, *expression);
+		break;
+	}
+
+	return true;
+}
@@ -39,6 +39,47 @@ namespace Blast
 {
 
 
+/**
+Stress Solver Dispatcher
+
+Runs stress solver work concurrently, typically on a task system or thread pool owned by the user. 
+Set it in ExtStressSolverSettings to enable parallel solving.
+*/
+class ExtStressSolverDispatcher
+{
+public:
+	/**
+	Job function to be called by the dispatcher.
+
+	\param[in]	jobData		The data passed to parallelFor().
+	\param[in]	jobIndex	The index of the job, in the range [0, jobCount).
+	*/
+	typedef void (*JobFunction)(void* jobData, uint32_t jobIndex);
+
+	/**
+	Call job(jobData, jobIndex) once for every jobIndex in [0, jobCount), possibly concurrently, and return once all the calls have completed.
+
+	\param[in]	jobCount	The number of jobs to run.
+	\param[in]	job			The job function.
+	\param[in]	jobData		The data to pass to every job function call.
+	*/
+	virtual void	parallelFor(uint32_t jobCount, JobFunction job, void* jobData) = 0;
+};
+
+
+/**
+Stress solver backend, set in ExtStressSolverSettings.
+*/
+struct ExtStressSolverType
+{
+	enum Enum
+	{
+		IMPULSE,			//!< iterative impulse solver, stress propagates a few bonds per iteration and converges over several frames with warm starting
+		CONJUGATE_GRADIENT,	//!< preconditioned conjugate gradient, converges on the whole graph within a frame in much fewer iterations, each iteration costing a few impulse iterations
+	};
+};
+
+
 /**
 Stress Solver Settings
 
@@ -52,6 +93,24 @@ stressLinearFactor, stressAngularFactor, hardness = multiplier parameters set by
 Support graph reduction:
 graphReductionLevel is the number of node merge passes.  The resulting graph will be
 roughly 2^graphReductionLevel times smaller than the original.
+
+Parallel solving:
+Large solver graphs have their bonds colored such that no two bonds of the same color share a node, and are solved
+4 bonds at a time with SIMD. Each solver iteration processes the colors in sequence. When a dispatcher is set, the bonds
+of one color are processed in parallel batches through it. Graphs with fewer than minBatchedBondCount solver bonds are
+solved bond by bond. Both ways solve the same constraints in a different order and converge to the same stress.
+
+Solver type:
+The impulse solver is cheap per iteration but needs many of them for stress to travel through tall structures.
+The conjugate gradient solver solves the same bond constraints as a linear system and reaches an accurate solution
+in a number of iterations which grows much slower with the graph size. It doesn't use the dispatcher.
+Both use getIterationsPerFrame() iterations per frame.
+
+Sleeping:
+With sleepThreshold > 0, once the solver error per bond gets below it the solver goes to sleep. update() then skips 
+solving, keeping the last bond stress, until the support graph changes (bonds broken, node info set) or the velocity 
+change due to the forces applied on a node differs from the last solved frame by more than sleepThreshold. 
+Forces applied every frame (e.g. gravity) must thus be applied again for the solver to stay asleep.
 */
 struct ExtStressSolverSettings
 {
@@ -60,13 +119,21 @@ struct ExtStressSolverSettings
 	float		stressAngularFactor;		//!<	angular stress on bond multiplier
 	uint32_t	bondIterationsPerFrame;		//!<	number of bond iterations to perform per frame, @see getIterationsPerFrame() below
 	uint32_t	graphReductionLevel;		//!<	graph reduction level
+	ExtStressSolverDispatcher*	dispatcher;	//!<	dispatcher to solve in parallel with, NULL to solve sequentially on the calling thread
+	ExtStressSolverType::Enum	solverType;	//!<	solver backend
+	float		sleepThreshold;				//!<	velocity error per bond and applied velocity change under which the solver sleeps, 0 to never sleep
+	uint32_t	minBatchedBondCount;		//!<	solver bond count from which the impulse solver solves bonds in SIMD batches
 
 	ExtStressSolverSettings() :
 		hardness(1000.0f),
 		stressLinearFactor(0.25f),
 		stressAngularFactor(0.75f),
 		bondIterationsPerFrame(18000),
-		graphReductionLevel(3)
+		graphReductionLevel(3),
+		dispatcher(nullptr),
+		solverType(ExtStressSolverType::IMPULSE),
+		sleepThreshold(0.0f),
+		minBatchedBondCount(1024)
 	{}
 };
 
@@ -100,6 +167,9 @@ Basic usage:
 4. Every frame: Apply forces (there are different functions for it see @addForce)
 5. Every frame: Call update() for actual solver to process.
 6. If getOverstressedBondCount() > 0 use generateFractureCommands() functions to get FractureCommands with bonds fractured
+
+update() keeps a list of the bonds to fracture, generateFractureCommands() functions only go through it, their cost 
+is proportional to the number of overstressed bonds and not to the family's bond count.
 */
 class NV_DLL_EXPORT ExtStressSolver
 {
@@ -228,9 +298,26 @@ public:
 	Update stress solver.
 
 	Actual performance heavy stress calculation happens there. Call it after all relevant forces were applied, usually every frame.
+	Same as calling prepareUpdate() then solveUpdate().
 	*/
 	virtual void							update() = 0;
 
+	/**
+	First part of update(), syncs the solver with the family and takes the forces applied so far as the ones to solve.
+
+	Call it on the thread which damages the family.
+	*/
+	virtual void							prepareUpdate() = 0;
+
+	/**
+	Second part of update(), the performance heavy stress calculation on the forces taken by prepareUpdate().
+
+	Can be called on another thread. Until it returns, forces can be applied (they will be solved by the next update), 
+	and the family can be damaged, but no other function of this solver may be called and actors must not be notified as 
+	created or destroyed.
+	*/
+	virtual void							solveUpdate() = 0;
+
 	/**
 	Get overstressed/broken bonds count. 
 	
@@ -240,6 +327,24 @@ public:
 	*/
 	virtual uint32_t						getOverstressedBondCount() const = 0;
 
+	/**
+	Get the stress of a bond as of the last update(), the one compared to the bond's health to fracture it.
+	Bonds internal to a solver node (see graphReductionLevel) carry no stress.
+
+	\param[in]	bondIndex		The bond index in the asset.
+
+	\return the bond stress, 0 if the bond is broken or internal.
+	*/
+	virtual float							getBondStress(uint32_t bondIndex) const = 0;
+
+	/**
+	Whether the solver is sleeping, i.e. the last update() left the error below the sleep threshold and the next update()
+	won't solve unless forces or the support graph change. @see ExtStressSolverSettings::sleepThreshold
+
+	\return true if the solver is sleeping.
+	*/
+	virtual bool							isSleeping() const = 0;
+
 	/**
 	Generate fracture commands for particular actor.
 
@@ -295,14 +400,14 @@ public:
 	/**
 	Get stress solver linear error.
 
-	\return the total linear error of stress calculation.
+	\return the total linear error of stress calculation, the sum of the bonds' linear velocity residuals after the last update().
 	*/
 	virtual float							getStressErrorLinear() const = 0;
 
 	/**
 	Get stress solver angular error.
 
-	\return the total angular error of stress calculation.
+	\return the total angular error of stress calculation, the sum of the bonds' angular velocity residuals after the last update().
 	*/
 	virtual float							getStressErrorAngular() const = 0;
 
@@ -402,6 +507,119 @@ public:
 
 };
 
+
+/**
+Stress Solver Batch.
+
+Updates many stress solvers at once, typically one per small destructible structure. Solvers keep their own family, 
+settings and fracture commands, the batch replaces the per solver update() calls:
+1. Create stress solvers as usual and add them to the batch.
+2. Every frame: Apply forces on every solver.
+3. Every frame: Call update() on the batch instead of on every solver.
+4. Use every solver's getOverstressedBondCount() and generateFractureCommands() functions as usual, or 
+getOverstressedSolvers() to only go through the solvers with overstressed bonds.
+
+Solvers graphs are synced on the calling thread, then all the solvers are solved in one dispatch, small solvers being 
+grouped into jobs. Solvers don't use the dispatcher set in their settings when updated through the batch.
+Remove a solver from the batch before releasing it.
+
+Iteration budget:
+With a budget set, the batch shares a number of bond iterations across its solvers such that update() takes about
+the budget time. The cost of a bond iteration is measured on previous updates. Every solver gets at least one iteration,
+the rest is shared according to the solver's error relative to the other solvers, its weight (e.g. visibility or 
+importance), and recent support graph changes. ExtStressSolverSettings::bondIterationsPerFrame becomes the upper limit of
+every solver. Sleeping solvers get the minimum.
+*/
+class NV_DLL_EXPORT ExtStressSolverBatch
+{
+public:
+	/**
+	Create a new ExtStressSolverBatch.
+
+	\param[in]	dispatcher		The dispatcher to solve the solvers in parallel with, NULL to solve them on the calling thread.
+
+	\return the new ExtStressSolverBatch if successful, NULL otherwise.
+	*/
+	static ExtStressSolverBatch*			create(ExtStressSolverDispatcher* dispatcher = nullptr);
+
+	/**
+	Release this batch. The solvers are not released.
+	*/
+	virtual void							release() = 0;
+
+	/**
+	Set the dispatcher to solve the solvers in parallel with.
+
+	\param[in]	dispatcher		The dispatcher, NULL to solve on the calling thread.
+	*/
+	virtual void							setDispatcher(ExtStressSolverDispatcher* dispatcher) = 0;
+
+	/**
+	Add a solver to the batch.
+
+	\param[in]	solver			The solver to add, it must be created with ExtStressSolver::create().
+
+	\return true if added, false if it was already in the batch.
+	*/
+	virtual bool							addSolver(ExtStressSolver& solver) = 0;
+
+	/**
+	Remove a solver from the batch.
+
+	\param[in]	solver			The solver to remove.
+
+	\return true if removed, false if it wasn't in the batch.
+	*/
+	virtual bool							removeSolver(ExtStressSolver& solver) = 0;
+
+	/**
+	\return the number of solvers in the batch.
+	*/
+	virtual uint32_t						getSolverCount() const = 0;
+
+	/**
+	Update every solver of the batch, same as calling update() on each of them.
+	*/
+	virtual void							update() = 0;
+
+	/**
+	Get the solvers with overstressed bonds after the last update().
+
+	\param[out]	buffer			A user-supplied array of ExtStressSolver pointers to fill.
+	\param[in]		bufferSize		The number of elements available to write into buffer.
+
+	\return the number of solvers written to the buffer.
+	*/
+	virtual uint32_t						getOverstressedSolvers(ExtStressSolver** buffer, uint32_t bufferSize) const = 0;
+
+	/**
+	Set the time budget of update().
+
+	\param[in]	microseconds	The budget in microseconds, 0 to let every solver use its settings' bondIterationsPerFrame.
+	*/
+	virtual void							setBudget(float microseconds) = 0;
+
+	/**
+	\return the time budget of update() in microseconds, 0 if disabled.
+	*/
+	virtual float							getBudget() const = 0;
+
+	/**
+	Set the weight of a solver in the iteration budget sharing. @see setBudget()
+
+	\param[in]	solver			The solver, it must be in the batch.
+	\param[in]	weight			The weight, default is 1. With 0 the solver only gets the minimum.
+
+	\return true if set, false if the solver isn't in the batch.
+	*/
+	virtual bool							setSolverWeight(ExtStressSolver& solver, float weight) = 0;
+
+	/**
+	\return the total number of bond iterations scheduled by the last update().
+	*/
+	virtual uint32_t						getBondIterationsPerFrame() const = 0;
+};
+
 } // namespace Blast
 } // namespace Nv
 
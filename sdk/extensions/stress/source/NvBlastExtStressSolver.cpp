@@ -34,6 +34,7 @@
 #include "NvBlastHashSet.h"
 #include "NvBlastAssert.h"
 #include "NvBlastIndexFns.h"
+#include "NvBlastTime.h"
 
 #include <PsVecMath.h>
 #include "PsFPU.h"
@@ -43,6 +44,15 @@
 
 #define USE_SCALAR_IMPL 0
 #define WARM_START 1
+#define CG_RELATIVE_TOLERANCE 1e-4f
+
+// ExtStressSolverBatch iteration budget tuning, costs in microseconds per bond iteration
+#define INITIAL_COST_PER_BOND_ITERATION 0.01f
+#define MIN_COST_PER_BOND_ITERATION 1e-4f
+#define COST_SMOOTHING 0.1f
+#define MAX_RELATIVE_ERROR 4.0f
+#define STRUCTURE_CHANGE_PRIORITY 4.0f
+#define STRUCTURE_CHANGE_DECAY 0.5f
 #define GRAPH_INTERGRIRY_CHECK 0
 
 #if GRAPH_INTERGRIRY_CHECK
@@ -87,7 +97,7 @@ public:
 	}
 	PX_ALIGN_SUFFIX(16);
 
-	SequentialImpulseSolver(uint32_t nodeCount, uint32_t maxBondCount)
+	SequentialImpulseSolver(uint32_t nodeCount, uint32_t maxBondCount) : m_errorLinear(0.0f), m_errorAngular(0.0f), m_colorsDirty(true)
 	{
 		m_nodesData.resize(nodeCount);
 		m_bondsData.reserve(maxBondCount);
@@ -117,6 +127,7 @@ public:
 	{
 		m_nodesData[node].invMass = invMass;
 		m_nodesData[node].invI = invI;
+		m_colorsDirty = true;
 	}
 
 	void initialize()
@@ -145,52 +156,223 @@ public:
 			1.0f / offset.magnitudeSquared() 
 		};
 		m_bondsData.pushBack(data);
+		m_colorsDirty = true;
 		return m_bondsData.size() - 1;
 	}
 
+	uint32_t addNode(float invMass, float invI)
+	{
+		m_nodesData.pushBack(NodeData());
+		m_nodesData.back().velocityLinear = PxVec3(PxZero);
+		m_nodesData.back().velocityAngular = PxVec3(PxZero);
+		setNodeMassInfo(m_nodesData.size() - 1, invMass, invI);
+		return m_nodesData.size() - 1;
+	}
+
 	void replaceWithLast(uint32_t bondIndex)
 	{
 		m_bondsData.replaceWithLast(bondIndex);
+		m_colorsDirty = true;
 	}
 
 	void reset(uint32_t nodeCount)
 	{
 		m_bondsData.clear();
 		m_nodesData.resize(nodeCount);
+		m_colorsDirty = true;
 	}
 
 	void clearBonds()
 	{
 		m_bondsData.clear();
+		m_colorsDirty = true;
 	}
 
-	void solve(uint32_t iterationCount, bool warmStart = true)
+	/**
+	Gauss-Seidel iterations on the bond impulses, in SIMD batches of bonds from minBatchedBondCount bonds, bond by bond below.
+	*/
+	void solve(uint32_t iterationCount, bool warmStart, ExtStressSolverDispatcher* dispatcher, uint32_t minBatchedBondCount)
 	{
 		solveInit(warmStart);
 
-		for (uint32_t i = 0; i < iterationCount; ++i)
+		m_errorLinear = 0.0f;
+		m_errorAngular = 0.0f;
+
+		if (m_bondsData.size() >= minBatchedBondCount)
+		{
+			if (m_colorsDirty)
+			{
+				colorBonds();
+			}
+
+			packImpulses();
+			for (uint32_t i = 0; i < iterationCount; ++i)
+			{
+				if (i + 1 < iterationCount)
+				{
+					iterateBatched<false>(dispatcher);
+				}
+				else
+				{
+					iterateBatched<true>(dispatcher);
+				}
+			}
+			unpackImpulses();
+		}
+		else
 		{
-			iterate();
+			for (uint32_t i = 0; i < iterationCount; ++i)
+			{
+				if (i + 1 < iterationCount)
+				{
+					iterate<false>();
+				}
+				else
+				{
+					iterate<true>();
+				}
+			}
 		}
 	}
 
+	/**
+	The error of the last solve() call, measured on every bond during the last iteration, or the bonds' velocity error after the last 
+	solveConjugateGradient() call.
+	*/
 	void calcError(float& linear, float& angular)
 	{
-		linear = 0.0f;
-		angular = 0.0f;
-		for (BondData& bond : m_bondsData)
+		linear = m_errorLinear;
+		angular = m_errorAngular;
+	}
+
+	/**
+	Alternative to solve(): preconditioned conjugate gradient on the bond impulses.
+
+	Impulses are applied to the nodes the same way as in solve(), the angular velocity change due to a linear impulse being
+	scaled by the node's inverse mass and the bond's inverse offset length squared. Written M^-1 * G^T, G is the bonds' 
+	velocity error J with its angular terms scaled by invMass / invI / offsetLength^2 (see symmetricVelocityError()), and 
+	G * M^-1 * G^T * impulses = -G * velocities is solved, which is symmetric. Where the bonds fully determine the node 
+	velocities, both G * v = 0 and J * v = 0 mean that the nodes don't move relative to each other, so the impulses match 
+	the ones solve() converges to. Jacobi preconditioned.
+	Stops early once the residual got below CG_RELATIVE_TOLERANCE of the initial one. The error is measured with J, as in solve().
+	*/
+	void solveConjugateGradient(uint32_t iterationCount, bool warmStart = true)
+	{
+		const uint32_t bondCount = m_bondsData.size();
+		const uint32_t nodeCount = m_nodesData.size();
+		m_cgBonds.resize(bondCount);
+		m_cgNodes.resize(nodeCount);
+
+		if (warmStart)
+		{
+			for (uint32_t i = 0; i < bondCount; ++i)
+			{
+				m_cgBonds[i].directionLinear = m_bondsData[i].impulseLinear;
+				m_cgBonds[i].directionAngular = m_bondsData[i].impulseAngular;
+			}
+			applyDirections();
+			for (uint32_t i = 0; i < nodeCount; ++i)
+			{
+				m_nodesData[i].velocityLinear += m_cgNodes[i].velocityLinear;
+				m_nodesData[i].velocityAngular += m_cgNodes[i].velocityAngular;
+			}
+		}
+		else
+		{
+			for (BondData& bond : m_bondsData)
+			{
+				bond.impulseLinear = PxVec3(PxZero);
+				bond.impulseAngular = PxVec3(PxZero);
+			}
+		}
+
+		// residual r = -G * v, direction p = P * r
+		float rz = 0.0f;
+		for (uint32_t i = 0; i < bondCount; ++i)
 		{
-			NodeData* node0 = &m_nodesData[bond.node0];
-			NodeData* node1 = &m_nodesData[bond.node1];
+			const BondData& bond = m_bondsData[i];
+			const NodeData& node0 = m_nodesData[bond.node0];
+			const NodeData& node1 = m_nodesData[bond.node1];
+			ConjugateGradientBond& cg = m_cgBonds[i];
+
+			// linear diagonal: invMass0 + invMass1 + sum over nodes of invI * (invMass / invI / offsetLength^2)^2 * (offsetLength^2 - offset^2)
+			const float invMassSum = node0.invMass + node1.invMass;
+			const float invISum = node0.invI + node1.invI;
+			const float torqueWeight = (node0.invMass * angularCoupling(node0) + node1.invMass * angularCoupling(node1)) * bond.invOffsetSqrLength * bond.invOffsetSqrLength;
+			const PxVec3 diagonal = PxVec3(invMassSum) + (PxVec3(bond.offset0.magnitudeSquared()) - bond.offset0.multiply(bond.offset0)) * torqueWeight;
+			cg.preconditionerLinear = PxVec3(invDiagonal(diagonal.x), invDiagonal(diagonal.y), invDiagonal(diagonal.z));
+			cg.preconditionerAngular = invDiagonal(invISum);
+
+			symmetricVelocityError(bond, node0, node1, node0.velocityLinear, node0.velocityAngular, node1.velocityLinear, node1.velocityAngular, cg.residualLinear, cg.residualAngular);
+			cg.residualLinear = -cg.residualLinear;
+			cg.residualAngular = -cg.residualAngular;
+
+			cg.directionLinear = cg.residualLinear.multiply(cg.preconditionerLinear);
+			cg.directionAngular = cg.residualAngular * cg.preconditionerAngular;
+			rz += cg.residualLinear.dot(cg.directionLinear) + cg.residualAngular.dot(cg.directionAngular);
+		}
 
-			const PxVec3 vA = node0->velocityLinear - node0->velocityAngular.cross(bond.offset0);
-			const PxVec3 vB = node1->velocityLinear + node1->velocityAngular.cross(bond.offset0);
+		const float tolerance = rz * CG_RELATIVE_TOLERANCE * CG_RELATIVE_TOLERANCE;
+		for (uint32_t k = 0; k < iterationCount && rz > tolerance; ++k)
+		{
+			// q = A * p, the node velocity changes due to p are kept in m_cgNodes
+			applyDirections();
+			float pq = 0.0f;
+			for (uint32_t i = 0; i < bondCount; ++i)
+			{
+				const BondData& bond = m_bondsData[i];
+				const NodeVelocities& delta0 = m_cgNodes[bond.node0];
+				const NodeVelocities& delta1 = m_cgNodes[bond.node1];
+				ConjugateGradientBond& cg = m_cgBonds[i];
 
-			const PxVec3 vErrorLinear = vA - vB;
-			const PxVec3 vErrorAngular = node0->velocityAngular - node1->velocityAngular;
+				symmetricVelocityError(bond, m_nodesData[bond.node0], m_nodesData[bond.node1], delta0.velocityLinear, delta0.velocityAngular, delta1.velocityLinear, delta1.velocityAngular, cg.productLinear, cg.productAngular);
+				pq += cg.directionLinear.dot(cg.productLinear) + cg.directionAngular.dot(cg.productAngular);
+			}
 
-			linear += vErrorLinear.magnitude();
-			angular += vErrorAngular.magnitude();
+			if (!(pq > 0.0f))
+			{
+				break;
+			}
+
+			const float alpha = rz / pq;
+			float rzNext = 0.0f;
+			for (uint32_t i = 0; i < bondCount; ++i)
+			{
+				BondData& bond = m_bondsData[i];
+				ConjugateGradientBond& cg = m_cgBonds[i];
+
+				bond.impulseLinear += cg.directionLinear * alpha;
+				bond.impulseAngular += cg.directionAngular * alpha;
+				cg.residualLinear -= cg.productLinear * alpha;
+				cg.residualAngular -= cg.productAngular * alpha;
+				rzNext += cg.residualLinear.dot(cg.residualLinear.multiply(cg.preconditionerLinear)) + cg.residualAngular.magnitudeSquared() * cg.preconditionerAngular;
+			}
+
+			for (uint32_t i = 0; i < nodeCount; ++i)
+			{
+				m_nodesData[i].velocityLinear += m_cgNodes[i].velocityLinear * alpha;
+				m_nodesData[i].velocityAngular += m_cgNodes[i].velocityAngular * alpha;
+			}
+
+			const float beta = rzNext / rz;
+			for (ConjugateGradientBond& cg : m_cgBonds)
+			{
+				cg.directionLinear = cg.residualLinear.multiply(cg.preconditionerLinear) + cg.directionLinear * beta;
+				cg.directionAngular = cg.residualAngular * cg.preconditionerAngular + cg.directionAngular * beta;
+			}
+			rz = rzNext;
+		}
+
+		m_errorLinear = 0.0f;
+		m_errorAngular = 0.0f;
+		for (const BondData& bond : m_bondsData)
+		{
+			const NodeData& node0 = m_nodesData[bond.node0];
+			const NodeData& node1 = m_nodesData[bond.node1];
+			PxVec3 errorLinear, errorAngular;
+			velocityError(bond, node0.velocityLinear, node0.velocityAngular, node1.velocityLinear, node1.velocityAngular, errorLinear, errorAngular);
+			m_errorLinear += errorLinear.magnitude();
+			m_errorAngular += errorAngular.magnitude();
 		}
 	}
 
@@ -228,87 +410,597 @@ private:
 	}
 
 
+	template<bool ComputeError>
 	void iterate()
 	{
-		using namespace physx::shdfnd::aos;
-
 		for (BondData& bond : m_bondsData)
 		{
-			NodeData* node0 = &m_nodesData[bond.node0];
-			NodeData* node1 = &m_nodesData[bond.node1];
+			solveBond<ComputeError>(bond);
+		}
+	}
+
+	/**
+	Gauss-Seidel step on one bond. With ComputeError, the bond's velocity error before the step is added to the solver error.
+	*/
+	template<bool ComputeError>
+	NV_FORCE_INLINE void solveBond(BondData& bond)
+	{
+		using namespace physx::shdfnd::aos;
+
+		NodeData* node0 = &m_nodesData[bond.node0];
+		NodeData* node1 = &m_nodesData[bond.node1];
 
 #if USE_SCALAR_IMPL
-			const PxVec3 vA = node0->velocityLinear - node0->velocityAngular.cross(bond.offset0);
-			const PxVec3 vB = node1->velocityLinear + node1->velocityAngular.cross(bond.offset0);
+		const PxVec3 vA = node0->velocityLinear - node0->velocityAngular.cross(bond.offset0);
+		const PxVec3 vB = node1->velocityLinear + node1->velocityAngular.cross(bond.offset0);
+
+		const PxVec3 vErrorLinear = vA - vB;
+		const PxVec3 vErrorAngular = node0->velocityAngular - node1->velocityAngular;
 
-			const PxVec3 vErrorLinear = vA - vB;
-			const PxVec3 vErrorAngular = node0->velocityAngular - node1->velocityAngular;
+		if (ComputeError)
+		{
+			m_errorLinear += vErrorLinear.magnitude();
+			m_errorAngular += vErrorAngular.magnitude();
+		}
 
-			const float weightedMass = 1.0f / (node0->invMass + node1->invMass);
-			const float weightedInertia = 1.0f / (node0->invI + node1->invI);
+		const float weightedMass = 1.0f / (node0->invMass + node1->invMass);
+		const float weightedInertia = 1.0f / (node0->invI + node1->invI);
 
-			const PxVec3 outImpulseLinear = -vErrorLinear * weightedMass * 0.5f;
-			const PxVec3 outImpulseAngular = -vErrorAngular * weightedInertia * 0.5f;
+		const PxVec3 outImpulseLinear = -vErrorLinear * weightedMass * 0.5f;
+		const PxVec3 outImpulseAngular = -vErrorAngular * weightedInertia * 0.5f;
 
-			bond.impulseLinear += outImpulseLinear;
-			bond.impulseAngular += outImpulseAngular;
+		bond.impulseLinear += outImpulseLinear;
+		bond.impulseAngular += outImpulseAngular;
 
-			const PxVec3 velocityLinearCorr0 = outImpulseLinear * node0->invMass;
-			const PxVec3 velocityLinearCorr1 = outImpulseLinear * node1->invMass;
+		const PxVec3 velocityLinearCorr0 = outImpulseLinear * node0->invMass;
+		const PxVec3 velocityLinearCorr1 = outImpulseLinear * node1->invMass;
 
-			const PxVec3 velocityAngularCorr0 = outImpulseAngular * node0->invI - bond.offset0.cross(velocityLinearCorr0) * bond.invOffsetSqrLength;
-			const PxVec3 velocityAngularCorr1 = outImpulseAngular * node1->invI + bond.offset0.cross(velocityLinearCorr1) * bond.invOffsetSqrLength;
+		const PxVec3 velocityAngularCorr0 = outImpulseAngular * node0->invI - bond.offset0.cross(velocityLinearCorr0) * bond.invOffsetSqrLength;
+		const PxVec3 velocityAngularCorr1 = outImpulseAngular * node1->invI + bond.offset0.cross(velocityLinearCorr1) * bond.invOffsetSqrLength;
 
-			node0->velocityLinear += velocityLinearCorr0;
-			node1->velocityLinear -= velocityLinearCorr1;
+		node0->velocityLinear += velocityLinearCorr0;
+		node1->velocityLinear -= velocityLinearCorr1;
 
-			node0->velocityAngular += velocityAngularCorr0;
-			node1->velocityAngular -= velocityAngularCorr1;
+		node0->velocityAngular += velocityAngularCorr0;
+		node1->velocityAngular -= velocityAngularCorr1;
 #else
-			const Vec3V velocityLinear0 = V3LoadUnsafeA(node0->velocityLinear);
-			const Vec3V velocityLinear1 = V3LoadUnsafeA(node1->velocityLinear);
-			const Vec3V velocityAngular0 = V3LoadUnsafeA(node0->velocityAngular);
-			const Vec3V velocityAngular1 = V3LoadUnsafeA(node1->velocityAngular);
+		const Vec3V velocityLinear0 = V3LoadUnsafeA(node0->velocityLinear);
+		const Vec3V velocityLinear1 = V3LoadUnsafeA(node1->velocityLinear);
+		const Vec3V velocityAngular0 = V3LoadUnsafeA(node0->velocityAngular);
+		const Vec3V velocityAngular1 = V3LoadUnsafeA(node1->velocityAngular);
 
-			const Vec3V offset = V3LoadUnsafeA(bond.offset0);
-			const Vec3V vA = V3Add(velocityLinear0, V3Neg(V3Cross(velocityAngular0, offset)));
-			const Vec3V vB = V3Add(velocityLinear1, V3Cross(velocityAngular1, offset));
+		const Vec3V offset = V3LoadUnsafeA(bond.offset0);
+		const Vec3V vA = V3Add(velocityLinear0, V3Neg(V3Cross(velocityAngular0, offset)));
+		const Vec3V vB = V3Add(velocityLinear1, V3Cross(velocityAngular1, offset));
 
-			const Vec3V vErrorLinear = V3Sub(vA, vB);
-			const Vec3V vErrorAngular = V3Sub(velocityAngular0, velocityAngular1);
+		const Vec3V vErrorLinear = V3Sub(vA, vB);
+		const Vec3V vErrorAngular = V3Sub(velocityAngular0, velocityAngular1);
 
-			const FloatV invM0 = FLoad(node0->invMass);
-			const FloatV invM1 = FLoad(node1->invMass);
-			const FloatV invI0 = FLoad(node0->invI);
-			const FloatV invI1 = FLoad(node1->invI);
-			const FloatV invOffsetSqrLength = FLoad(bond.invOffsetSqrLength);
+		if (ComputeError)
+		{
+			float errorLinear, errorAngular;
+			FStore(V3Length(vErrorLinear), &errorLinear);
+			FStore(V3Length(vErrorAngular), &errorAngular);
+			m_errorLinear += errorLinear;
+			m_errorAngular += errorAngular;
+		}
 
-			const FloatV weightedMass = FLoad(-0.5f / (node0->invMass + node1->invMass));
-			const FloatV weightedInertia = FLoad(-0.5f / (node0->invI + node1->invI));
+		const FloatV invM0 = FLoad(node0->invMass);
+		const FloatV invM1 = FLoad(node1->invMass);
+		const FloatV invI0 = FLoad(node0->invI);
+		const FloatV invI1 = FLoad(node1->invI);
+		const FloatV invOffsetSqrLength = FLoad(bond.invOffsetSqrLength);
 
-			const Vec3V outImpulseLinear = V3Scale(vErrorLinear, weightedMass);
-			const Vec3V outImpulseAngular = V3Scale(vErrorAngular, weightedInertia);
+		const FloatV weightedMass = FLoad(-0.5f / (node0->invMass + node1->invMass));
+		const FloatV weightedInertia = FLoad(-0.5f / (node0->invI + node1->invI));
 
-			V3StoreA(V3Add(V3LoadUnsafeA(bond.impulseLinear), outImpulseLinear), bond.impulseLinear);
-			V3StoreA(V3Add(V3LoadUnsafeA(bond.impulseAngular), outImpulseAngular), bond.impulseAngular);
+		const Vec3V outImpulseLinear = V3Scale(vErrorLinear, weightedMass);
+		const Vec3V outImpulseAngular = V3Scale(vErrorAngular, weightedInertia);
 
-			const Vec3V velocityLinearCorr0 = V3Scale(outImpulseLinear, invM0);
-			const Vec3V velocityLinearCorr1 = V3Scale(outImpulseLinear, invM1);
+		V3StoreA(V3Add(V3LoadUnsafeA(bond.impulseLinear), outImpulseLinear), bond.impulseLinear);
+		V3StoreA(V3Add(V3LoadUnsafeA(bond.impulseAngular), outImpulseAngular), bond.impulseAngular);
 
-			const Vec3V velocityAngularCorr0 = V3Sub(V3Scale(outImpulseAngular, invI0), V3Scale(V3Cross(offset, velocityLinearCorr0), invOffsetSqrLength));
-			const Vec3V velocityAngularCorr1 = V3Add(V3Scale(outImpulseAngular, invI1),	V3Scale(V3Cross(offset, velocityLinearCorr1), invOffsetSqrLength));
+		const Vec3V velocityLinearCorr0 = V3Scale(outImpulseLinear, invM0);
+		const Vec3V velocityLinearCorr1 = V3Scale(outImpulseLinear, invM1);
 
-			V3StoreA(V3Add(velocityLinear0, velocityLinearCorr0), node0->velocityLinear);
-			V3StoreA(V3Sub(velocityLinear1, velocityLinearCorr1), node1->velocityLinear);
+		const Vec3V velocityAngularCorr0 = V3Sub(V3Scale(outImpulseAngular, invI0), V3Scale(V3Cross(offset, velocityLinearCorr0), invOffsetSqrLength));
+		const Vec3V velocityAngularCorr1 = V3Add(V3Scale(outImpulseAngular, invI1),	V3Scale(V3Cross(offset, velocityLinearCorr1), invOffsetSqrLength));
 
-			V3StoreA(V3Add(velocityAngular0, velocityAngularCorr0), node0->velocityAngular);
-			V3StoreA(V3Sub(velocityAngular1, velocityAngularCorr1), node1->velocityAngular);
+		V3StoreA(V3Add(velocityLinear0, velocityLinearCorr0), node0->velocityLinear);
+		V3StoreA(V3Sub(velocityLinear1, velocityLinearCorr1), node1->velocityLinear);
+
+		V3StoreA(V3Add(velocityAngular0, velocityAngularCorr0), node0->velocityAngular);
+		V3StoreA(V3Sub(velocityAngular1, velocityAngularCorr1), node1->velocityAngular);
 #endif
+	}
+
+
+	//////// batched solving ////////
+
+	enum
+	{
+		BATCH_WIDTH = 4,										//!< bonds per batch, one per SIMD lane
+		PARALLEL_JOB_BATCH_COUNT = 64,							//!< batches per parallel job
+		MAX_COLORS = 64											//!< colors tracked per node, bonds not colored within are solved bond by bond
+	};
+
+	/**
+	BATCH_WIDTH bonds of the same color in structure of arrays layout, one bond per SIMD lane.
+	Lanes not used are padding, their bond index is invalid and they don't write any node.
+	*/
+	PX_ALIGN_PREFIX(16)
+	struct BondBatch
+	{
+		float		offsetX[BATCH_WIDTH];
+		float		offsetY[BATCH_WIDTH];
+		float		offsetZ[BATCH_WIDTH];
+		float		invOffsetSqrLength[BATCH_WIDTH];
+		float		impulseLinearX[BATCH_WIDTH];
+		float		impulseLinearY[BATCH_WIDTH];
+		float		impulseLinearZ[BATCH_WIDTH];
+		float		impulseAngularX[BATCH_WIDTH];
+		float		impulseAngularY[BATCH_WIDTH];
+		float		impulseAngularZ[BATCH_WIDTH];
+		uint32_t	node0[BATCH_WIDTH];
+		uint32_t	node1[BATCH_WIDTH];
+		uint32_t	bond[BATCH_WIDTH];		//!< index in m_bondsData
+	}
+	PX_ALIGN_SUFFIX(16);
+
+	/**
+	Greedy bond coloring, bonds of the same color don't share any dynamic node.
+	Every color is packed into m_batches, color c being batches [m_colorPartition[c], m_colorPartition[c + 1]).
+	Bonds which could not be assigned one of the MAX_COLORS colors are listed in m_uncoloredBonds.
+	*/
+	void colorBonds()
+	{
+		const uint32_t bondCount = m_bondsData.size();
+
+		m_nodeColors.resize(m_nodesData.size());
+		memset(m_nodeColors.begin(), 0, m_nodeColors.size() * sizeof(uint64_t));
+		m_bondColors.resize(bondCount);
+		m_uncoloredBonds.clear();
+
+		uint32_t colorBondCounts[MAX_COLORS];
+		memset(colorBondCounts, 0, sizeof(colorBondCounts));
+
+		for (uint32_t i = 0; i < bondCount; ++i)
+		{
+			const BondData& bond = m_bondsData[i];
+			const bool isDynamic0 = m_nodesData[bond.node0].invMass > 0.0f;
+			const bool isDynamic1 = m_nodesData[bond.node1].invMass > 0.0f;
+			const uint64_t usedColors = (isDynamic0 ? m_nodeColors[bond.node0] : 0) | (isDynamic1 ? m_nodeColors[bond.node1] : 0);
+
+			uint32_t color = 0;
+			while (color < MAX_COLORS && (usedColors & (1ull << color)))
+			{
+				color++;
+			}
+
+			if (color < MAX_COLORS)
+			{
+				m_nodeColors[bond.node0] |= 1ull << color;
+				m_nodeColors[bond.node1] |= 1ull << color;
+				colorBondCounts[color]++;
+			}
+			else
+			{
+				m_uncoloredBonds.pushBack(i);
+			}
+			m_bondColors[i] = color;
+		}
+
+		// every color starts a new batch
+		uint32_t colorLaneOffsets[MAX_COLORS];
+		m_colorPartition.resize(MAX_COLORS + 1);
+		m_colorPartition[0] = 0;
+		for (uint32_t c = 0; c < MAX_COLORS; ++c)
+		{
+			colorLaneOffsets[c] = m_colorPartition[c] * BATCH_WIDTH;
+			m_colorPartition[c + 1] = m_colorPartition[c] + (colorBondCounts[c] + BATCH_WIDTH - 1) / BATCH_WIDTH;
+		}
+
+		// padding lanes solve a zero offset bond between the node of the batch's first lane and itself, which yields no impulse
+		m_batches.resize(m_colorPartition[MAX_COLORS]);
+		memset(m_batches.begin(), 0, m_batches.size() * sizeof(BondBatch));
+		for (BondBatch& batch : m_batches)
+		{
+			for (uint32_t lane = 0; lane < BATCH_WIDTH; ++lane)
+			{
+				batch.bond[lane] = invalidIndex<uint32_t>();
+			}
+		}
+
+		for (uint32_t i = 0; i < bondCount; ++i)
+		{
+			const uint32_t color = m_bondColors[i];
+			if (color < MAX_COLORS)
+			{
+				const uint32_t laneIndex = colorLaneOffsets[color]++;
+				BondBatch& batch = m_batches[laneIndex / BATCH_WIDTH];
+				const uint32_t lane = laneIndex % BATCH_WIDTH;
+				const BondData& bond = m_bondsData[i];
+				batch.offsetX[lane] = bond.offset0.x;
+				batch.offsetY[lane] = bond.offset0.y;
+				batch.offsetZ[lane] = bond.offset0.z;
+				batch.invOffsetSqrLength[lane] = bond.invOffsetSqrLength;
+				batch.node0[lane] = bond.node0;
+				batch.node1[lane] = bond.node1;
+				batch.bond[lane] = i;
+			}
+		}
+
+		for (BondBatch& batch : m_batches)
+		{
+			for (uint32_t lane = 1; lane < BATCH_WIDTH; ++lane)
+			{
+				if (isInvalidIndex(batch.bond[lane]))
+				{
+					batch.node0[lane] = batch.node1[lane] = batch.node0[0];
+				}
+			}
+		}
+
+		m_colorsDirty = false;
+	}
+
+	/**
+	Copy the warm start impulses into the batches.
+	*/
+	void packImpulses()
+	{
+		for (BondBatch& batch : m_batches)
+		{
+			for (uint32_t lane = 0; lane < BATCH_WIDTH && !isInvalidIndex(batch.bond[lane]); ++lane)
+			{
+				const BondData& bond = m_bondsData[batch.bond[lane]];
+				batch.impulseLinearX[lane] = bond.impulseLinear.x;
+				batch.impulseLinearY[lane] = bond.impulseLinear.y;
+				batch.impulseLinearZ[lane] = bond.impulseLinear.z;
+				batch.impulseAngularX[lane] = bond.impulseAngular.x;
+				batch.impulseAngularY[lane] = bond.impulseAngular.y;
+				batch.impulseAngularZ[lane] = bond.impulseAngular.z;
+			}
+		}
+	}
+
+	/**
+	Copy the solved impulses back into m_bondsData.
+	*/
+	void unpackImpulses()
+	{
+		for (const BondBatch& batch : m_batches)
+		{
+			for (uint32_t lane = 0; lane < BATCH_WIDTH && !isInvalidIndex(batch.bond[lane]); ++lane)
+			{
+				BondData& bond = m_bondsData[batch.bond[lane]];
+				bond.impulseLinear = PxVec3(batch.impulseLinearX[lane], batch.impulseLinearY[lane], batch.impulseLinearZ[lane]);
+				bond.impulseAngular = PxVec3(batch.impulseAngularX[lane], batch.impulseAngularY[lane], batch.impulseAngularZ[lane]);
+			}
+		}
+	}
+
+	/**
+	Load the nodes of a batch's lanes, transposed such that
+	linear = { velocityLinear.x, velocityLinear.y, velocityLinear.z, invI } and angular = { velocityAngular.x, velocityAngular.y, velocityAngular.z, invMass }
+	with one lane per bond.
+	*/
+	NV_FORCE_INLINE void gatherNodes(const uint32_t* nodes, physx::shdfnd::aos::Vec4V* linear, physx::shdfnd::aos::Vec4V* angular) const
+	{
+		using namespace physx::shdfnd::aos;
+
+		for (uint32_t lane = 0; lane < BATCH_WIDTH; ++lane)
+		{
+			const NodeData& node = m_nodesData[nodes[lane]];
+			linear[lane] = V4LoadA(&node.velocityLinear.x);
+			angular[lane] = V4LoadA(&node.velocityAngular.x);
+		}
+		V4Transpose(linear[0], linear[1], linear[2], linear[3]);
+		V4Transpose(angular[0], angular[1], angular[2], angular[3]);
+	}
+
+	/**
+	Store back the nodes loaded with gatherNodes. Padding lanes and static nodes are not written, static nodes may be shared by bonds of the same color.
+	*/
+	NV_FORCE_INLINE void scatterNodes(const uint32_t* nodes, const uint32_t* bonds, physx::shdfnd::aos::Vec4V* linear, physx::shdfnd::aos::Vec4V* angular)
+	{
+		using namespace physx::shdfnd::aos;
+
+		V4Transpose(linear[0], linear[1], linear[2], linear[3]);
+		V4Transpose(angular[0], angular[1], angular[2], angular[3]);
+		for (uint32_t lane = 0; lane < BATCH_WIDTH; ++lane)
+		{
+			NodeData& node = m_nodesData[nodes[lane]];
+			if (!isInvalidIndex(bonds[lane]) && node.invMass > 0.0f)
+			{
+				V4StoreA(linear[lane], &node.velocityLinear.x);
+				V4StoreA(angular[lane], &node.velocityAngular.x);
+			}
+		}
+	}
+
+	/**
+	Gauss-Seidel step on the BATCH_WIDTH bonds of a batch at once, same math as solveBond().
+	With ComputeError, the bonds' velocity errors before the step are added to errorLinear and errorAngular lanes.
+	*/
+	template<bool ComputeError>
+	NV_FORCE_INLINE void solveBatch(BondBatch& batch, physx::shdfnd::aos::Vec4V& errorLinear, physx::shdfnd::aos::Vec4V& errorAngular)
+	{
+		using namespace physx::shdfnd::aos;
+
+		Vec4V linear0[BATCH_WIDTH], angular0[BATCH_WIDTH], linear1[BATCH_WIDTH], angular1[BATCH_WIDTH];
+		gatherNodes(batch.node0, linear0, angular0);
+		gatherNodes(batch.node1, linear1, angular1);
+
+		const Vec4V offsetX = V4LoadA(batch.offsetX);
+		const Vec4V offsetY = V4LoadA(batch.offsetY);
+		const Vec4V offsetZ = V4LoadA(batch.offsetZ);
+		const Vec4V invOffsetSqrLength = V4LoadA(batch.invOffsetSqrLength);
+
+		// vA = velocityLinear0 - velocityAngular0 x offset, vB = velocityLinear1 + velocityAngular1 x offset
+		const Vec4V crossA_X = V4Sub(V4Mul(angular0[1], offsetZ), V4Mul(angular0[2], offsetY));
+		const Vec4V crossA_Y = V4Sub(V4Mul(angular0[2], offsetX), V4Mul(angular0[0], offsetZ));
+		const Vec4V crossA_Z = V4Sub(V4Mul(angular0[0], offsetY), V4Mul(angular0[1], offsetX));
+		const Vec4V crossB_X = V4Sub(V4Mul(angular1[1], offsetZ), V4Mul(angular1[2], offsetY));
+		const Vec4V crossB_Y = V4Sub(V4Mul(angular1[2], offsetX), V4Mul(angular1[0], offsetZ));
+		const Vec4V crossB_Z = V4Sub(V4Mul(angular1[0], offsetY), V4Mul(angular1[1], offsetX));
+
+		const Vec4V errorLinearX = V4Sub(V4Sub(linear0[0], crossA_X), V4Add(linear1[0], crossB_X));
+		const Vec4V errorLinearY = V4Sub(V4Sub(linear0[1], crossA_Y), V4Add(linear1[1], crossB_Y));
+		const Vec4V errorLinearZ = V4Sub(V4Sub(linear0[2], crossA_Z), V4Add(linear1[2], crossB_Z));
+		const Vec4V errorAngularX = V4Sub(angular0[0], angular1[0]);
+		const Vec4V errorAngularY = V4Sub(angular0[1], angular1[1]);
+		const Vec4V errorAngularZ = V4Sub(angular0[2], angular1[2]);
+
+		if (ComputeError)
+		{
+			errorLinear = V4Add(errorLinear, V4Sqrt(V4Add(V4Add(V4Mul(errorLinearX, errorLinearX), V4Mul(errorLinearY, errorLinearY)), V4Mul(errorLinearZ, errorLinearZ))));
+			errorAngular = V4Add(errorAngular, V4Sqrt(V4Add(V4Add(V4Mul(errorAngularX, errorAngularX), V4Mul(errorAngularY, errorAngularY)), V4Mul(errorAngularZ, errorAngularZ))));
+		}
+
+		// padding lanes may solve a static node against itself, keep their weights finite
+		const Vec4V invMass0 = angular0[3];
+		const Vec4V invMass1 = angular1[3];
+		const Vec4V invI0 = linear0[3];
+		const Vec4V invI1 = linear1[3];
+		const Vec4V minInvSum = V4Load(FLT_MIN);
+		const Vec4V minusHalf = V4Load(-0.5f);
+		const Vec4V weightedMass = V4Mul(minusHalf, V4Recip(V4Max(V4Add(invMass0, invMass1), minInvSum)));
+		const Vec4V weightedInertia = V4Mul(minusHalf, V4Recip(V4Max(V4Add(invI0, invI1), minInvSum)));
+
+		const Vec4V impulseLinearX = V4Mul(errorLinearX, weightedMass);
+		const Vec4V impulseLinearY = V4Mul(errorLinearY, weightedMass);
+		const Vec4V impulseLinearZ = V4Mul(errorLinearZ, weightedMass);
+		const Vec4V impulseAngularX = V4Mul(errorAngularX, weightedInertia);
+		const Vec4V impulseAngularY = V4Mul(errorAngularY, weightedInertia);
+		const Vec4V impulseAngularZ = V4Mul(errorAngularZ, weightedInertia);
+
+		V4StoreA(V4Add(V4LoadA(batch.impulseLinearX), impulseLinearX), batch.impulseLinearX);
+		V4StoreA(V4Add(V4LoadA(batch.impulseLinearY), impulseLinearY), batch.impulseLinearY);
+		V4StoreA(V4Add(V4LoadA(batch.impulseLinearZ), impulseLinearZ), batch.impulseLinearZ);
+		V4StoreA(V4Add(V4LoadA(batch.impulseAngularX), impulseAngularX), batch.impulseAngularX);
+		V4StoreA(V4Add(V4LoadA(batch.impulseAngularY), impulseAngularY), batch.impulseAngularY);
+		V4StoreA(V4Add(V4LoadA(batch.impulseAngularZ), impulseAngularZ), batch.impulseAngularZ);
+
+		const Vec4V corrLinear0X = V4Mul(impulseLinearX, invMass0);
+		const Vec4V corrLinear0Y = V4Mul(impulseLinearY, invMass0);
+		const Vec4V corrLinear0Z = V4Mul(impulseLinearZ, invMass0);
+		const Vec4V corrLinear1X = V4Mul(impulseLinearX, invMass1);
+		const Vec4V corrLinear1Y = V4Mul(impulseLinearY, invMass1);
+		const Vec4V corrLinear1Z = V4Mul(impulseLinearZ, invMass1);
+
+		// velocityAngularCorr0 = impulseAngular * invI0 - (offset x velocityLinearCorr0) * invOffsetSqrLength
+		const Vec4V cross0X = V4Mul(V4Sub(V4Mul(offsetY, corrLinear0Z), V4Mul(offsetZ, corrLinear0Y)), invOffsetSqrLength);
+		const Vec4V cross0Y = V4Mul(V4Sub(V4Mul(offsetZ, corrLinear0X), V4Mul(offsetX, corrLinear0Z)), invOffsetSqrLength);
+		const Vec4V cross0Z = V4Mul(V4Sub(V4Mul(offsetX, corrLinear0Y), V4Mul(offsetY, corrLinear0X)), invOffsetSqrLength);
+		const Vec4V cross1X = V4Mul(V4Sub(V4Mul(offsetY, corrLinear1Z), V4Mul(offsetZ, corrLinear1Y)), invOffsetSqrLength);
+		const Vec4V cross1Y = V4Mul(V4Sub(V4Mul(offsetZ, corrLinear1X), V4Mul(offsetX, corrLinear1Z)), invOffsetSqrLength);
+		const Vec4V cross1Z = V4Mul(V4Sub(V4Mul(offsetX, corrLinear1Y), V4Mul(offsetY, corrLinear1X)), invOffsetSqrLength);
+
+		linear0[0] = V4Add(linear0[0], corrLinear0X);
+		linear0[1] = V4Add(linear0[1], corrLinear0Y);
+		linear0[2] = V4Add(linear0[2], corrLinear0Z);
+		linear1[0] = V4Sub(linear1[0], corrLinear1X);
+		linear1[1] = V4Sub(linear1[1], corrLinear1Y);
+		linear1[2] = V4Sub(linear1[2], corrLinear1Z);
+
+		angular0[0] = V4Add(angular0[0], V4Sub(V4Mul(impulseAngularX, invI0), cross0X));
+		angular0[1] = V4Add(angular0[1], V4Sub(V4Mul(impulseAngularY, invI0), cross0Y));
+		angular0[2] = V4Add(angular0[2], V4Sub(V4Mul(impulseAngularZ, invI0), cross0Z));
+		angular1[0] = V4Sub(angular1[0], V4Add(V4Mul(impulseAngularX, invI1), cross1X));
+		angular1[1] = V4Sub(angular1[1], V4Add(V4Mul(impulseAngularY, invI1), cross1Y));
+		angular1[2] = V4Sub(angular1[2], V4Add(V4Mul(impulseAngularZ, invI1), cross1Z));
+
+		scatterNodes(batch.node0, batch.bond, linear0, angular0);
+		scatterNodes(batch.node1, batch.bond, linear1, angular1);
+	}
+
+	struct BatchRange
+	{
+		SequentialImpulseSolver*	solver;
+		uint32_t					begin;
+		uint32_t					end;
+		float*						jobErrors;		//!< linear and angular error per job, when computing the error
+	};
+
+	template<bool ComputeError>
+	static void iterateBatchesJob(void* jobData, uint32_t jobIndex)
+	{
+		using namespace physx::shdfnd::aos;
+
+		const BatchRange& range = *static_cast<const BatchRange*>(jobData);
+		SequentialImpulseSolver& solver = *range.solver;
+		const uint32_t begin = range.begin + jobIndex * PARALLEL_JOB_BATCH_COUNT;
+		const uint32_t end = std::min<uint32_t>(begin + PARALLEL_JOB_BATCH_COUNT, range.end);
+
+		Vec4V errorLinear = V4Zero();
+		Vec4V errorAngular = V4Zero();
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			solver.solveBatch<ComputeError>(solver.m_batches[i], errorLinear, errorAngular);
+		}
+
+		if (ComputeError)
+		{
+			PX_ALIGN(16, float linear[BATCH_WIDTH]);
+			PX_ALIGN(16, float angular[BATCH_WIDTH]);
+			V4StoreA(errorLinear, linear);
+			V4StoreA(errorAngular, angular);
+			range.jobErrors[2 * jobIndex] = linear[0] + linear[1] + linear[2] + linear[3];
+			range.jobErrors[2 * jobIndex + 1] = angular[0] + angular[1] + angular[2] + angular[3];
+		}
+	}
+
+	/**
+	One iteration over all bonds, color by color. The batches of a color are processed in parallel through the dispatcher if any.
+	*/
+	template<bool ComputeError>
+	void iterateBatched(ExtStressSolverDispatcher* dispatcher)
+	{
+		for (uint32_t c = 0; c < MAX_COLORS; ++c)
+		{
+			const uint32_t batchCount = m_colorPartition[c + 1] - m_colorPartition[c];
+			if (batchCount == 0)
+			{
+				continue;
+			}
+
+			const uint32_t jobCount = (batchCount + PARALLEL_JOB_BATCH_COUNT - 1) / PARALLEL_JOB_BATCH_COUNT;
+			if (ComputeError && m_jobErrors.size() < 2 * jobCount)
+			{
+				m_jobErrors.resize(2 * jobCount);
+			}
+
+			BatchRange range = { this, m_colorPartition[c], m_colorPartition[c + 1], m_jobErrors.begin() };
+			if (dispatcher != nullptr && jobCount > 1)
+			{
+				dispatcher->parallelFor(jobCount, iterateBatchesJob<ComputeError>, &range);
+			}
+			else
+			{
+				for (uint32_t job = 0; job < jobCount; ++job)
+				{
+					iterateBatchesJob<ComputeError>(&range, job);
+				}
+			}
+
+			if (ComputeError)
+			{
+				for (uint32_t job = 0; job < jobCount; ++job)
+				{
+					m_errorLinear += m_jobErrors[2 * job];
+					m_errorAngular += m_jobErrors[2 * job + 1];
+				}
+			}
+		}
+
+		for (uint32_t bond : m_uncoloredBonds)
+		{
+			solveBond<ComputeError>(m_bondsData[bond]);
+		}
+	}
+
+
+	//////// conjugate gradient ////////
+
+	struct ConjugateGradientBond
+	{
+		PxVec3	residualLinear;
+		PxVec3	residualAngular;
+		PxVec3	directionLinear;
+		PxVec3	directionAngular;
+		PxVec3	productLinear;			//!< A * direction
+		PxVec3	productAngular;
+		PxVec3	preconditionerLinear;	//!< inverse of A's diagonal
+		float	preconditionerAngular;
+	};
+
+	struct NodeVelocities
+	{
+		PxVec3	velocityLinear;
+		PxVec3	velocityAngular;
+	};
+
+	static NV_FORCE_INLINE float invDiagonal(float diagonal)
+	{
+		return diagonal > 0.0f ? 1.0f / diagonal : 0.0f;
+	}
+
+	/**
+	J * v for one bond, the same velocity error solveBond() corrects.
+	*/
+	static NV_FORCE_INLINE void velocityError(const BondData& bond, const PxVec3& velocityLinear0, const PxVec3& velocityAngular0, 
+		const PxVec3& velocityLinear1, const PxVec3& velocityAngular1, PxVec3& errorLinear, PxVec3& errorAngular)
+	{
+		const PxVec3 vA = velocityLinear0 - velocityAngular0.cross(bond.offset0);
+		const PxVec3 vB = velocityLinear1 + velocityAngular1.cross(bond.offset0);
+		errorLinear = vA - vB;
+		errorAngular = velocityAngular0 - velocityAngular1;
+	}
+
+	/**
+	invMass / invI, 0 for static nodes.
+	*/
+	static NV_FORCE_INLINE float angularCoupling(const NodeData& node)
+	{
+		return node.invI > 0.0f ? node.invMass / node.invI : 0.0f;
+	}
+
+	/**
+	G * v for one bond: velocityError() with the nodes' angular velocities scaled by angularCoupling() / offsetLength^2 in 
+	the linear error, the transpose of the impulse application in applyDirections().
+	*/
+	static NV_FORCE_INLINE void symmetricVelocityError(const BondData& bond, const NodeData& node0, const NodeData& node1, const PxVec3& velocityLinear0, 
+		const PxVec3& velocityAngular0, const PxVec3& velocityLinear1, const PxVec3& velocityAngular1, PxVec3& errorLinear, PxVec3& errorAngular)
+	{
+		const PxVec3 vA = velocityLinear0 - velocityAngular0.cross(bond.offset0) * (angularCoupling(node0) * bond.invOffsetSqrLength);
+		const PxVec3 vB = velocityLinear1 + velocityAngular1.cross(bond.offset0) * (angularCoupling(node1) * bond.invOffsetSqrLength);
+		errorLinear = vA - vB;
+		errorAngular = velocityAngular0 - velocityAngular1;
+	}
+
+	/**
+	M^-1 * G^T * direction, the node velocity changes due to applying the bonds' conjugate gradient directions as impulses,
+	the same way solveBond() applies impulses.
+	*/
+	void applyDirections()
+	{
+		memset(m_cgNodes.begin(), 0, m_cgNodes.size() * sizeof(NodeVelocities));
+		for (uint32_t i = 0; i < m_bondsData.size(); ++i)
+		{
+			const BondData& bond = m_bondsData[i];
+			const ConjugateGradientBond& cg = m_cgBonds[i];
+			const NodeData& node0 = m_nodesData[bond.node0];
+			const NodeData& node1 = m_nodesData[bond.node1];
+			NodeVelocities& delta0 = m_cgNodes[bond.node0];
+			NodeVelocities& delta1 = m_cgNodes[bond.node1];
+
+			const PxVec3 torque = bond.offset0.cross(cg.directionLinear) * bond.invOffsetSqrLength;
+
+			delta0.velocityLinear += cg.directionLinear * node0.invMass;
+			delta1.velocityLinear -= cg.directionLinear * node1.invMass;
+
+			delta0.velocityAngular += cg.directionAngular * node0.invI - torque * node0.invMass;
+			delta1.velocityAngular -= cg.directionAngular * node1.invI + torque * node1.invMass;
 		}
 	}
 
 	Array<BondData>::type		m_bondsData;
 	Array<NodeData>::type		m_nodesData;
+
+	float						m_errorLinear;		//!< linear error measured during the last iteration
+	float						m_errorAngular;		//!< angular error measured during the last iteration
+
+	bool						m_colorsDirty;		//!< bonds or static nodes changed since the last colorBonds() call
+	Array<uint64_t>::type		m_nodeColors;		//!< colors used by the bonds of each node, for colorBonds()
+	Array<uint32_t>::type		m_bondColors;		//!< color of each bond, MAX_COLORS if uncolored
+	Array<BondBatch>::type		m_batches;			//!< colored bonds, in batches of BATCH_WIDTH bonds of the same color
+	Array<uint32_t>::type		m_colorPartition;	//!< first batch of each color in m_batches
+	Array<uint32_t>::type		m_uncoloredBonds;	//!< bonds solved one by one after the batches
+	Array<float>::type			m_jobErrors;		//!< per job errors, summed after each color
+
+	Array<ConjugateGradientBond>::type	m_cgBonds;	//!< conjugate gradient state per bond
+	Array<NodeVelocities>::type			m_cgNodes;	//!< node velocity changes due to the conjugate gradient directions
 };
 
 
@@ -341,8 +1033,11 @@ public:
 		PxVec3 localPos;
 		bool isStatic;
 		uint32_t solverNode;
+		uint32_t nextSupportNode;	//!< next node aggregated in the same solver node, invalid index for the last one
 		uint32_t neighborsCount;
-		PxVec3 impulse;
+		PxVec3 impulse;				//!< accumulated by addNodeForce() calls
+		PxVec3 appliedImpulse;		//!< impulse to solve, snapshot by snapshotImpulses()
+		PxVec3 solvedImpulse;		//!< impulse applied on the last solve, to detect force changes while sleeping
 	};
 
 	struct SolverNodeData
@@ -356,6 +1051,8 @@ public:
 		};
 		float volume;
 		bool isStatic;
+		bool isDirty;				//!< queued in m_dirtySolverNodes
+		uint32_t firstSupportNode;	//!< first node aggregated in this solver node, the others follow through NodeData::nextSupportNode
 	};
 
 	struct SolverBondData
@@ -363,9 +1060,11 @@ public:
 		InlineArray<uint32_t, 8>::type blastBondIndices;
 	};
 
-	SupportGraphProcessor(uint32_t nodeCount, uint32_t maxBondCount) : m_solver(nodeCount, maxBondCount), m_nodesDirty(true)
+	SupportGraphProcessor(uint32_t nodeCount, uint32_t maxBondCount) : m_solver(nodeCount, maxBondCount), m_reducedSolverNodeCount(0), m_nodesDirty(true), m_structureChanged(true), m_isSleeping(false), m_hasSolved(false)
 	{
 		m_nodesData.resize(nodeCount);
+		m_localNodeIndices.resize(nodeCount);
+		memset(m_localNodeIndices.begin(), 0xFF, m_localNodeIndices.size() * sizeof(uint32_t));
 		m_bondsData.reserve(maxBondCount);
 
 		m_solverNodesData.resize(nodeCount);
@@ -434,6 +1133,14 @@ public:
 		return m_overstressedBondCount;
 	}
 
+	/**
+	Bonds to fracture, as of the last solve(). Bonds removed since are still listed, getBondStress() returns 0 for them.
+	*/
+	const Array<BondData>::type& getOverstressedBonds() const
+	{
+		return m_overstressedBonds;
+	}
+
 	float getSolverBondStressHealth(uint32_t bond, const ExtStressSolverSettings& settings) const
 	{
 		const auto& solverBond = getSolverInternalBondData(bond);
@@ -451,6 +1158,7 @@ public:
 		m_nodesData[node].localPos = localPos;
 		m_nodesData[node].isStatic = isStatic;
 		m_nodesDirty = true;
+		m_structureChanged = true;
 	}
 
 	void setNodeNeighborsCount(uint32_t node, uint32_t neighborsCount)
@@ -458,10 +1166,10 @@ public:
 		// neighbors count is expected to be the number of nodes on 1 island/actor.
 		m_nodesData[node].neighborsCount = neighborsCount;
 
-		// check for too huge aggregates (happens after island's split)
-		if (!m_nodesDirty)
+		// check for too huge aggregates (happens after island's split), they are reduced again on next sync
+		if (!m_nodesDirty && m_solverNodesData[m_nodesData[node].solverNode].supportNodesCount > neighborsCount / 2)
 		{
-			m_nodesDirty |= (m_solverNodesData[m_nodesData[node].solverNode].supportNodesCount > neighborsCount / 2);
+			markSolverNodeDirty(m_nodesData[node].solverNode);
 		}
 	}
 
@@ -493,6 +1201,8 @@ public:
 			};
 			m_bondsData.pushBack(data);
 			m_blastBondIndexMap[blastBondIndex] = m_bondsData.size() - 1;
+			m_nodesDirty = true;
+			m_structureChanged = true;
 		}
 	}
 
@@ -509,8 +1219,11 @@ public:
 
 			if (isBondInternal)
 			{
-				// internal bond sadly requires graph resync (it never happens on reduction level '0')
-				m_nodesDirty = true;
+				// internal bond can split its solver node, which is then reduced again on next sync (it never happens on reduction level '0')
+				if (!m_nodesDirty)
+				{
+					markSolverNodeDirty(solverNode0);
+				}
 			}
 			else if (!m_nodesDirty)
 			{
@@ -527,17 +1240,7 @@ public:
 					if (blastBondIndices.empty())
 					{
 						// all bonds associated with this solver bond were removed, so let's remove solver bond
-
-						m_solverBondsData.replaceWithLast(solverBondIndex);
-						m_solver.replaceWithLast(solverBondIndex);
-						if (m_solver.getBondCount() > 0)
-						{
-							// update 'previously last' solver bond mapping
-							const auto& solverBond = m_solver.getBondData(solverBondIndex);
-							m_solverBondsMap[BondKey(solverBond.node0, solverBond.node1)] = solverBondIndex;
-						}
-
-						m_solverBondsMap.erase(solverBondKey);
+						removeSolverBond(solverBondIndex, solverBondKey);
 					}
 				}
 
@@ -545,6 +1248,7 @@ public:
 			}
 
 			// remove bond from graph processor's list
+			m_structureChanged = true;
 			m_blastBondIndexMap[blastBondIndex] = invalidIndex<uint32_t>();
 			m_bondsData.replaceWithLast(bondIndex);
 			m_blastBondIndexMap[m_bondsData[bondIndex].blastBondIndex] = m_bondsData.size() > bondIndex ? bondIndex : invalidIndex<uint32_t>();
@@ -555,6 +1259,7 @@ public:
 	{
 		m_graphReductionLevel = level;
 		m_nodesDirty = true;
+		m_structureChanged = true;
 	}
 
 	uint32_t getGraphReductionLevel() const
@@ -562,24 +1267,105 @@ public:
 		return m_graphReductionLevel;
 	}
 
-	void solve(const ExtStressSolverSettings& settings, const float* bondHealth, bool warmStart = true)
+	bool isSleeping() const
+	{
+		return m_isSleeping;
+	}
+
+	/**
+	Whether the last solve() call solved, false if the solver slept through it. A solve can end up sleeping too.
+	*/
+	bool hasSolved() const
+	{
+		return m_hasSolved;
+	}
+
+	bool hasStructureChanged() const
+	{
+		return m_structureChanged;
+	}
+
+	/**
+	Take the impulses accumulated so far as the ones to solve, new addNodeForce() calls accumulate for the next solve.
+	*/
+	void snapshotImpulses()
+	{
+		for (NodeData& node : m_nodesData)
+		{
+			node.appliedImpulse = node.impulse;
+			node.impulse = PxVec3(PxZero);
+		}
+	}
+
+	/**
+	Rebuild the solver graph from the support graph changes since the last sync, to be called before solve().
+	*/
+	void sync()
+	{
+		if (m_nodesDirty)
+		{
+			syncNodes();
+		}
+		else if (!m_dirtySolverNodes.empty())
+		{
+			syncDirtySolverNodes();
+
+			// split solver nodes are never merged back, reduce the whole graph again once it lost half of its reduction
+			if (m_solverNodesData.size() > 2 * m_reducedSolverNodeCount)
+			{
+				syncNodes();
+			}
+		}
+		if (m_bondsDirty)
+		{
+			syncBonds();
+		}
+
+		CHECK_GRAPH_INTEGRITY;
+	}
+
+	/**
+	Solve stress, unless sleeping: the last solve's error was below settings.sleepThreshold and neither the graph nor the applied 
+	impulses changed since. A sleeping solver keeps its bond impulses, only bond stress is updated against current bond health.
+	*/
+	void solve(const ExtStressSolverSettings& settings, ExtStressSolverDispatcher* dispatcher, const float* bondHealth, bool warmStart = true)
 	{
-		sync();
+		m_hasSolved = !(m_isSleeping && warmStart && !m_structureChanged && !impulsesChanged(settings.sleepThreshold));
+		if (!m_hasSolved)
+		{
+			updateBondStress(settings, bondHealth);
+			return;
+		}
 
 		m_solver.initialize();
 
 		for (const NodeData& node : m_nodesData)
 		{
 			const SequentialImpulseSolver::NodeData& solverNode = m_solver.getNodeData(node.solverNode);
-			m_solver.setNodeVelocities(node.solverNode, solverNode.velocityLinear + node.impulse * solverNode.invMass, PxVec3(PxZero));
+			m_solver.setNodeVelocities(node.solverNode, solverNode.velocityLinear + node.appliedImpulse * solverNode.invMass, PxVec3(PxZero));
 		}
 
 		uint32_t iterationCount = ExtStressSolver::getIterationsPerFrame(settings, getSolverBondCount());
-		m_solver.solve(iterationCount, warmStart);
+		if (settings.solverType == ExtStressSolverType::CONJUGATE_GRADIENT)
+		{
+			m_solver.solveConjugateGradient(iterationCount, warmStart);
+		}
+		else
+		{
+			m_solver.solve(iterationCount, warmStart, dispatcher, settings.minBatchedBondCount);
+		}
 
-		resetImpulses();
+		for (NodeData& node : m_nodesData)
+		{
+			node.solvedImpulse = node.appliedImpulse;
+		}
 
 		updateBondStress(settings, bondHealth);
+
+		float errorLinear, errorAngular;
+		m_solver.calcError(errorLinear, errorAngular);
+		m_isSleeping = settings.sleepThreshold > 0.0f && errorLinear + errorAngular <= settings.sleepThreshold * getSolverBondCount();
+		m_structureChanged = false;
 	}
 
 	void calcError(float& linear, float& angular)
@@ -587,7 +1373,7 @@ public:
 		m_solver.calcError(linear, angular);
 	}
 
-	float getBondStress(uint32_t blastBondIndex)
+	float getBondStress(uint32_t blastBondIndex) const
 	{
 		const uint32_t bondIndex = m_blastBondIndexMap[blastBondIndex];
 		return isInvalidIndex(bondIndex) ? 0.0f : m_bondsData[bondIndex].stress;
@@ -595,6 +1381,33 @@ public:
 
 private:
 
+	struct BondKey
+	{
+		uint32_t node0;
+		uint32_t node1;
+
+		BondKey(uint32_t n0, uint32_t n1)
+		{
+			node0 = n0 < n1 ? n0 : n1;
+			node1 = n0 < n1 ? n1 : n0;
+		}
+
+		operator uint64_t() const
+		{
+			return static_cast<uint64_t>(node0) + (static_cast<uint64_t>(node1) << 32);
+		}
+	};
+
+	struct LocalBond
+	{
+		uint32_t node0;
+		uint32_t node1;
+	};
+
+	// for static nodes aggregate size per graph reduction level is lower, it
+	// falls behind on few levels. (can be made as parameter)
+	enum { STATIC_NODES_COUNT_PENALTY = 2 << 2 };
+
 	void resetImpulses()
 	{
 		for (auto& node : m_nodesData)
@@ -603,9 +1416,25 @@ private:
 		}
 	}
 
+	/**
+	Whether the velocity change due to the impulses applied on any node differs by more than threshold from the last solve.
+	*/
+	bool impulsesChanged(float threshold) const
+	{
+		for (const NodeData& node : m_nodesData)
+		{
+			if (!node.isStatic && (node.appliedImpulse - node.solvedImpulse).magnitudeSquared() > threshold * threshold * node.mass * node.mass)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
 	void updateBondStress(const ExtStressSolverSettings& settings, const float* bondHealth)
 	{
 		m_overstressedBondCount = 0;
+		m_overstressedBonds.clear();
 
 		for (uint32_t i = 0; i < m_solverBondsData.size(); ++i)
 		{
@@ -628,27 +1457,21 @@ private:
 					{
 						m_overstressedBondCount++;
 					}
+
+					// fracture commands break the bonds whose own share of the stress is above their health
+					if (bondHealth[blastBondIndex] > 0.0f && stressPerBond > bondHealth[blastBondIndex])
+					{
+						m_overstressedBonds.pushBack(bond);
+					}
 				}
 			}
 		}
 	}
 
-	void sync()
-	{
-		if (m_nodesDirty)
-		{
-			syncNodes();
-		}
-		if (m_bondsDirty)
-		{
-			syncBonds();
-		}
-
-		CHECK_GRAPH_INTEGRITY;
-	}
-
 	void syncNodes()
 	{
+		buildAdjacency();
+
 		// init with 1<->1 blast nodes to solver nodes mapping
 		m_solverNodesData.resize(m_nodesData.size());
 		for (uint32_t i = 0; i < m_nodesData.size(); ++i)
@@ -658,10 +1481,6 @@ private:
 			m_solverNodesData[i].indexShift = 0;
 		}
 
-		// for static nodes aggregate size per graph reduction level is lower, it
-		// falls behind on few levels. (can be made as parameter)
-		const uint32_t STATIC_NODES_COUNT_PENALTY = 2 << 2;
-
 		// reducing graph by aggregating nodes level by level
 		// NOTE (@anovoselov):  Recently, I found a flow in the algorithm below. In very rare situations aggregate (solver node)
 		// can contain more then one connected component. I didn't notice it to produce any visual artifacts and it's 
@@ -751,85 +1570,369 @@ private:
 		// calculate all needed data
 		for (SolverNodeData& solverNode : m_solverNodesData)
 		{
-			solverNode.supportNodesCount = 0;
-			solverNode.localPos = PxVec3(PxZero);
-			solverNode.mass = 0.0f;
-			solverNode.volume = 0.0f;
-			solverNode.isStatic = false;
+			resetSolverNode(solverNode);
 		}
 
-		for (NodeData& node : m_nodesData)
+		for (uint32_t nodeIndex = 0; nodeIndex < m_nodesData.size(); ++nodeIndex)
 		{
-			SolverNodeData& solverNode = m_solverNodesData[node.solverNode];
-			solverNode.supportNodesCount++;
-			solverNode.localPos += node.localPos;
-			solverNode.mass += node.mass;
-			solverNode.volume += node.volume;
-			solverNode.isStatic |= node.isStatic;
+			addToSolverNode(nodeIndex, m_nodesData[nodeIndex].solverNode);
 		}
 
-		for (SolverNodeData& solverNode : m_solverNodesData)
+		m_solver.reset(m_solverNodesData.size());
+		for (uint32_t nodeIndex = 0; nodeIndex < m_solverNodesData.size(); ++nodeIndex)
 		{
+			SolverNodeData& solverNode = m_solverNodesData[nodeIndex];
 			solverNode.localPos /= (float)solverNode.supportNodesCount;
+
+			float invMass, invI;
+			calcSolverNodeMassInfo(solverNode, invMass, invI);
+			m_solver.setNodeMassInfo(nodeIndex, invMass, invI);
+		}
+
+		m_dirtySolverNodes.clear();
+		m_nodesDirty = false;
+		m_reducedSolverNodeCount = m_solverNodesData.size();
+
+		syncBonds();
+	}
+
+	void syncBonds()
+	{
+		// traverse all blast bonds and aggregate
+		m_solver.clearBonds();
+		m_solverBondsMap.clear();
+		m_solverBondsData.clear();
+		for (BondData& bond : m_bondsData)
+		{
+			// reset stress, bond structure changed and internal bonds stress won't be updated during updateBondStress()
+			bond.stress = 0.0f;
+
+			addToSolverBond(bond);
+		}
+
+		m_bondsDirty = false;
+	}
+
+	void addToSolverBond(const BondData& bond)
+	{
+		const NodeData& node0 = m_nodesData[bond.node0];
+		const NodeData& node1 = m_nodesData[bond.node1];
+
+		if (node0.solverNode == node1.solverNode)
+			return; // skip (internal)
+
+		if (node0.isStatic && node1.isStatic)
+			return;
+
+		BondKey key(node0.solverNode, node1.solverNode);
+		auto entry = m_solverBondsMap.find(key);
+		SolverBondData* data;
+		if (!entry)
+		{
+			m_solverBondsData.pushBack(SolverBondData());
+			data = &m_solverBondsData.back();
+			m_solverBondsMap[key] = m_solverBondsData.size() - 1;
+
+			SolverNodeData& solverNode0 = m_solverNodesData[node0.solverNode];
+			SolverNodeData& solverNode1 = m_solverNodesData[node1.solverNode];
+			m_solver.addBond(node0.solverNode, node1.solverNode, (solverNode1.localPos - solverNode0.localPos) * 0.5f);
+		}
+		else
+		{
+			data = &m_solverBondsData[entry->second];
+		}
+		data->blastBondIndices.pushBack(bond.blastBondIndex);
+	}
+
+	void removeSolverBond(uint32_t solverBondIndex, const BondKey& key)
+	{
+		m_solverBondsData.replaceWithLast(solverBondIndex);
+		m_solver.replaceWithLast(solverBondIndex);
+		if (m_solver.getBondCount() > solverBondIndex)
+		{
+			// update 'previously last' solver bond mapping
+			const auto& solverBond = m_solver.getBondData(solverBondIndex);
+			m_solverBondsMap[BondKey(solverBond.node0, solverBond.node1)] = solverBondIndex;
+		}
+
+		m_solverBondsMap.erase(key);
+	}
+
+	void resetSolverNode(SolverNodeData& solverNode)
+	{
+		solverNode.supportNodesCount = 0;
+		solverNode.localPos = PxVec3(PxZero);
+		solverNode.mass = 0.0f;
+		solverNode.volume = 0.0f;
+		solverNode.isStatic = false;
+		solverNode.isDirty = false;
+		solverNode.firstSupportNode = invalidIndex<uint32_t>();
+	}
+
+	/**
+	Aggregate a node into a solver node, its localPos is accumulated and must be divided by supportNodesCount once all the nodes are added.
+	*/
+	void addToSolverNode(uint32_t nodeIndex, uint32_t solverNodeIndex)
+	{
+		NodeData& node = m_nodesData[nodeIndex];
+		SolverNodeData& solverNode = m_solverNodesData[solverNodeIndex];
+		node.solverNode = solverNodeIndex;
+		node.nextSupportNode = solverNode.firstSupportNode;
+		solverNode.firstSupportNode = nodeIndex;
+		solverNode.supportNodesCount++;
+		solverNode.localPos += node.localPos;
+		solverNode.mass += node.mass;
+		solverNode.volume += node.volume;
+		solverNode.isStatic |= node.isStatic;
+	}
+
+	static void calcSolverNodeMassInfo(const SolverNodeData& solverNode, float& invMass, float& invI)
+	{
+		invMass = solverNode.isStatic ? 0.0f : 1.0f / solverNode.mass;
+		const float R = PxPow(solverNode.volume * 3.0f * PxInvPi / 4.0f, 1.0f / 3.0f); // sphere volume approximation
+		invI = invMass / (R * R * 0.4f); // sphere inertia tensor approximation: I = 2/5 * M * R^2 ; invI = 1 / I;
+	}
+
+	/**
+	Nodes adjacency, in blast bond indices. Bonds are only removed once synced (adding one requires a full resync), 
+	so it's built on full resync only and removed bonds are skipped through m_blastBondIndexMap.
+	*/
+	void buildAdjacency()
+	{
+		const uint32_t nodeCount = m_nodesData.size();
+		m_adjacencyPartition.resize(nodeCount + 1);
+		memset(m_adjacencyPartition.begin(), 0, m_adjacencyPartition.size() * sizeof(uint32_t));
+		for (const BondData& bond : m_bondsData)
+		{
+			m_adjacencyPartition[bond.node0]++;
+			m_adjacencyPartition[bond.node1]++;
+		}
+
+		uint32_t offset = 0;
+		for (uint32_t i = 0; i < nodeCount; ++i)
+		{
+			const uint32_t count = m_adjacencyPartition[i];
+			m_adjacencyPartition[i] = offset;
+			offset += count;
+		}
+
+		m_adjacentBonds.resize(offset);
+		for (const BondData& bond : m_bondsData)
+		{
+			m_adjacentBonds[m_adjacencyPartition[bond.node0]++] = bond.blastBondIndex;
+			m_adjacentBonds[m_adjacencyPartition[bond.node1]++] = bond.blastBondIndex;
+		}
+
+		// every partition entry now points to the next node's start
+		for (uint32_t i = nodeCount; i > 0; --i)
+		{
+			m_adjacencyPartition[i] = m_adjacencyPartition[i - 1];
+		}
+		m_adjacencyPartition[0] = 0;
+	}
+
+	void markSolverNodeDirty(uint32_t solverNodeIndex)
+	{
+		SolverNodeData& solverNode = m_solverNodesData[solverNodeIndex];
+		if (!solverNode.isDirty)
+		{
+			solverNode.isDirty = true;
+			m_dirtySolverNodes.pushBack(solverNodeIndex);
+			m_structureChanged = true;
+		}
+	}
+
+	/**
+	Incremental alternative to syncNodes(), only the dirty solver nodes and the solver bonds around them are rebuilt.
+	*/
+	void syncDirtySolverNodes()
+	{
+		for (uint32_t i = 0; i < m_dirtySolverNodes.size(); ++i)
+		{
+			reduceSolverNode(m_dirtySolverNodes[i]);
+		}
+		m_dirtySolverNodes.clear();
+
+		// solver nodes partition the support nodes, splitting them can't add more
+		NVBLAST_ASSERT(m_solverNodesData.size() <= m_nodesData.size());
+	}
+
+	/**
+	Run the graph reduction of syncNodes() again on the support nodes of one solver node, using only the bonds between them.
+	The first resulting aggregate keeps the solver node, the others are added as new solver nodes. 
+	Solver bonds of the solver node are removed and rebuilt from the nodes' bonds.
+	*/
+	void reduceSolverNode(uint32_t solverNodeIndex)
+	{
+		// number support nodes locally
+		m_localNodes.clear();
+		for (uint32_t node = m_solverNodesData[solverNodeIndex].firstSupportNode; !isInvalidIndex(node); node = m_nodesData[node].nextSupportNode)
+		{
+			m_localNodeIndices[node] = m_localNodes.size();
+			m_localNodes.pushBack(node);
+		}
+		const uint32_t localCount = m_localNodes.size();
+
+		// collect bonds within, remove solver bonds to other solver nodes
+		m_localBonds.clear();
+		for (uint32_t i = 0; i < localCount; ++i)
+		{
+			const uint32_t node = m_localNodes[i];
+			for (uint32_t adjacencyIndex = m_adjacencyPartition[node]; adjacencyIndex < m_adjacencyPartition[node + 1]; ++adjacencyIndex)
+			{
+				const uint32_t bondIndex = m_blastBondIndexMap[m_adjacentBonds[adjacencyIndex]];
+				if (isInvalidIndex(bondIndex))
+					continue; // removed
+
+				// reset stress, internal bonds stress won't be updated during updateBondStress()
+				BondData& bond = m_bondsData[bondIndex];
+				bond.stress = 0.0f;
+
+				const uint32_t otherNode = bond.node0 == node ? bond.node1 : bond.node0;
+				const uint32_t otherLocalIndex = m_localNodeIndices[otherNode];
+				if (!isInvalidIndex(otherLocalIndex))
+				{
+					if (i < otherLocalIndex)
+					{
+						const LocalBond localBond = { i, otherLocalIndex };
+						m_localBonds.pushBack(localBond);
+					}
+				}
+				else
+				{
+					const BondKey key(solverNodeIndex, m_nodesData[otherNode].solverNode);
+					auto entry = m_solverBondsMap.find(key);
+					if (entry)
+					{
+						removeSolverBond(entry->second, key);
+					}
+				}
+			}
+		}
+
+		// same reduction as syncNodes(), on local aggregates
+		m_localAggregates.resize(localCount);
+		m_localAggregateSizes.resize(localCount);
+		for (uint32_t i = 0; i < localCount; ++i)
+		{
+			m_localAggregates[i] = i;
+			m_localAggregateSizes[i] = 1;
+		}
+
+		for (uint32_t k = 0; k < m_graphReductionLevel; k++)
+		{
+			const uint32_t maxAggregateSize = 1 << (k + 1);
+
+			for (const LocalBond& localBond : m_localBonds)
+			{
+				const NodeData& node0 = m_nodesData[m_localNodes[localBond.node0]];
+				const NodeData& node1 = m_nodesData[m_localNodes[localBond.node1]];
+
+				if (node0.isStatic != node1.isStatic)
+					continue;
+
+				uint32_t& aggregate0 = m_localAggregates[localBond.node0];
+				uint32_t& aggregate1 = m_localAggregates[localBond.node1];
+
+				if (aggregate0 == aggregate1)
+					continue;
+
+				uint32_t& aggregateSize0 = m_localAggregateSizes[aggregate0];
+				uint32_t& aggregateSize1 = m_localAggregateSizes[aggregate1];
+
+				const int countPenalty = node0.isStatic ? STATIC_NODES_COUNT_PENALTY : 1;
+				const uint32_t aggregateSize = std::min<uint32_t>(maxAggregateSize, node0.neighborsCount / 2);
+
+				if (aggregateSize0 * countPenalty >= aggregateSize)
+					continue;
+				if (aggregateSize1 * countPenalty >= aggregateSize)
+					continue;
+
+				if (aggregateSize0 >= aggregateSize1)
+				{
+					aggregateSize1--;
+					aggregateSize0++;
+					aggregate1 = aggregate0;
+				}
+				else
+				{
+					aggregateSize1++;
+					aggregateSize0--;
+					aggregate0 = aggregate1;
+				}
+			}
+		}
+
+		// assign solver nodes to aggregates
+		m_localSolverNodes.resize(localCount);
+		resetSolverNode(m_solverNodesData[solverNodeIndex]);
+		uint32_t nextSolverNode = solverNodeIndex;
+		for (uint32_t i = 0; i < localCount; ++i)
+		{
+			if (m_localAggregateSizes[i] > 0)
+			{
+				m_localSolverNodes[i] = nextSolverNode;
+				if (nextSolverNode == m_solverNodesData.size())
+				{
+					m_solverNodesData.pushBack(SolverNodeData());
+					resetSolverNode(m_solverNodesData.back());
+				}
+				nextSolverNode = m_solverNodesData.size();
+			}
 		}
 
-		m_solver.reset(m_solverNodesData.size());
-		for (uint32_t nodeIndex = 0; nodeIndex < m_solverNodesData.size(); ++nodeIndex)
+		for (uint32_t i = 0; i < localCount; ++i)
 		{
-			const SolverNodeData& solverNode = m_solverNodesData[nodeIndex];
-
-			const float invMass = solverNode.isStatic ? 0.0f : 1.0f / solverNode.mass;
-			const float R = PxPow(solverNode.volume * 3.0f * PxInvPi / 4.0f, 1.0f / 3.0f); // sphere volume approximation
-			const float invI = invMass / (R * R * 0.4f); // sphere inertia tensor approximation: I = 2/5 * M * R^2 ; invI = 1 / I;
-			m_solver.setNodeMassInfo(nodeIndex, invMass, invI);
+			addToSolverNode(m_localNodes[i], m_localSolverNodes[m_localAggregates[i]]);
 		}
 
-		m_nodesDirty = false;
-
-		syncBonds();
-	}
-
-	void syncBonds()
-	{
-		// traverse all blast bonds and aggregate
-		m_solver.clearBonds();
-		m_solverBondsMap.clear();
-		m_solverBondsData.clear();
-		for (BondData& bond : m_bondsData)
+		for (uint32_t i = 0; i < localCount; ++i)
 		{
-			const NodeData& node0 = m_nodesData[bond.node0];
-			const NodeData& node1 = m_nodesData[bond.node1];
-
-			// reset stress, bond structure changed and internal bonds stress won't be updated during updateBondStress()
-			bond.stress = 0.0f;
-
-			if (node0.solverNode == node1.solverNode)
-				continue; // skip (internal)
-
-			if (node0.isStatic && node1.isStatic)
-				continue;
-
-			BondKey key(node0.solverNode, node1.solverNode);
-			auto entry = m_solverBondsMap.find(key);
-			SolverBondData* data;
-			if (!entry)
+			if (m_localAggregateSizes[i] > 0)
 			{
-				m_solverBondsData.pushBack(SolverBondData());
-				data = &m_solverBondsData.back();
-				m_solverBondsMap[key] = m_solverBondsData.size() - 1;
+				const uint32_t index = m_localSolverNodes[i];
+				SolverNodeData& solverNode = m_solverNodesData[index];
+				solverNode.localPos /= (float)solverNode.supportNodesCount;
 
-				SolverNodeData& solverNode0 = m_solverNodesData[node0.solverNode];
-				SolverNodeData& solverNode1 = m_solverNodesData[node1.solverNode];
-				m_solver.addBond(node0.solverNode, node1.solverNode, (solverNode1.localPos - solverNode0.localPos) * 0.5f);
+				float invMass, invI;
+				calcSolverNodeMassInfo(solverNode, invMass, invI);
+				if (index < m_solver.getNodeCount())
+				{
+					m_solver.setNodeMassInfo(index, invMass, invI);
+				}
+				else
+				{
+					const uint32_t solverIndex = m_solver.addNode(invMass, invI);
+					NV_UNUSED(solverIndex);
+					NVBLAST_ASSERT(solverIndex == index);
+				}
 			}
-			else
+		}
+
+		// rebuild solver bonds, the ones between the new aggregates are seen from both sides
+		for (uint32_t i = 0; i < localCount; ++i)
+		{
+			const uint32_t node = m_localNodes[i];
+			for (uint32_t adjacencyIndex = m_adjacencyPartition[node]; adjacencyIndex < m_adjacencyPartition[node + 1]; ++adjacencyIndex)
 			{
-				data = &m_solverBondsData[entry->second];
+				const uint32_t bondIndex = m_blastBondIndexMap[m_adjacentBonds[adjacencyIndex]];
+				if (isInvalidIndex(bondIndex))
+					continue; // removed
+
+				const BondData& bond = m_bondsData[bondIndex];
+				const uint32_t otherNode = bond.node0 == node ? bond.node1 : bond.node0;
+				const uint32_t otherLocalIndex = m_localNodeIndices[otherNode];
+				if (isInvalidIndex(otherLocalIndex) || i < otherLocalIndex)
+				{
+					addToSolverBond(bond);
+				}
 			}
-			data->blastBondIndices.pushBack(bond.blastBondIndex);
 		}
 
-		m_bondsDirty = false;
+		for (uint32_t node : m_localNodes)
+		{
+			m_localNodeIndices[node] = invalidIndex<uint32_t>();
+		}
 	}
 
 #if GRAPH_INTERGRIRY_CHECK
@@ -884,39 +1987,40 @@ private:
 	}
 #endif
 
-	struct BondKey
-	{
-		uint32_t node0;
-		uint32_t node1;
-
-		BondKey(uint32_t n0, uint32_t n1)
-		{
-			node0 = n0 < n1 ? n0 : n1;
-			node1 = n0 < n1 ? n1 : n0;
-		}
-
-		operator uint64_t() const
-		{
-			return static_cast<uint64_t>(node0) + (static_cast<uint64_t>(node1) << 32);
-		}
-	};
-
 	SequentialImpulseSolver			    m_solver;
 	Array<SolverNodeData>::type			m_solverNodesData;
 	Array<SolverBondData>::type			m_solverBondsData;
 
 	uint32_t							m_graphReductionLevel;
 
+	uint32_t							m_reducedSolverNodeCount;	//!< solver nodes count after the last syncNodes()
+
 	bool	                            m_nodesDirty;
 	bool	                            m_bondsDirty;
+	bool								m_structureChanged;		//!< nodes or bonds changed since last solve
+	bool								m_isSleeping;
+	bool								m_hasSolved;			//!< the last solve() call solved
 
 	uint32_t							m_overstressedBondCount;
+	Array<BondData>::type				m_overstressedBonds;
 
 	HashMap<BondKey, uint32_t>::type	m_solverBondsMap;
 	Array<uint32_t>::type				m_blastBondIndexMap;
 
 	Array<BondData>::type				m_bondsData;
 	Array<NodeData>::type				m_nodesData;
+
+	Array<uint32_t>::type				m_adjacencyPartition;	//!< m_adjacentBonds range per node
+	Array<uint32_t>::type				m_adjacentBonds;		//!< blast bond indices
+	Array<uint32_t>::type				m_dirtySolverNodes;		//!< solver nodes to reduce again on next sync
+
+	// reduceSolverNode() scratch
+	Array<uint32_t>::type				m_localNodeIndices;		//!< index in m_localNodes per node, invalid index outside of reduceSolverNode()
+	Array<uint32_t>::type				m_localNodes;
+	Array<LocalBond>::type				m_localBonds;
+	Array<uint32_t>::type				m_localAggregates;
+	Array<uint32_t>::type				m_localAggregateSizes;
+	Array<uint32_t>::type				m_localSolverNodes;
 };
 
 
@@ -942,6 +2046,8 @@ class ExtStressSolverImpl final : public ExtStressSolver
 {
 	NV_NOCOPY(ExtStressSolverImpl)
 
+	friend class ExtStressSolverBatchImpl;
+
 public:
 	ExtStressSolverImpl(NvBlastFamily& family, ExtStressSolverSettings settings);
 	virtual void							release() override;
@@ -974,11 +2080,25 @@ public:
 
 	virtual void							update() override;
 
+	virtual void							prepareUpdate() override;
+
+	virtual void							solveUpdate() override;
+
 	virtual uint32_t						getOverstressedBondCount() const override
 	{
 		return m_graphProcessor->getOverstressedBondCount();
 	}
 
+	virtual float							getBondStress(uint32_t bondIndex) const override
+	{
+		return m_graphProcessor->getBondStress(bondIndex);
+	}
+
+	virtual bool							isSleeping() const override
+	{
+		return m_graphProcessor->isSleeping();
+	}
+
 	virtual void							generateFractureCommands(const NvBlastActor& actor, NvBlastFractureBuffers& commands) override;
 	virtual void							generateFractureCommands(NvBlastFractureBuffers& commands) override;
 	virtual uint32_t						generateFractureCommandsPerActor(const NvBlastActor** actorBuffer, NvBlastFractureBuffers* commandsBuffer, uint32_t bufferSize) override;
@@ -1022,10 +2142,14 @@ private:
 
 	//////// private methods ////////
 
-	void									solve();
+	void									solve(ExtStressSolverDispatcher* dispatcher, uint32_t bondIterationsPerFrame);
 
 	void									fillFractureCommands(const NvBlastActor& actor, NvBlastFractureBuffers& commands);
 
+	bool									getBondFractureData(const SupportGraphProcessor::BondData& bond, NvBlastBondFractureData& data) const;
+
+	const NvBlastActor*						getBondActor(const SupportGraphProcessor::BondData& bond) const;
+
 	void									initialize();
 
 	void									iterate();
@@ -1044,6 +2168,17 @@ private:
 		physx::PxVec3 impulse;
 	};
 
+	struct ActorBondFracture
+	{
+		const NvBlastActor*		actor;
+		NvBlastBondFractureData	data;
+
+		bool operator<(const ActorBondFracture& other) const
+		{
+			return actor < other.actor;
+		}
+	};
+
 	NvBlastFamily&														m_family;
 	HashSet<const NvBlastActor*>::type									m_activeActors;
 	ExtStressSolverSettings												m_settings;
@@ -1051,11 +2186,13 @@ private:
 	bool																m_isDirty;
 	bool																m_reset;
 	const float*														m_bondHealths;
+	Array<float>::type													m_bondHealthsSnapshot;	//!< bond healths taken by prepareUpdate(), for solveUpdate() to run while the family is damaged
 	SupportGraphProcessor*												m_graphProcessor;
 	float																m_errorAngular;
 	float																m_errorLinear;
 	uint32_t															m_framesCount;
 	Array<NvBlastBondFractureData>::type								m_bondFractureBuffer;
+	Array<ActorBondFracture>::type										m_actorBondFractures;
 	Array<uint8_t>::type												m_scratch;
 	Array<DebugLine>::type												m_debugLineBuffer;
 };
@@ -1088,6 +2225,7 @@ ExtStressSolverImpl::ExtStressSolverImpl(NvBlastFamily& family, ExtStressSolverS
 	const uint32_t bondCount = NvBlastAssetGetBondCount(asset, logLL);
 
 	m_bondFractureBuffer.reserve(bondCount);
+	m_bondHealthsSnapshot.resize(bondCount);
 
 	{
 		NvBlastActor* actor;
@@ -1341,19 +2479,35 @@ bool ExtStressSolverImpl::addAngularVelocity(const NvBlastActor& actor, NvcVec3
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void ExtStressSolverImpl::update()
+{
+	prepareUpdate();
+
+	solveUpdate();
+}
+
+void ExtStressSolverImpl::prepareUpdate()
 {
 	initialize();
 
-	solve();
+	m_graphProcessor->sync();
+	m_graphProcessor->snapshotImpulses();
+	memcpy(m_bondHealthsSnapshot.begin(), m_bondHealths, m_bondHealthsSnapshot.size() * sizeof(float));
+}
+
+void ExtStressSolverImpl::solveUpdate()
+{
+	solve(m_settings.dispatcher, m_settings.bondIterationsPerFrame);
 
 	m_framesCount++;
 }
 
-void ExtStressSolverImpl::solve()
+void ExtStressSolverImpl::solve(ExtStressSolverDispatcher* dispatcher, uint32_t bondIterationsPerFrame)
 {
 	PX_SIMD_GUARD;
 
-	m_graphProcessor->solve(m_settings, m_bondHealths, WARM_START && !m_reset);
+	ExtStressSolverSettings settings = m_settings;
+	settings.bondIterationsPerFrame = bondIterationsPerFrame;
+	m_graphProcessor->solve(settings, dispatcher, m_bondHealthsSnapshot.begin(), WARM_START && !m_reset);
 	m_reset = false;
 
 	m_graphProcessor->calcError(m_errorLinear, m_errorAngular);
@@ -1364,41 +2518,39 @@ void ExtStressSolverImpl::solve()
 //													Damage
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool ExtStressSolverImpl::getBondFractureData(const SupportGraphProcessor::BondData& bond, NvBlastBondFractureData& data) const
+{
+	// health may have changed and the bond may have been removed since update()
+	const float bondHealth = m_bondHealths[bond.blastBondIndex];
+	if (bondHealth > 0.0f && m_graphProcessor->getBondStress(bond.blastBondIndex) > bondHealth)
+	{
+		data.userdata = 0;
+		data.nodeIndex0 = bond.node0;
+		data.nodeIndex1 = bond.node1;
+		data.health = bondHealth;
+		return true;
+	}
+	return false;
+}
+
+const NvBlastActor* ExtStressSolverImpl::getBondActor(const SupportGraphProcessor::BondData& bond) const
+{
+	// one of the nodes can be the world node, which has no chunk
+	const uint32_t chunkIndex = !isInvalidIndex(m_graph.chunkIndices[bond.node0]) ? m_graph.chunkIndices[bond.node0] : m_graph.chunkIndices[bond.node1];
+	return NvBlastFamilyGetChunkActor(&m_family, chunkIndex, logLL);
+}
+
 void ExtStressSolverImpl::fillFractureCommands(const NvBlastActor& actor, NvBlastFractureBuffers& commands)
 {
-	const uint32_t graphNodeCount = NvBlastActorGetGraphNodeCount(&actor, logLL);
 	uint32_t commandCount = 0;
 
-	if (graphNodeCount > 1 && m_graphProcessor->getOverstressedBondCount() > 0)
+	for (const SupportGraphProcessor::BondData& bond : m_graphProcessor->getOverstressedBonds())
 	{
-		uint32_t* graphNodeIndices = getScratchArray<uint32_t>(graphNodeCount);
-		const uint32_t nodeCount = NvBlastActorGetGraphNodeIndices(graphNodeIndices, graphNodeCount, &actor, logLL);
-
-		for (uint32_t i = 0; i < nodeCount; ++i)
+		NvBlastBondFractureData data;
+		if (getBondActor(bond) == &actor && getBondFractureData(bond, data))
 		{
-			const uint32_t node0 = graphNodeIndices[i];
-			for (uint32_t adjacencyIndex = m_graph.adjacencyPartition[node0]; adjacencyIndex < m_graph.adjacencyPartition[node0 + 1]; adjacencyIndex++)
-			{
-				uint32_t node1 = m_graph.adjacentNodeIndices[adjacencyIndex];
-				if (node0 < node1)
-				{
-					uint32_t bondIndex = m_graph.adjacentBondIndices[adjacencyIndex];
-					const float bondHealth = m_bondHealths[bondIndex];
-					const float bondStress = m_graphProcessor->getBondStress(bondIndex);
-
-					if (bondHealth > 0.0f && bondStress > bondHealth)
-					{
-						const NvBlastBondFractureData data = {
-							0,
-							node0,
-							node1,
-							bondHealth
-						};
-						m_bondFractureBuffer.pushBack(data);
-						commandCount++;
-					}
-				}
-			}
+			m_bondFractureBuffer.pushBack(data);
+			commandCount++;
 		}
 	}
 
@@ -1418,20 +2570,11 @@ void ExtStressSolverImpl::generateFractureCommands(NvBlastFractureBuffers& comma
 {
 	m_bondFractureBuffer.clear();
 
-	const uint32_t bondCount = m_graphProcessor->getBondCount();
-	const uint32_t overstressedBondCount = m_graphProcessor->getOverstressedBondCount();
-	for (uint32_t i = 0; i < bondCount && m_bondFractureBuffer.size() < overstressedBondCount; i++)
+	for (const SupportGraphProcessor::BondData& bond : m_graphProcessor->getOverstressedBonds())
 	{
-		const auto& bondData = m_graphProcessor->getBondData(i);
-		const float bondHealth = m_bondHealths[bondData.blastBondIndex];
-		if (bondHealth > 0.0f && bondData.stress > bondHealth)
+		NvBlastBondFractureData data;
+		if (getBondFractureData(bond, data))
 		{
-			const NvBlastBondFractureData data = {
-				0,
-				bondData.node0,
-				bondData.node1,
-				bondHealth
-			};
 			m_bondFractureBuffer.pushBack(data);
 		}
 	}
@@ -1447,18 +2590,44 @@ uint32_t ExtStressSolverImpl::generateFractureCommandsPerActor(const NvBlastActo
 	if (m_graphProcessor->getOverstressedBondCount() == 0)
 		return 0;
 
-	m_bondFractureBuffer.clear();
+	// group overstressed bonds by actor
+	m_actorBondFractures.clear();
+	for (const SupportGraphProcessor::BondData& bond : m_graphProcessor->getOverstressedBonds())
+	{
+		ActorBondFracture fracture;
+		if (getBondFractureData(bond, fracture.data))
+		{
+			fracture.actor = getBondActor(bond);
+			if (m_activeActors.contains(fracture.actor))
+			{
+				m_actorBondFractures.pushBack(fracture);
+			}
+		}
+	}
+	std::sort(m_actorBondFractures.begin(), m_actorBondFractures.end());
+
+	m_bondFractureBuffer.resizeUninitialized(m_actorBondFractures.size());
+	for (uint32_t i = 0; i < m_actorBondFractures.size(); ++i)
+	{
+		m_bondFractureBuffer[i] = m_actorBondFractures[i].data;
+	}
+
 	uint32_t index = 0;
-	for (auto it = m_activeActors.getIterator(); !it.done() && index < bufferSize; ++it)
+	for (uint32_t i = 0; i < m_actorBondFractures.size() && index < bufferSize; ++index)
 	{
-		const NvBlastActor* actor = *it;
-		NvBlastFractureBuffers& nextCommand = commandsBuffer[index];
-		fillFractureCommands(*actor, nextCommand);
-		if (nextCommand.bondFractureCount > 0)
+		const NvBlastActor* actor = m_actorBondFractures[i].actor;
+		const uint32_t first = i;
+		while (i < m_actorBondFractures.size() && m_actorBondFractures[i].actor == actor)
 		{
-			actorBuffer[index] = actor;
-			index++;
+			i++;
 		}
+
+		NvBlastFractureBuffers& nextCommand = commandsBuffer[index];
+		nextCommand.chunkFractureCount = 0;
+		nextCommand.chunkFractures = nullptr;
+		nextCommand.bondFractureCount = i - first;
+		nextCommand.bondFractures = m_bondFractureBuffer.begin() + first;
+		actorBuffer[index] = actor;
 	}
 	return index;
 }
@@ -1572,5 +2741,300 @@ const ExtStressSolver::DebugBuffer ExtStressSolverImpl::fillDebugRender(const ui
 }
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//											 ExtStressSolverBatch
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ExtStressSolverBatchImpl final : public ExtStressSolverBatch
+{
+	NV_NOCOPY(ExtStressSolverBatchImpl)
+
+public:
+	ExtStressSolverBatchImpl(ExtStressSolverDispatcher* dispatcher) 
+		: m_dispatcher(dispatcher), m_budget(0.0f), m_costPerBondIteration(INITIAL_COST_PER_BOND_ITERATION), m_bondIterationsPerFrame(0) {}
+
+
+	//////// ExtStressSolverBatch interface ////////
+
+	virtual void							release() override
+	{
+		NVBLAST_DELETE(this, ExtStressSolverBatchImpl);
+	}
+
+	virtual void							setDispatcher(ExtStressSolverDispatcher* dispatcher) override
+	{
+		m_dispatcher = dispatcher;
+	}
+
+	virtual bool							addSolver(ExtStressSolver& solver) override;
+
+	virtual bool							removeSolver(ExtStressSolver& solver) override;
+
+	virtual uint32_t						getSolverCount() const override
+	{
+		return m_solvers.size();
+	}
+
+	virtual void							update() override;
+
+	virtual uint32_t						getOverstressedSolvers(ExtStressSolver** buffer, uint32_t bufferSize) const override;
+
+	virtual void							setBudget(float microseconds) override
+	{
+		m_budget = microseconds;
+	}
+
+	virtual float							getBudget() const override
+	{
+		return m_budget;
+	}
+
+	virtual bool							setSolverWeight(ExtStressSolver& solver, float weight) override;
+
+	virtual uint32_t						getBondIterationsPerFrame() const override
+	{
+		return m_bondIterationsPerFrame;
+	}
+
+private:
+	enum
+	{
+		JOB_BOND_COUNT = 4096	//!< solvers are grouped into jobs of about this many bonds
+	};
+
+	/**
+	Range of m_solvers solved by one job.
+	*/
+	struct Job
+	{
+		uint32_t	begin;
+		uint32_t	end;
+	};
+
+	/**
+	Budget sharing state of a solver, m_schedules[i] belongs to m_solvers[i].
+	*/
+	struct SolverSchedule
+	{
+		float		weight;				//!< user importance weight
+		float		structureChange;	//!< 1 on the frame the support graph changed, decays on the next frames
+		float		demand;				//!< share of the budget wanted this frame
+		uint32_t	bondIterations;		//!< bond iterations per frame of the next solve
+	};
+
+	void									schedule();
+
+	/**
+	Bond count the iterations of a solver are counted with, matching ExtStressSolver::getIterationsPerFrame() on the synced solver graph.
+	*/
+	static uint32_t							getScheduledBondCount(const ExtStressSolverImpl* solver)
+	{
+		return solver->m_graphProcessor->getSolverBondCount() + 1;
+	}
+
+	static void								solveJob(void* jobData, uint32_t jobIndex);
+
+
+	//////// data ////////
+
+	ExtStressSolverDispatcher*				m_dispatcher;
+	Array<ExtStressSolverImpl*>::type		m_solvers;
+	Array<SolverSchedule>::type				m_schedules;
+	Array<Job>::type						m_jobs;
+	float									m_budget;					//!< microseconds, 0 if disabled
+	float									m_costPerBondIteration;		//!< microseconds, measured on previous updates
+	uint32_t								m_bondIterationsPerFrame;	//!< total scheduled by the last update()
+};
+
+
+ExtStressSolverBatch* ExtStressSolverBatch::create(ExtStressSolverDispatcher* dispatcher)
+{
+	return NVBLAST_NEW(ExtStressSolverBatchImpl) (dispatcher);
+}
+
+bool ExtStressSolverBatchImpl::addSolver(ExtStressSolver& solver)
+{
+	ExtStressSolverImpl* solverImpl = static_cast<ExtStressSolverImpl*>(&solver);
+	if (m_solvers.find(solverImpl) != m_solvers.end())
+	{
+		return false;
+	}
+	m_solvers.pushBack(solverImpl);
+
+	const SolverSchedule schedule = { 1.0f, 1.0f, 0.0f, 0 };
+	m_schedules.pushBack(schedule);
+	return true;
+}
+
+bool ExtStressSolverBatchImpl::removeSolver(ExtStressSolver& solver)
+{
+	ExtStressSolverImpl** it = m_solvers.find(static_cast<ExtStressSolverImpl*>(&solver));
+	if (it == m_solvers.end())
+	{
+		return false;
+	}
+	const uint32_t index = static_cast<uint32_t>(it - m_solvers.begin());
+	m_solvers.replaceWithLast(index);
+	m_schedules.replaceWithLast(index);
+	return true;
+}
+
+bool ExtStressSolverBatchImpl::setSolverWeight(ExtStressSolver& solver, float weight)
+{
+	ExtStressSolverImpl** it = m_solvers.find(static_cast<ExtStressSolverImpl*>(&solver));
+	if (it == m_solvers.end())
+	{
+		return false;
+	}
+	m_schedules[static_cast<uint32_t>(it - m_solvers.begin())].weight = std::max(weight, 0.0f);
+	return true;
+}
+
+void ExtStressSolverBatchImpl::update()
+{
+	// graph sync reads the families, keep it on the calling thread, the schedule then sees the synced solver bond counts
+	m_jobs.clear();
+	uint32_t jobBondCount = JOB_BOND_COUNT;
+	for (uint32_t i = 0; i < m_solvers.size(); ++i)
+	{
+		ExtStressSolverImpl* solver = m_solvers[i];
+		solver->prepareUpdate();
+
+		if (jobBondCount >= JOB_BOND_COUNT)
+		{
+			const Job job = { i, i };
+			m_jobs.pushBack(job);
+			jobBondCount = 0;
+		}
+		m_jobs.back().end = i + 1;
+		jobBondCount += getScheduledBondCount(solver);
+	}
+
+	schedule();
+
+	Time time;
+
+	if (m_dispatcher != nullptr && m_jobs.size() > 1)
+	{
+		m_dispatcher->parallelFor(m_jobs.size(), solveJob, this);
+	}
+	else
+	{
+		for (uint32_t i = 0; i < m_jobs.size(); ++i)
+		{
+			solveJob(this, i);
+		}
+	}
+
+	// measure the cost of the bond iterations actually run, solvers sleeping through the frame barely cost anything, the sync is not timed
+	const float elapsed = static_cast<float>(Time::seconds(time.getElapsedTicks()) * 1.0e6);
+	uint32_t solvedBondIterations = 0;
+	for (uint32_t i = 0; i < m_solvers.size(); ++i)
+	{
+		if (m_solvers[i]->m_graphProcessor->hasSolved())
+		{
+			// the solve runs whole iterations over all the solver bonds, see SupportGraphProcessor::solve
+			const uint32_t bondCount = getScheduledBondCount(m_solvers[i]);
+			solvedBondIterations += std::max(m_schedules[i].bondIterations / bondCount, 1u) * bondCount;
+		}
+	}
+	if (solvedBondIterations > 0)
+	{
+		const float cost = elapsed / solvedBondIterations;
+		m_costPerBondIteration += (cost - m_costPerBondIteration) * COST_SMOOTHING;
+	}
+}
+
+void ExtStressSolverBatchImpl::schedule()
+{
+	m_bondIterationsPerFrame = 0;
+
+	// mean error per bond, to rank solvers against each other regardless of their units
+	float errorSum = 0.0f;
+	uint32_t errorCount = 0;
+	uint32_t minBondIterations = 0;
+	for (uint32_t i = 0; i < m_solvers.size(); ++i)
+	{
+		const ExtStressSolverImpl* solver = m_solvers[i];
+		SolverSchedule& schedule = m_schedules[i];
+		schedule.structureChange = solver->m_graphProcessor->hasStructureChanged() ? 1.0f : schedule.structureChange * STRUCTURE_CHANGE_DECAY;
+		schedule.bondIterations = solver->getSettings().bondIterationsPerFrame;
+
+		const uint32_t bondCount = getScheduledBondCount(solver);
+		minBondIterations += bondCount;
+		if (solver->getFrameCount() > 0)
+		{
+			errorSum += (solver->getStressErrorLinear() + solver->getStressErrorAngular()) / bondCount;
+			errorCount++;
+		}
+	}
+
+	if (m_budget <= 0.0f)
+	{
+		for (const SolverSchedule& schedule : m_schedules)
+		{
+			m_bondIterationsPerFrame += schedule.bondIterations;
+		}
+		return;
+	}
+
+	const float meanError = errorCount > 0 ? errorSum / errorCount : 0.0f;
+	float totalDemand = 0.0f;
+	for (uint32_t i = 0; i < m_solvers.size(); ++i)
+	{
+		const ExtStressSolverImpl* solver = m_solvers[i];
+		SolverSchedule& schedule = m_schedules[i];
+		const uint32_t bondCount = getScheduledBondCount(solver);
+
+		float relativeError = 1.0f;
+		if (solver->getFrameCount() > 0 && meanError > 0.0f)
+		{
+			relativeError = std::min((solver->getStressErrorLinear() + solver->getStressErrorAngular()) / bondCount / meanError, MAX_RELATIVE_ERROR);
+		}
+
+		schedule.demand = solver->isSleeping() ? 0.0f : schedule.weight * bondCount * (relativeError + STRUCTURE_CHANGE_PRIORITY * schedule.structureChange);
+		totalDemand += schedule.demand;
+	}
+
+	// every solver gets at least one iteration, the rest is shared by demand
+	const float budgetBondIterations = m_budget / std::max(m_costPerBondIteration, MIN_COST_PER_BOND_ITERATION);
+	const float sharedBondIterations = std::max(budgetBondIterations - minBondIterations, 0.0f);
+	for (uint32_t i = 0; i < m_solvers.size(); ++i)
+	{
+		SolverSchedule& schedule = m_schedules[i];
+		const uint32_t bondCount = getScheduledBondCount(m_solvers[i]);
+		const float share = totalDemand > 0.0f ? sharedBondIterations * schedule.demand / totalDemand : 0.0f;
+		const float bondIterations = std::min(bondCount + share, static_cast<float>(schedule.bondIterations));
+		schedule.bondIterations = std::max(static_cast<uint32_t>(bondIterations), bondCount);
+		m_bondIterationsPerFrame += schedule.bondIterations;
+	}
+}
+
+void ExtStressSolverBatchImpl::solveJob(void* jobData, uint32_t jobIndex)
+{
+	ExtStressSolverBatchImpl* batch = static_cast<ExtStressSolverBatchImpl*>(jobData);
+	const Job& job = batch->m_jobs[jobIndex];
+	for (uint32_t i = job.begin; i < job.end; ++i)
+	{
+		ExtStressSolverImpl* solver = batch->m_solvers[i];
+		solver->solve(nullptr, batch->m_schedules[i].bondIterations);
+		solver->m_framesCount++;
+	}
+}
+
+uint32_t ExtStressSolverBatchImpl::getOverstressedSolvers(ExtStressSolver** buffer, uint32_t bufferSize) const
+{
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < m_solvers.size() && count < bufferSize; ++i)
+	{
+		if (m_solvers[i]->getOverstressedBondCount() > 0)
+		{
+			buffer[count++] = m_solvers[i];
+		}
+	}
+	return count;
+}
+
+
 } // namespace Blast
 } // namespace Nv
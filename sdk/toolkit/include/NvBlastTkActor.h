@@ -171,6 +171,9 @@ public:
 
 	It's the user's responsibility to keep programParams pointer alive until the group endProcess() call.
 
+	Damage is applied in the order it was queued, unless the group has a damage coalescer which reorders it by program,
+	see TkGroup::setDamageCoalescer and TkGroup::setMaxDamageCount.
+
 	\param[in] program				A NvBlastDamageProgram containing damage shaders.
 	\param[in] programParams		Parameters for the NvBlastDamageProgram.
 	*/
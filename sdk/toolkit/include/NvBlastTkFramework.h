@@ -151,6 +151,25 @@ struct TkTypeIndex
 };
 
 
+/**
+Handle to a TkIdentifiable object, resolved in constant time by TkFramework::resolveObjectHandle.
+
+The generation distinguishes objects that successively used the same slot in the framework's object table,
+such that a handle to a released object resolves to NULL even if the slot has been reused since.
+*/
+struct TkObjectHandle
+{
+	uint32_t	index;		//!< Slot of the object in the framework's object table
+	uint32_t	generation;	//!< Generation of the slot when the object was registered, never 0 for a valid handle
+
+	/** Constructor creates an invalid handle */
+	TkObjectHandle() : index(0xFFFFFFFF), generation(0) {}
+
+	/** \return true if this handle was ever issued by the framework, it may still refer to a released object */
+	bool	isValid() const { return generation != 0; }
+};
+
+
 /**
 BlastTk Framework.
 
@@ -206,6 +225,26 @@ public:
 	*/
 	virtual uint32_t		getObjects(TkIdentifiable** buffer, uint32_t bufferSize, const TkType& type, uint32_t indexStart = 0) const = 0;
 
+	/**
+	Get a handle to a TkIdentifiable-derived object, which remains the same for the object's lifetime (even if its ID changes).
+	Resolving the handle with resolveObjectHandle does not search or hash, which makes it preferable to findObjectByID
+	for repeated lookups of the same objects.
+
+	\param[in]	object	The object to get a handle for.
+
+	\return the handle for the object, or an invalid handle if the object is not tracked by the framework.
+	*/
+	virtual TkObjectHandle	getObjectHandle(const TkIdentifiable& object) const = 0;
+
+	/**
+	Resolve a handle previously obtained with getObjectHandle.
+
+	\param[in]	handle	The handle to resolve.
+
+	\return pointer to the object if it still exists, NULL otherwise.
+	*/
+	virtual TkIdentifiable*	resolveObjectHandle(const TkObjectHandle& handle) const = 0;
+
 	//////// Asset creation ////////
 	/**
 	Helper function to build and apply chunk reorder map, so that chunk descriptors are properly ordered for the createAsset function.
@@ -63,6 +63,39 @@ struct TkGroupStats
 };
 
 
+/**
+Merges damage queued on the same TkActor with the same NvBlastDamageProgram into a single damage pass, see TkGroup::setDamageCoalescer.
+The toolkit does not know the layout of program params, a coalescer implements the combination for the programs it supports.
+
+The functions are called from TkGroupWorker::process and must be safe to call concurrently.
+*/
+class TkDamageCoalescer
+{
+public:
+	/**
+	The size of the program params resulting from combining paramsCount program params queued with program.
+
+	\param[in]	program			The damage program the params were queued with.
+	\param[in]	programParams	The queued program params, in the order they were queued.
+	\param[in]	paramsCount		The number of program params to combine.
+
+	\return the size in bytes of the combined program params, 0 if the damage queued with this program cannot be combined.
+	*/
+	virtual size_t	getCombinedParamsSize(const NvBlastDamageProgram& program, const void* const* programParams, uint32_t paramsCount) const = 0;
+
+	/**
+	Combine program params queued with the same damage program into one program params, applying the damage of them all.
+
+	\param[out]	combinedParams	Memory of getCombinedParamsSize(program, programParams, paramsCount) bytes to write the combined program params to.
+	\param[in]	program			The damage program the params were queued with.
+	\param[in]	programParams	The queued program params, in the order they were queued.
+	\param[in]	paramsCount		The number of program params to combine.
+	\param[in]	damageScale		Scale to apply to the damage amounts, less than 1 when the actor exceeded the group's maximum damage count.
+	*/
+	virtual void	combineParams(void* combinedParams, const NvBlastDamageProgram& program, const void* const* programParams, uint32_t paramsCount, float damageScale) const = 0;
+};
+
+
 /**
 A worker as provided by TkGroup::acquireWorker(). It manages the necessary memory for parallel processing.
 The group can be processed concurrently by calling process() from different threads using a different TkGroupWorker each.
@@ -173,6 +206,39 @@ public:
 	*/
 	virtual void			returnWorker(TkGroupWorker*) = 0;
 
+	/**
+	Enable or disable thread-affine workers. When enabled, acquireWorker() returns to a thread the worker it used last
+	whenever that worker is available, such that the worker's memory is likely still in that thread's cache.
+	A thread acquiring a worker for the first time is preferably given a worker not used by any other thread yet.
+
+	\param[in]	enabled		true to enable thread-affine workers, false to acquire any available worker (the default).
+	*/
+	virtual void			setThreadAffineWorkers(bool enabled) = 0;
+
+	/**
+	Set the coalescer merging the damage queued on each actor with the same program into a single damage pass.
+	Damage is then applied grouped by program rather than in the order it was queued: the damage of one program keeps its
+	queued order, but the programs are applied in an unspecified order (that of their shader function addresses).
+	Since every pass sees the health left by the previous ones, the fractures of a process may differ from the uncoalesced ones.
+	ExtDamageCoalescer (NvBlastExtDamageCoalescer.h) supports the radial, capsule and cutter programs of the shaders extension.
+
+	\param[in]	coalescer	The coalescer to use, it must outlive this group. NULL disables coalescing (the default).
+	*/
+	virtual void			setDamageCoalescer(const TkDamageCoalescer* coalescer) = 0;
+
+	/**
+	Set the maximum number of damage passes applied to an actor per process, combined passes included.
+
+	When more damage than maxDamageCount was queued on an actor, the damage combined by the damage coalescer is scaled down
+	by maxDamageCount / (queued damage count), such that the aggregate damage applied matches maxDamageCount damage calls.
+	Damage that could not be combined is applied in the order it was queued until maxDamageCount passes have been applied, the rest is dropped.
+	Without a damage coalescer (see setDamageCoalescer) no damage can be combined: only the first maxDamageCount damage calls are applied
+	and a warning is logged.
+
+	\param[in]	maxDamageCount	The maximum number of damage passes per actor, 0 for no limit (the default).
+	*/
+	virtual void			setMaxDamageCount(uint32_t maxDamageCount) = 0;
+
 	/**
 	Helper function to process the group synchronously on a single thread.
 	*/
@@ -32,6 +32,7 @@
 
 #include "NvBlast.h"
 #include "NvBlastMemory.h"
+#include "NvBlastIndexFns.h"
 
 
 namespace Nv
@@ -48,12 +49,14 @@ NVBLASTTK_DEFINE_TYPE_IDENTIFIABLE(Asset);
 
 TkAssetImpl::TkAssetImpl()
 	: m_assetLL(nullptr), m_ownsAsset(false)
+	, m_bondCount(0), m_lowerSupportChunkCount(0), m_maxNodeBondCount(0), m_worldNodeBondCount(0), m_maxNodeChunkCount(0)
 {
 }
 
 
 TkAssetImpl::TkAssetImpl(const NvBlastID& id)
 	: TkAssetType(id), m_assetLL(nullptr), m_ownsAsset(false)
+	, m_bondCount(0), m_lowerSupportChunkCount(0), m_maxNodeBondCount(0), m_worldNodeBondCount(0), m_maxNodeChunkCount(0)
 {
 }
 
@@ -167,6 +170,8 @@ TkAssetImpl* TkAssetImpl::create(const TkAssetDesc& desc)
 		return nullptr;
 	}
 
+	asset->initializeFractureBounds();
+
 	if (desc.bondFlags != nullptr)
 	{
 		for (uint32_t bondN = 0; bondN < desc.bondCount; ++bondN)
@@ -213,6 +218,8 @@ TkAssetImpl* TkAssetImpl::create(const NvBlastAsset* assetLL, Nv::Blast::TkAsset
 	asset->m_ownsAsset = ownsAsset;
 	asset->setID(NvBlastAssetGetID(asset->m_assetLL, logLL));
 
+	asset->initializeFractureBounds();
+
 	asset->m_jointDescs.resize(jointDescCount);
 	for (uint32_t i = 0; i < asset->m_jointDescs.size(); ++i)
 	{
@@ -222,6 +229,53 @@ TkAssetImpl* TkAssetImpl::create(const NvBlastAsset* assetLL, Nv::Blast::TkAsset
 	return asset;
 }
 
+void TkAssetImpl::initializeFractureBounds()
+{
+	const NvBlastSupportGraph graph = getGraph();
+	const NvBlastChunk* chunks = getChunks();
+	const uint32_t chunkCount = getChunkCount();
+
+	// count the chunks in every chunk's subtree, children are always stored after their parent
+	Array<uint32_t>::type subtreeChunkCounts(chunkCount);
+	for (uint32_t chunkIndex = chunkCount; chunkIndex-- > 0;)
+	{
+		const NvBlastChunk& chunk = chunks[chunkIndex];
+		uint32_t subtreeChunkCount = 1;
+		for (uint32_t childIndex = chunk.firstChildIndex; childIndex < chunk.childIndexStop; ++childIndex)
+		{
+			subtreeChunkCount += subtreeChunkCounts[childIndex];
+		}
+		subtreeChunkCounts[chunkIndex] = subtreeChunkCount;
+	}
+
+	m_bondCount = getBondCount();
+	m_lowerSupportChunkCount = 0;
+	m_maxNodeBondCount = 0;
+	m_worldNodeBondCount = 0;
+	m_maxNodeChunkCount = 0;
+	for (uint32_t node = 0; node < graph.nodeCount; ++node)
+	{
+		const uint32_t nodeBondCount = graph.adjacencyPartition[node + 1] - graph.adjacencyPartition[node];
+		const uint32_t chunkIndex = graph.chunkIndices[node];
+		if (isInvalidIndex(chunkIndex))
+		{
+			m_worldNodeBondCount = nodeBondCount;
+			continue;
+		}
+
+		m_lowerSupportChunkCount += subtreeChunkCounts[chunkIndex];
+		if (nodeBondCount > m_maxNodeBondCount)
+		{
+			m_maxNodeBondCount = nodeBondCount;
+		}
+		if (subtreeChunkCounts[chunkIndex] > m_maxNodeChunkCount)
+		{
+			m_maxNodeChunkCount = subtreeChunkCounts[chunkIndex];
+		}
+	}
+}
+
+
 bool TkAssetImpl::addJointDesc(uint32_t chunkIndex0, uint32_t chunkIndex1)
 {
 	if (m_assetLL == nullptr)
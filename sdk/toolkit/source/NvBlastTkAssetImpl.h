@@ -96,6 +96,24 @@ public:
 	*/
 	const TkAssetJointDesc*				getJointDescsInternal() const;
 
+	/**
+	Upper bound of the bond fracture data generated or applied in a single damage step for an actor of this asset.
+
+	\param[in]	graphNodeCount	The number of graph nodes in the actor.
+
+	\return the maximum number of NvBlastBondFractureData needed.
+	*/
+	uint32_t							getMaxBondFractureCount(uint32_t graphNodeCount) const;
+
+	/**
+	Upper bound of the chunk fracture data generated or applied in a single damage step for an actor of this asset.
+
+	\param[in]	graphNodeCount	The number of graph nodes in the actor, 0 for a subsupport chunk actor.
+
+	\return the maximum number of NvBlastChunkFractureData needed.
+	*/
+	uint32_t							getMaxChunkFractureCount(uint32_t graphNodeCount) const;
+
 	// Begin TkAsset
 	virtual const NvBlastAsset*			getAssetLL() const override;
 
@@ -131,9 +149,21 @@ private:
 	*/
 	bool								addJointDesc(uint32_t chunkIndex0, uint32_t chunkIndex1);
 
+	/**
+	Gathers the per-node counts used by getMaxBondFractureCount and getMaxChunkFractureCount.
+	To be called once the low-level asset is set.
+	*/
+	void								initializeFractureBounds();
+
 	NvBlastAsset*					m_assetLL;		//!< The underlying low-level asset.
 	Array<TkAssetJointDesc>::type	m_jointDescs;	//!< The array of internal joint descriptors.
 	bool							m_ownsAsset;	//!< Whether or not this asset should release its low-level asset upon its own release.
+
+	uint32_t						m_bondCount;				//!< Total number of bonds in the asset.
+	uint32_t						m_lowerSupportChunkCount;	//!< Total number of support and subsupport chunks in the asset.
+	uint32_t						m_maxNodeBondCount;			//!< Largest number of bonds attached to a single chunk graph node.
+	uint32_t						m_worldNodeBondCount;		//!< Number of bonds attached to the world node, if any.
+	uint32_t						m_maxNodeChunkCount;		//!< Largest number of lower-support chunks below and including a single support chunk.
 };
 
 
@@ -156,6 +186,22 @@ NV_INLINE const TkAssetJointDesc* TkAssetImpl::getJointDescsInternal() const
 	return m_jointDescs.begin();
 }
 
+
+NV_INLINE uint32_t TkAssetImpl::getMaxBondFractureCount(uint32_t graphNodeCount) const
+{
+	// the world node, if part of the actor, is accounted for separately as it can hold many more bonds than any chunk node
+	const uint64_t bound = uint64_t(graphNodeCount) * m_maxNodeBondCount + m_worldNodeBondCount;
+	return bound < m_bondCount ? static_cast<uint32_t>(bound) : m_bondCount;
+}
+
+
+NV_INLINE uint32_t TkAssetImpl::getMaxChunkFractureCount(uint32_t graphNodeCount) const
+{
+	// a subsupport chunk actor has no graph node but is bounded by the size of a support chunk's subtree as well
+	const uint64_t bound = uint64_t(graphNodeCount > 0 ? graphNodeCount : 1) * m_maxNodeChunkCount;
+	return bound < m_lowerSupportChunkCount ? static_cast<uint32_t>(bound) : m_lowerSupportChunkCount;
+}
+
 } // namespace Blast
 } // namespace Nv
 
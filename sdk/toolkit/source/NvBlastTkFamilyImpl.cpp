@@ -432,17 +432,7 @@ void TkFamilyImpl::updateJoints(TkActorImpl* actor, TkEventQueue* alternateQueue
 	jointHandle = joints;
 	while (jointHandle < stop)
 	{
-		TkJointImpl* joint = *jointHandle++;
-		
-		const TkJointData& data = joint->getDataInternal();
-
-		TkActorImpl* actor0 = data.actors[0] != nullptr ?
-			static_cast<TkActorImpl&>(*data.actors[0]).getFamilyImpl().getActorByChunk(data.chunkIndices[0]) : nullptr;
-
-		TkActorImpl* actor1 = data.actors[1] != nullptr ?
-			static_cast<TkActorImpl&>(*data.actors[1]).getFamilyImpl().getActorByChunk(data.chunkIndices[1]) : nullptr;
-
-		joint->setActors(actor0, actor1, alternateQueue);
+		(*jointHandle++)->rebindActors(alternateQueue);
 	}
 }
 
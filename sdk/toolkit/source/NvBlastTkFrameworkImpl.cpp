@@ -115,10 +115,12 @@ bool TkFrameworkImpl::set(TkFrameworkImpl* framework)
 
 TkFrameworkImpl::TkFrameworkImpl()
 	: TkFramework()
+	, m_firstFreeSlot(invalidIndex<uint32_t>())
 {
 	// Register types
 	m_types.resize(TkTypeIndex::TypeCount);
 	m_objects.resize(TkTypeIndex::TypeCount);
+	m_objectSlotIndices.resize(TkTypeIndex::TypeCount);
 	NVBLASTTK_REGISTER_TYPE(Asset);
 	NVBLASTTK_REGISTER_TYPE(Family);
 	NVBLASTTK_REGISTER_TYPE(Group);
@@ -223,6 +225,30 @@ uint32_t TkFrameworkImpl::getObjects(TkIdentifiable** buffer, uint32_t bufferSiz
 }
 
 
+TkObjectHandle TkFrameworkImpl::getObjectHandle(const TkIdentifiable& object) const
+{
+	TkObjectHandle handle;
+
+	const auto entry = m_objectToSlot.find(&object);
+	if (entry == nullptr)
+	{
+		NVBLAST_LOG_WARNING("TkFrameworkImpl::getObjectHandle: object not tracked by the framework.");
+		return handle;
+	}
+
+	handle.index = entry->second;
+	handle.generation = m_objectSlots[handle.index].generation;
+
+	return handle;
+}
+
+
+TkIdentifiable* TkFrameworkImpl::resolveObjectHandle(const TkObjectHandle& handle) const
+{
+	return resolveObjectHandleInternal(handle);
+}
+
+
 bool TkFrameworkImpl::reorderAssetDescChunks(NvBlastChunkDesc* chunkDescs, uint32_t chunkCount, NvBlastBondDesc* bondDescs, uint32_t bondCount, uint32_t* chunkReorderMap /*= nullptr*/, bool keepBondNormalChunkOrder /*= false*/) const
 {
 	uint32_t* map = chunkReorderMap != nullptr ? chunkReorderMap : static_cast<uint32_t*>(NVBLAST_ALLOC_NAMED(chunkCount * sizeof(uint32_t), "reorderAssetDescChunks:chunkReorderMap"));
@@ -368,9 +394,29 @@ void TkFrameworkImpl::onCreate(TkIdentifiable& object)
 		return;
 	}
 
+	NVBLAST_ASSERT(m_objectToSlot.find(&object) == nullptr);
+
+	// take a slot in the object table, reusing released ones first
+	uint32_t slotIndex = m_firstFreeSlot;
+	if (!isInvalidIndex(slotIndex))
+	{
+		m_firstFreeSlot = m_objectSlots[slotIndex].link;
+	}
+	else
+	{
+		slotIndex = m_objectSlots.size();
+		ObjectSlot& newSlot = m_objectSlots.insert();
+		newSlot.generation = 1;
+	}
+
 	auto& objectArray = m_objects[index];
-	NVBLAST_ASSERT(objectArray.find(&object) == objectArray.end());
+	ObjectSlot& slot = m_objectSlots[slotIndex];
+	slot.object = &object;
+	slot.link = objectArray.size();
+	m_objectToSlot[&object] = slotIndex;
+
 	objectArray.pushBack(&object);
+	m_objectSlotIndices[index].pushBack(slotIndex);
 }
 
 
@@ -397,8 +443,37 @@ void TkFrameworkImpl::onDestroy(TkIdentifiable& object)
 		return;
 	}
 
+	HashMap<const TkIdentifiable*, uint32_t>::type::Entry entry;
+	if (!m_objectToSlot.erase(&object, entry))
+	{
+		NVBLAST_LOG_ERROR("TkFrameworkImpl::removeObject: object not tracked.");
+		return;
+	}
+
+	// remove from object list in constant time, updating the slot of the object moved in its place
+	const uint32_t slotIndex = entry.second;
+	ObjectSlot& slot = m_objectSlots[slotIndex];
+	NVBLAST_ASSERT(slot.object == &object);
+	const uint32_t objectIndex = slot.link;
+
 	auto& objectArray = m_objects[index];
-	objectArray.findAndReplaceWithLast(&object);
+	auto& slotIndices = m_objectSlotIndices[index];
+	NVBLAST_ASSERT(objectArray[objectIndex] == &object);
+	objectArray.replaceWithLast(objectIndex);
+	slotIndices.replaceWithLast(objectIndex);
+	if (objectIndex < objectArray.size())
+	{
+		m_objectSlots[slotIndices[objectIndex]].link = objectIndex;
+	}
+
+	// release the slot, invalidating outstanding handles
+	slot.object = nullptr;
+	if (++slot.generation == 0)
+	{
+		slot.generation = 1;
+	}
+	slot.link = m_firstFreeSlot;
+	m_firstFreeSlot = slotIndex;
 }
 
 
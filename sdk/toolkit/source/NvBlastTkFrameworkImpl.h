@@ -33,6 +33,7 @@
 #include "NvBlastProfilerInternal.h"
 
 #include "NvBlastTkCommon.h"
+#include "NvBlastTkScratchPool.h"
 
 #include "NvBlastArray.h"
 #include "NvBlastHashMap.h"
@@ -68,6 +69,10 @@ public:
 
 	virtual uint32_t					getObjects(TkIdentifiable** buffer, uint32_t bufferSize, const TkType& type, uint32_t indexStart = 0) const override;
 
+	virtual TkObjectHandle				getObjectHandle(const TkIdentifiable& object) const override;
+
+	virtual TkIdentifiable*				resolveObjectHandle(const TkObjectHandle& handle) const override;
+
 	virtual bool						reorderAssetDescChunks(NvBlastChunkDesc* chunkDescs, uint32_t chunkCount, NvBlastBondDesc* bondDescs, uint32_t bondCount, uint32_t* chunkReorderMap = nullptr, bool keepBondNormalChunkOrder = false) const override;
 
 	virtual bool						ensureAssetExactSupportCoverage(NvBlastChunkDesc* chunkDescs, uint32_t chunkCount) const override;
@@ -114,6 +119,16 @@ public:
 	*/
 	TkIdentifiable*						findObjectByIDInternal(const NvBlastID& id) const;
 
+	/**
+	Internal (non-virtual) method to resolve a TkObjectHandle.
+	*/
+	TkIdentifiable*						resolveObjectHandleInternal(const TkObjectHandle& handle) const;
+
+	/**
+	Access to the scratch memory pool shared by all groups for processing.
+	*/
+	TkScratchPool&						getScratchPool();
+
 	// Access to singleton
 
 	/** Retrieve the global singleton. */
@@ -133,12 +148,29 @@ private:
 	InlineArray<const TkTypeImpl*, TkTypeIndex::TypeCount>::type				m_types;				//!< TkIdentifiable static type data
 	HashMap<uint32_t, uint32_t>::type											m_typeIDToIndex;		//!< Map to type data keyed by ClassID
 
+	/**
+	Entry of the object table, indexed by TkObjectHandle::index.
+	*/
+	struct ObjectSlot
+	{
+		TkIdentifiable*	object;			//!< The object using this slot, NULL if the slot is free
+		uint32_t		generation;		//!< Incremented every time the slot is released, starting at 1
+		uint32_t		link;			//!< Index of the object in its m_objects array when used, next free slot otherwise
+	};
+
 	// Objects and object names
 	HashMap<NvBlastID, TkIdentifiable*>::type									m_IDToObject;			//!< Map to all TkIdentifiable objects, keyed by NvBlastID
-	InlineArray<Array<TkIdentifiable*>::type, TkTypeIndex::TypeCount>::type		m_objects;				//!< Catalog of all TkIdentifiable objects, grouped by type.  (Revisit implementation.)
+	InlineArray<Array<TkIdentifiable*>::type, TkTypeIndex::TypeCount>::type		m_objects;				//!< Catalog of all TkIdentifiable objects, grouped by type
+	InlineArray<Array<uint32_t>::type, TkTypeIndex::TypeCount>::type			m_objectSlotIndices;	//!< Slot of every object in m_objects, grouped by type
+	HashMap<const TkIdentifiable*, uint32_t>::type								m_objectToSlot;			//!< Map to all TkIdentifiable objects' slots
+	Array<ObjectSlot>::type														m_objectSlots;			//!< Object table indexed by TkObjectHandle
+	uint32_t																	m_firstFreeSlot;		//!< Head of the free slot list in m_objectSlots
 
 	// Track external joints (to do: make this a pool)
 	HashSet<TkJointImpl*>::type													m_joints;				//!< All internal joints
+
+	// Processing memory
+	TkScratchPool																m_scratchPool;			//!< Transient memory shared by all groups' workers
 };
 
 
@@ -155,6 +187,24 @@ NV_INLINE TkIdentifiable* TkFrameworkImpl::findObjectByIDInternal(const NvBlastI
 	return entry->second;
 }
 
+
+NV_INLINE TkIdentifiable* TkFrameworkImpl::resolveObjectHandleInternal(const TkObjectHandle& handle) const
+{
+	if (handle.index >= m_objectSlots.size())
+	{
+		return nullptr;
+	}
+
+	const ObjectSlot& slot = m_objectSlots[handle.index];
+	return slot.generation == handle.generation ? slot.object : nullptr;
+}
+
+
+NV_INLINE TkScratchPool& TkFrameworkImpl::getScratchPool()
+{
+	return m_scratchPool;
+}
+
 } // namespace Blast
 } // namespace Nv
 
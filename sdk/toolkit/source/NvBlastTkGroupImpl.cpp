@@ -37,6 +37,7 @@
 #include "NvBlastTkFamilyImpl.h"
 #include "NvBlastTkAssetImpl.h"
 #include "NvBlastTkTaskImpl.h"
+#include "NvBlastTkJointImpl.h"
 
 #undef max
 #undef min
@@ -57,7 +58,8 @@ NVBLASTTK_DEFINE_TYPE_IDENTIFIABLE(Group);
 
 //////// Member functions ////////
 
-TkGroupImpl::TkGroupImpl() : m_actorCount(0), m_isProcessing(false)
+TkGroupImpl::TkGroupImpl() : m_actorCount(0), m_isProcessing(false), m_workerSlotsMemory(nullptr), m_workerSlots(nullptr), m_workerSearchStart(0), m_threadAffineWorkers(false),
+	m_damageCoalescer(nullptr), m_maxDamageCount(0)
 {
 #if NV_PROFILE
 	memset(&m_stats, 0, sizeof(TkGroupStats)); 
@@ -69,6 +71,8 @@ TkGroupImpl::~TkGroupImpl()
 {
 	NVBLAST_ASSERT(getActorCount() == 0);
 	NVBLAST_ASSERT(m_sharedMemory.size() == 0);
+
+	NVBLAST_FREE(m_workerSlotsMemory);
 }
 
 
@@ -98,13 +102,14 @@ void TkGroupImpl::release()
 	}
 	m_sharedMemory.clear();
 
-	m_bondTempDataBlock.release();
-	m_chunkTempDataBlock.release();
-	m_bondEventDataBlock.release();
-	m_chunkEventDataBlock.release();
-	m_splitScratchBlock.release();
-
 	NVBLAST_DELETE(this, TkGroupImpl);
+
+	// without groups left nothing will reuse the scratch memory, e.g. of a large asset
+	TkFrameworkImpl* framework = TkFrameworkImpl::get();
+	if (framework->getObjectCount(*framework->getType(TkTypeIndex::Group)) == 0)
+	{
+		framework->getScratchPool().trim(0);
+	}
 }
 
 
@@ -155,52 +160,13 @@ bool TkGroupImpl::addActor(TkActor& actor)
 	if (mem == nullptr)
 	{
 		// the actor belongs to a family not involved in this group yet
-		// shared memory must be allocated and temporary buffers adjusted accordingly
+		// shared memory must be allocated, temporary buffers are sized per job by the workers
 
 		BLAST_PROFILE_ZONE_BEGIN("family memory");
 		mem = NVBLAST_NEW(SharedMemory);
 		mem->allocate(family);
 		m_sharedMemory[&family] = mem;
 		BLAST_PROFILE_ZONE_END("family memory");
-
-		BLAST_PROFILE_ZONE_BEGIN("group memory");
-		
-		const uint32_t workerCount = m_workers.size();
-
-		NvBlastLog theLog = logLL;
-
-		// this group's tasks will use one temporary buffer each, which is of max size of, for all families involved
-		const size_t requiredScratch = NvBlastActorGetRequiredScratchForSplit(tkActor.getActorLL(), theLog);
-		if (static_cast<size_t>(m_splitScratchBlock.numElementsPerBlock()) < requiredScratch)
-		{
-			m_splitScratchBlock.release();
-			m_splitScratchBlock.allocate(static_cast<uint32_t>(requiredScratch), workerCount);
-		}
-		
-		// generate and apply fracture may create an entry for each bond
-		const uint32_t bondCount = NvBlastAssetGetBondCount(tkActor.getAsset()->getAssetLL(), theLog);
-		if (m_bondTempDataBlock.numElementsPerBlock() < bondCount)
-		{
-			m_bondTempDataBlock.release();
-			m_bondTempDataBlock.allocate(bondCount, workerCount);
-			m_bondEventDataBlock.release();
-			m_bondEventDataBlock.allocate(bondCount, workerCount);
-		}
-
-		// apply fracture may create an entry for each lower-support chunk
-		const uint32_t graphNodeCount = NvBlastAssetGetSupportGraph(tkActor.getAsset()->getAssetLL(), theLog).nodeCount;
-		const uint32_t subsupportChunkCount
-			= NvBlastAssetGetChunkCount(tkActor.getAsset()->getAssetLL(), theLog)
-			- NvBlastAssetGetFirstSubsupportChunkIndex(tkActor.getAsset()->getAssetLL(), theLog);
-		const uint32_t chunkCount = graphNodeCount + subsupportChunkCount;
-		if (m_chunkTempDataBlock.numElementsPerBlock() < chunkCount)
-		{
-			m_chunkTempDataBlock.release();
-			m_chunkTempDataBlock.allocate(chunkCount, workerCount);
-			m_chunkEventDataBlock.release();
-			m_chunkEventDataBlock.allocate(chunkCount, workerCount);
-		}
-		BLAST_PROFILE_ZONE_END("group memory");
 	}
 	mem->addReference();
 
@@ -353,27 +319,14 @@ void TkGroupImpl::setWorkerCount(uint32_t workerCount)
 			worker.m_group = this;
 		}
 
-		const uint32_t bondCount = m_bondTempDataBlock.numElementsPerBlock();
-		if (bondCount > 0)
-		{
-			m_bondTempDataBlock.release();
-			m_bondTempDataBlock.allocate(bondCount, workerCount);
-			m_bondEventDataBlock.release();
-			m_bondEventDataBlock.allocate(bondCount, workerCount);
-		}
-		const uint32_t chunkCount = m_chunkTempDataBlock.numElementsPerBlock();
-		if (chunkCount > 0)
+		// the slots are trivially destructible, no destructor calls needed
+		// the allocator only guarantees 16-byte alignment, align the slots to their own cache line manually
+		NVBLAST_FREE(m_workerSlotsMemory);
+		m_workerSlotsMemory = NVBLAST_ALLOC_NAMED(workerCount * sizeof(WorkerSlot) + alignof(WorkerSlot), "TkGroupImpl::m_workerSlots");
+		m_workerSlots = reinterpret_cast<WorkerSlot*>((reinterpret_cast<uintptr_t>(m_workerSlotsMemory) + alignof(WorkerSlot) - 1) & ~(uintptr_t)(alignof(WorkerSlot) - 1));
+		for (uint32_t i = 0; i < workerCount; ++i)
 		{
-			m_chunkTempDataBlock.release();
-			m_chunkTempDataBlock.allocate(chunkCount, workerCount);
-			m_chunkEventDataBlock.release();
-			m_chunkEventDataBlock.allocate(chunkCount, workerCount);
-		}
-		const uint32_t scratchSize = m_splitScratchBlock.numElementsPerBlock();
-		if (scratchSize > 0)
-		{
-			m_splitScratchBlock.release();
-			m_splitScratchBlock.allocate(scratchSize, workerCount);
+			new (m_workerSlots + i) WorkerSlot();
 		}
 	}
 }
@@ -385,6 +338,30 @@ NV_INLINE uint32_t TkGroupImpl::getWorkerCount() const
 }
 
 
+void TkGroupImpl::setDamageCoalescer(const TkDamageCoalescer* coalescer)
+{
+	if (isProcessing())
+	{
+		NVBLAST_LOG_WARNING("TkGroup::setDamageCoalescer: Group is still processing, call TkGroup::endProcess first.");
+		return;
+	}
+
+	m_damageCoalescer = coalescer;
+}
+
+
+void TkGroupImpl::setMaxDamageCount(uint32_t maxDamageCount)
+{
+	if (isProcessing())
+	{
+		NVBLAST_LOG_WARNING("TkGroup::setMaxDamageCount: Group is still processing, call TkGroup::endProcess first.");
+		return;
+	}
+
+	m_maxDamageCount = maxDamageCount;
+}
+
+
 uint32_t TkGroupImpl::startProcess()
 {
 	BLAST_PROFILE_SCOPE_L("TkGroup::startProcess");
@@ -500,12 +477,9 @@ bool TkGroupImpl::endProcess()
 					mem->removeReference();
 					addActorsInternal(j.m_newActors, j.m_newActorsCount);
 					mem->addReference(j.m_newActorsCount);
-					
-					// Update joints
-					mem->m_events.protect(false); // allow allocations again
-					BLAST_PROFILE_ZONE_BEGIN("updateJoints");
-					fam->updateJoints(j.m_tkActor, &mem->m_events);
-					BLAST_PROFILE_ZONE_END("updateJoints");
+
+					// joints are updated once all split actors are known, see below
+					collectJoints(*j.m_tkActor, mem);
 				}
 
 				// virtually dequeue the actor
@@ -519,6 +493,20 @@ bool TkGroupImpl::endProcess()
 			m_jobs.clear();
 			BLAST_PROFILE_ZONE_END("job update");
 
+			BLAST_PROFILE_ZONE_BEGIN("memory unprotect");
+			for (auto it = m_sharedMemory.getIterator(); !it.done(); ++it)
+			{
+				// back to single-thread mode, allowing allocations again
+				it->second->m_events.protect(false);
+			}
+			BLAST_PROFILE_ZONE_END("memory unprotect");
+
+			if (m_jointUpdates.size() > 0)
+			{
+				BLAST_PROFILE_SCOPE_L("updateJoints");
+				updateJoints();
+			}
+
 			BLAST_PROFILE_ZONE_BEGIN("event dispatch");
 			for (auto it = m_sharedMemory.getIterator(); !it.done(); ++it)
 			{
@@ -529,11 +517,6 @@ bool TkGroupImpl::endProcess()
 				NVBLAST_ASSERT(family != nullptr);
 				NVBLAST_ASSERT(mem != nullptr && mem->isUsed());
 
-				// where no actor of a family has split, 
-				// its group/family event queue has not been 
-				// unprotected in the jobs loop above
-				mem->m_events.protect(false);
-
 				family->getQueue().dispatch(mem->m_events);
 
 				mem->m_events.reset();
@@ -544,8 +527,8 @@ bool TkGroupImpl::endProcess()
 			BLAST_PROFILE_ZONE_BEGIN("event memory release");
 			for (auto& worker : m_workers)
 			{
-				worker.m_bondBuffer.clear();
-				worker.m_chunkBuffer.clear();
+				// return event and scratch memory to the framework's pool for other groups and the next frame
+				worker.releaseMemory();
 			}
 			BLAST_PROFILE_ZONE_END("event memory release");
 		}
@@ -559,6 +542,49 @@ bool TkGroupImpl::endProcess()
 }
 
 
+void TkGroupImpl::collectJoints(TkActorImpl& splitActor, SharedMemory* mem)
+{
+	// a joint between two split actors is listed by both, it must be updated only once
+	for (TkActorImpl::JointIt j(splitActor); (bool)j; ++j)
+	{
+		TkJointImpl* joint = *j;
+		if (m_jointUpdateSet.insert(joint))
+		{
+			m_jointUpdates.pushBack(JointUpdate{ joint, mem });
+		}
+	}
+}
+
+
+void TkGroupImpl::updateJoints()
+{
+	// every joint produces at most one event, reserve the event memory once per family
+	for (const JointUpdate& update : m_jointUpdates)
+	{
+		update.mem->m_eventsCount++;
+	}
+	for (const JointUpdate& update : m_jointUpdates)
+	{
+		SharedMemory* mem = update.mem;
+		if (mem->m_eventsCount > 0)
+		{
+			mem->m_events.reserveEvents(mem->m_eventsCount);
+			mem->m_events.reserveData(mem->m_eventsCount * sizeof(TkJointUpdateEvent));
+			mem->m_eventsCount = 0;
+		}
+	}
+
+	// all actors are split at this point, the joints' chunks resolve to their final actors
+	for (const JointUpdate& update : m_jointUpdates)
+	{
+		update.joint->rebindActors(&update.mem->m_events);
+	}
+
+	m_jointUpdates.clear();
+	m_jointUpdateSet.clear();
+}
+
+
 bool TkGroupImpl::setProcessing(bool value)
 {
 	bool expected = !value;
@@ -585,18 +611,60 @@ void TkGroupImpl::enqueue(TkActorImpl* tkActor)
 }
 
 
+NV_INLINE bool TkGroupImpl::tryAcquireWorker(uint32_t workerIndex)
+{
+	std::atomic<bool>& busy = m_workerSlots[workerIndex].busy;
+
+	// read first, a failing exchange would still claim the cache line
+	bool expected = false;
+	return !busy.load(std::memory_order_relaxed) && busy.compare_exchange_strong(expected, true, std::memory_order_acquire);
+}
+
+
 TkGroupWorker* TkGroupImpl::acquireWorker()
 {
 	BLAST_PROFILE_SCOPE_L("TkGroupImpl::acquireWorker");
-	std::unique_lock<std::mutex> lk(m_workerMtx);
-	for (auto& worker:m_workers)
+
+	const uint32_t workerCount = m_workers.size();
+	const std::thread::id thisThread = std::this_thread::get_id();
+
+	if (m_threadAffineWorkers)
 	{
-		if (!worker.m_isBusy)
+		// the worker this thread used last, its buffers are likely still in this thread's cache
+		for (uint32_t i = 0; i < workerCount; ++i)
 		{
-			worker.m_isBusy = true;
-			return &worker;
+			if (m_workerSlots[i].owner.load(std::memory_order_relaxed) == thisThread && tryAcquireWorker(i))
+			{
+				return &m_workers[i];
+			}
+		}
+
+		// a worker no other thread has used yet
+		for (uint32_t i = 0; i < workerCount; ++i)
+		{
+			if (m_workerSlots[i].owner.load(std::memory_order_relaxed) == std::thread::id() && tryAcquireWorker(i))
+			{
+				m_workerSlots[i].owner.store(thisThread, std::memory_order_relaxed);
+				return &m_workers[i];
+			}
 		}
 	}
+
+	// any available worker, concurrent searches start at different workers to limit contention
+	const uint32_t searchStart = m_workerSearchStart.fetch_add(1, std::memory_order_relaxed);
+	for (uint32_t i = 0; i < workerCount; ++i)
+	{
+		const uint32_t workerIndex = (searchStart + i) % workerCount;
+		if (tryAcquireWorker(workerIndex))
+		{
+			if (m_threadAffineWorkers)
+			{
+				m_workerSlots[workerIndex].owner.store(thisThread, std::memory_order_relaxed);
+			}
+			return &m_workers[workerIndex];
+		}
+	}
+
 	return nullptr;
 }
 
@@ -604,10 +672,22 @@ TkGroupWorker* TkGroupImpl::acquireWorker()
 void TkGroupImpl::returnWorker(TkGroupWorker* worker)
 {
 	BLAST_PROFILE_SCOPE_L("TkGroupImpl::returnWorker");
-	std::unique_lock<std::mutex> lk(m_workerMtx);
 	auto w = static_cast<TkWorker*>(worker);
 	NVBLAST_CHECK_WARNING(w->m_group == this, "TkGroup::returnWorker worker does not belong to this group.", return);
-	w->m_isBusy = false;
+	NVBLAST_ASSERT(m_workerSlots[w->m_id].busy.load());
+	m_workerSlots[w->m_id].busy.store(false, std::memory_order_release);
+}
+
+
+void TkGroupImpl::setThreadAffineWorkers(bool enabled)
+{
+	if (isProcessing())
+	{
+		NVBLAST_LOG_WARNING("TkGroup::setThreadAffineWorkers: Group is still processing, call TkGroup::endProcess first.");
+		return;
+	}
+
+	m_threadAffineWorkers = enabled;
 }
 
 
@@ -34,6 +34,8 @@
 #include "NvBlastTkGroup.h"
 #include "NvBlastTkTypeImpl.h"
 
+#include <thread>
+
 
 namespace Nv
 {
@@ -42,6 +44,7 @@ namespace Blast
 
 class TkActorImpl;
 class TkFamilyImpl;
+class TkJointImpl;
 
 NVBLASTTK_IMPL_DECLARE(Group)
 {
@@ -71,6 +74,10 @@ public:
 
 	virtual TkGroupWorker*	acquireWorker() override;
 	virtual void			returnWorker(TkGroupWorker*) override;
+	virtual void			setThreadAffineWorkers(bool enabled) override;
+
+	virtual void			setDamageCoalescer(const TkDamageCoalescer* coalescer) override;
+	virtual void			setMaxDamageCount(uint32_t maxDamageCount) override;
 	// End TkGroup
 
 	// TkGroupImpl API
@@ -114,6 +121,24 @@ private:
 	SharedMemory*			getSharedMemory(TkFamilyImpl* family);
 	void					releaseSharedMemory(TkFamilyImpl* fam, SharedMemory* mem);
 
+	/**
+	Collect the joints attached to a split actor, for updateJoints. Joints already collected are ignored.
+	*/
+	void					collectJoints(TkActorImpl& splitActor, SharedMemory* mem);
+
+	/**
+	Attach all the joints collected with collectJoints to the actors now owning their chunks.
+	The resulting joint update events are written in bulk into the event queues of the split actors' families.
+	*/
+	void					updateJoints();
+
+	/**
+	Atomically mark the worker at workerIndex as busy.
+
+	\return		true if the worker was available and is now acquired by the caller, false otherwise
+	*/
+	bool					tryAcquireWorker(uint32_t workerIndex);
+
 	// functions to add/remove actors _without_ group-family memory management
 	void					addActorInternal(TkActorImpl& tkActor);
 	void					addActorsInternal(TkActorImpl** actors, uint32_t numActors);
@@ -124,25 +149,54 @@ private:
 
 	HashMap<TkFamilyImpl*, SharedMemory*>::type		m_sharedMemory;			//!< memory sharable by actors in the same family in this group
 
-	// it is assumed no more than the asset's number of bond and chunks fracture commands are produced
-	SharedBlock<NvBlastChunkFractureData>			m_chunkTempDataBlock;	//!< chunk data for damage/fracture
-	SharedBlock<NvBlastBondFractureData>			m_bondTempDataBlock;	//!< bond data for damage/fracture
-	SharedBlock<NvBlastChunkFractureData>			m_chunkEventDataBlock;	//!< initial memory block for event data
-	SharedBlock<NvBlastBondFractureData>			m_bondEventDataBlock;	//!< initial memory block for event data
-	SharedBlock<char>								m_splitScratchBlock;	//!< split scratch memory 
-
 	std::atomic<bool>								m_isProcessing;			//!< true while workers are processing
 
 	Array<TkWorker>::type							m_workers;				//!< this group's workers
 
+	/**
+	Lock-free acquisition state of the worker with the same index. Cache line aligned to avoid false sharing between threads acquiring workers.
+	*/
+#if NV_VC
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+	struct alignas(64) WorkerSlot
+	{
+		WorkerSlot() : busy(false), owner() {}
+
+		std::atomic<bool>				busy;		//!< true while the worker is acquired
+		std::atomic<std::thread::id>	owner;		//!< the thread that acquired the worker last, for thread-affine workers
+	};
+#if NV_VC
+#pragma warning(pop)
+#endif
+
+	void*											m_workerSlotsMemory;	//!< allocation holding m_workerSlots, over-allocated to align them to 64 bytes
+	WorkerSlot*										m_workerSlots;			//!< one slot per worker in m_workers, within m_workerSlotsMemory
+	std::atomic<uint32_t>							m_workerSearchStart;	//!< rotating start of the worker search, spreads concurrent acquisitions
+	bool											m_threadAffineWorkers;	//!< prefer the worker a thread used last, see setThreadAffineWorkers
+
 	Array<TkWorkerJob>::type						m_jobs;					//!< this group's process jobs
 
+	const TkDamageCoalescer*						m_damageCoalescer;		//!< merges queued damage, may be NULL
+	uint32_t										m_maxDamageCount;		//!< maximum damage passes per actor and process, 0 for no limit
+
+	/**
+	A joint attached to a split actor, and the memory of the split actor's family.
+	*/
+	struct JointUpdate
+	{
+		TkJointImpl*	joint;
+		SharedMemory*	mem;
+	};
+
+	Array<JointUpdate>::type						m_jointUpdates;			//!< joints to update after all jobs were processed
+	HashSet<TkJointImpl*>::type						m_jointUpdateSet;		//!< joints in m_jointUpdates
+
 //#if NV_PROFILE
 	TkGroupStats									m_stats;				//!< accumulated group's worker stats
 //#endif
 
-	std::mutex	m_workerMtx;
-
 	friend class TkWorker;
 };
 
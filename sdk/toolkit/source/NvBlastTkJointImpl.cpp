@@ -146,6 +146,18 @@ void TkJointImpl::setActors(TkActorImpl* actor0, TkActorImpl* actor1, TkEventQue
 }
 
 
+void TkJointImpl::rebindActors(TkEventQueue* alternateQueue)
+{
+	TkActorImpl* actor0 = m_data.actors[0] != nullptr ?
+		static_cast<TkActorImpl&>(*m_data.actors[0]).getFamilyImpl().getActorByChunk(m_data.chunkIndices[0]) : nullptr;
+
+	TkActorImpl* actor1 = m_data.actors[1] != nullptr ?
+		static_cast<TkActorImpl&>(*m_data.actors[1]).getFamilyImpl().getActorByChunk(m_data.chunkIndices[1]) : nullptr;
+
+	setActors(actor0, actor1, alternateQueue);
+}
+
+
 const TkJointData TkJointImpl::getData() const
 {
 	return getDataInternal();
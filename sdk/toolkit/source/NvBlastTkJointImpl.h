@@ -116,6 +116,14 @@ public:
 	*/
 	void						setActors(TkActorImpl* actor0, TkActorImpl* actor1, TkEventQueue* alternateQueue = nullptr);
 
+	/**
+	Find the actors currently owning this joint's chunks and attach this joint to them using setActors.
+	To be called after the actors this joint is attached to have been split.
+
+	\param[in]	alternateQueue	If not NULL, this queue will be used to hold events generated by this function.
+	*/
+	void						rebindActors(TkEventQueue* alternateQueue = nullptr);
+
 	/**
 	Ensures that any attached actors no longer refer to this joint.
 	*/
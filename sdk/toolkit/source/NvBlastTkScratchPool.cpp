@@ -0,0 +1,160 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#include "NvBlastTkScratchPool.h"
+
+#include "NvBlastAssert.h"
+#include "NvBlastProfilerInternal.h"
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+TkScratchPool::TkScratchPool() : m_cachedSize(0), m_maxCachedSize(DefaultMaxCachedSize)
+{
+	NV_COMPILE_TIME_ASSERT(sizeof(BlockHeader) == 16);
+}
+
+
+TkScratchPool::~TkScratchPool()
+{
+	purge();
+}
+
+
+void* TkScratchPool::acquire(size_t size, size_t* capacity)
+{
+	const uint32_t classIndex = getClassIndex(size);
+	if (classIndex == OversizedClass)
+	{
+		BLAST_PROFILE_SCOPE_L("TkScratchPool allocation");
+		BlockHeader* header = static_cast<BlockHeader*>(NVBLAST_ALLOC_NAMED(sizeof(BlockHeader) + size, "TkScratchPool"));
+		header->next = nullptr;
+		header->classIndex = OversizedClass;
+		if (capacity != nullptr)
+		{
+			*capacity = size;
+		}
+		return header + 1;
+	}
+	const size_t classSize = getClassSize(classIndex);
+
+	BlockHeader* header = nullptr;
+	{
+		SizeClass& sizeClass = m_classes[classIndex];
+		std::lock_guard<std::mutex> lock(sizeClass.mutex);
+		header = sizeClass.freeList;
+		if (header != nullptr)
+		{
+			sizeClass.freeList = header->next;
+		}
+	}
+
+	if (header != nullptr)
+	{
+		m_cachedSize -= classSize;
+	}
+	else
+	{
+		BLAST_PROFILE_SCOPE_L("TkScratchPool allocation");
+		header = static_cast<BlockHeader*>(NVBLAST_ALLOC_NAMED(sizeof(BlockHeader) + classSize, "TkScratchPool"));
+		header->classIndex = classIndex;
+	}
+	header->next = nullptr;
+
+	if (capacity != nullptr)
+	{
+		*capacity = classSize;
+	}
+
+	return header + 1;
+}
+
+
+void TkScratchPool::release(void* block)
+{
+	if (block == nullptr)
+	{
+		return;
+	}
+
+	BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+	const uint32_t classIndex = header->classIndex;
+	NVBLAST_ASSERT(classIndex <= OversizedClass);
+
+	if (classIndex == OversizedClass || m_cachedSize.load() + getClassSize(classIndex) > m_maxCachedSize.load())
+	{
+		NVBLAST_FREE(header);
+		return;
+	}
+
+	{
+		SizeClass& sizeClass = m_classes[classIndex];
+		std::lock_guard<std::mutex> lock(sizeClass.mutex);
+		header->next = sizeClass.freeList;
+		sizeClass.freeList = header;
+	}
+
+	m_cachedSize += getClassSize(classIndex);
+}
+
+
+void TkScratchPool::purge()
+{
+	trim(0);
+}
+
+
+void TkScratchPool::trim(size_t maxCachedSize)
+{
+	for (uint32_t classIndex = ClassCount; classIndex-- > 0 && m_cachedSize.load() > maxCachedSize;)
+	{
+		SizeClass& sizeClass = m_classes[classIndex];
+		std::lock_guard<std::mutex> lock(sizeClass.mutex);
+		while (sizeClass.freeList != nullptr && m_cachedSize.load() > maxCachedSize)
+		{
+			BlockHeader* header = sizeClass.freeList;
+			sizeClass.freeList = header->next;
+			m_cachedSize -= getClassSize(classIndex);
+			NVBLAST_FREE(header);
+		}
+	}
+}
+
+
+void TkScratchPool::setMaxCachedSize(size_t maxCachedSize)
+{
+	m_maxCachedSize = maxCachedSize;
+	trim(maxCachedSize);
+}
+
+} // namespace Blast
+} // namespace Nv
@@ -0,0 +1,235 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#ifndef NVBLASTTKSCRATCHPOOL_H
+#define NVBLASTTKSCRATCHPOOL_H
+
+#include "NvBlastGlobals.h"
+
+#include <atomic>
+#include <mutex>
+
+
+namespace Nv
+{
+namespace Blast
+{
+
+/**
+A thread-safe pool of memory blocks grouped in power-of-two size classes.
+
+Blocks released to the pool are cached and handed out again to later requests of the same size class,
+such that the transient memory used to process TkGroups is shared by all groups and families
+and recycled across frames rather than sized for the largest asset ever processed.
+
+The cache is bounded by a maximum size, blocks released while it is full are freed.  It can also be
+trimmed explicitly, e.g. once no group is left to reuse the blocks of a large asset.
+
+Requests larger than the largest size class are allocated directly and freed on release, they are never cached.
+*/
+class TkScratchPool
+{
+public:
+	TkScratchPool();
+	~TkScratchPool();
+
+	/**
+	Get a memory block of at least size bytes, 16-byte aligned.
+
+	\param[in]	size		The number of bytes requested.
+	\param[out]	capacity	If not NULL, receives the actual usable size of the block in bytes (the size class).
+
+	\return the memory block, to be returned to this pool with release().
+	*/
+	void*				acquire(size_t size, size_t* capacity = nullptr);
+
+	/**
+	Return a block previously acquired from this pool, so it can be reused.
+
+	\param[in]	block	The block to return.  May be NULL.
+	*/
+	void				release(void* block);
+
+	/**
+	Free all the cached blocks.  Blocks currently acquired are unaffected.
+	*/
+	void				purge();
+
+	/**
+	Free cached blocks, largest size classes first, until at most maxCachedSize bytes are cached.
+	Blocks currently acquired are unaffected.
+
+	\param[in]	maxCachedSize	The number of cached bytes to keep at most.
+	*/
+	void				trim(size_t maxCachedSize);
+
+	/**
+	Set the maximum number of bytes cached, blocks released beyond it are freed.  The cache is trimmed to it.
+	The bound is approximate when blocks are released concurrently.
+
+	\param[in]	maxCachedSize	The maximum number of cached bytes, DefaultMaxCachedSize initially.
+	*/
+	void				setMaxCachedSize(size_t maxCachedSize);
+
+	/**
+	\return the maximum number of bytes cached, see setMaxCachedSize().
+	*/
+	size_t				getMaxCachedSize() const;
+
+	/**
+	\return the number of bytes cached by this pool and not currently acquired.
+	*/
+	size_t				getCachedSize() const;
+
+private:
+	enum
+	{
+		MinClassShift = 6,	//!< smallest size class is 64 bytes
+		ClassCount = 32,	//!< largest size class is 128 GB
+		OversizedClass = ClassCount	//!< class index of blocks allocated directly, past the largest size class
+	};
+
+public:
+	static const size_t	DefaultMaxCachedSize = 64 * 1024 * 1024;	//!< initial bound of the cache, 64 MB
+
+private:
+
+	/**
+	Stored in front of every block, 16 bytes to preserve the allocator's alignment.
+	*/
+	struct BlockHeader
+	{
+		BlockHeader*	next;		//!< next cached block in the size class, when in the pool
+		uint32_t		classIndex;	//!< the size class this block belongs to
+		uint32_t		pad;
+	};
+
+	struct SizeClass
+	{
+		SizeClass() : freeList(nullptr) {}
+
+		std::mutex		mutex;		//!< guards freeList
+		BlockHeader*	freeList;	//!< cached blocks
+	};
+
+	/**
+	\return the smallest size class fitting size bytes, or OversizedClass if none does.
+	*/
+	static uint32_t		getClassIndex(size_t size);
+
+	static size_t		getClassSize(uint32_t classIndex);
+
+	SizeClass			m_classes[ClassCount];	//!< cached blocks per size class
+	std::atomic<size_t>	m_cachedSize;			//!< bytes cached over all size classes
+	std::atomic<size_t>	m_maxCachedSize;		//!< bound of m_cachedSize
+};
+
+
+/**
+A growable typed block acquired from a TkScratchPool.
+Its content is not preserved when growing.
+*/
+template<typename T>
+class TkScratchBlock
+{
+public:
+	TkScratchBlock() : m_data(nullptr), m_capacity(0) {}
+
+	/**
+	Ensure the block fits at least n elements.
+
+	\return the first element of the block.
+	*/
+	T* reserve(TkScratchPool& pool, size_t n)
+	{
+		if (n > m_capacity)
+		{
+			release(pool);
+			size_t size;
+			m_data = static_cast<T*>(pool.acquire(n * sizeof(T), &size));
+			m_capacity = size / sizeof(T);
+		}
+		return m_data;
+	}
+
+	/**
+	Return the memory to the pool.
+	*/
+	void release(TkScratchPool& pool)
+	{
+		pool.release(m_data);
+		m_data = nullptr;
+		m_capacity = 0;
+	}
+
+	T*		data() const		{ return m_data; }
+
+	size_t	capacity() const	{ return m_capacity; }
+
+private:
+	T*		m_data;		//!< memory acquired from the pool
+	size_t	m_capacity;	//!< elements fitting in m_data
+};
+
+
+//////// TkScratchPool inline methods ////////
+
+NV_INLINE uint32_t TkScratchPool::getClassIndex(size_t size)
+{
+	uint32_t classIndex = 0;
+	while (classIndex < ClassCount && getClassSize(classIndex) < size)
+	{
+		++classIndex;
+	}
+	return classIndex;
+}
+
+
+NV_INLINE size_t TkScratchPool::getClassSize(uint32_t classIndex)
+{
+	return size_t(1) << (classIndex + MinClassShift);
+}
+
+
+NV_INLINE size_t TkScratchPool::getCachedSize() const
+{
+	return m_cachedSize.load();
+}
+
+
+NV_INLINE size_t TkScratchPool::getMaxCachedSize() const
+{
+	return m_maxCachedSize.load();
+}
+
+} // namespace Blast
+} // namespace Nv
+
+
+#endif // ifndef NVBLASTTKSCRATCHPOOL_H
@@ -33,6 +33,8 @@
 #include "NvBlastTkAssetImpl.h"
 #include "NvBlastTkGroupImpl.h"
 
+#include <algorithm>
+
 
 using namespace Nv::Blast;
 
@@ -127,22 +129,8 @@ NV_FORCE_INLINE void reportFractureEvents(
 
 void TkWorker::initialize()
 {
-	// temporary memory used to generate and apply fractures
-	// it must fit for the largest family involved in the group that owns this worker 
-	NvBlastBondFractureData* bondFractureData = m_group->m_bondTempDataBlock.getBlock(m_id);
-	uint32_t bondFractureCount = m_group->m_bondTempDataBlock.numElementsPerBlock();
-	NvBlastChunkFractureData* chunkFractureData = m_group->m_chunkTempDataBlock.getBlock(m_id);
-	uint32_t chunkFractureCount = m_group->m_chunkTempDataBlock.numElementsPerBlock();
-	m_tempBuffer = { bondFractureCount, chunkFractureCount, bondFractureData, chunkFractureData };
-
-	// temporary memory used to split the actor
-	// large enough for the largest family involved
-	m_splitScratch = m_group->m_splitScratchBlock.getBlock(m_id);
-
-	// to avoid unnecessary allocations, preallocated memory exists to fit all chunks and bonds taking damage once
-	// where multiple damage occurs, more memory will be allocated on demand (this may thwart other threads doing the same)
-	m_bondBuffer.initialize(m_group->m_bondEventDataBlock.getBlock(m_id), m_group->m_bondEventDataBlock.numElementsPerBlock());
-	m_chunkBuffer.initialize(m_group->m_chunkEventDataBlock.getBlock(m_id), m_group->m_chunkEventDataBlock.numElementsPerBlock());
+	// temporary memory is acquired from the framework's scratch pool on demand while processing jobs,
+	// sized for the actors actually processed rather than for the largest asset involved in the group
 
 #if NV_PROFILE
 	NvBlastTimersReset(&m_stats.timers);
@@ -150,6 +138,156 @@ void TkWorker::initialize()
 #endif
 }
 
+
+void TkWorker::releaseMemory()
+{
+	TkScratchPool& pool = TkFrameworkImpl::get()->getScratchPool();
+	m_splitScratch.release(pool);
+	m_bondTempData.release(pool);
+	m_chunkTempData.release(pool);
+	m_combinedParams.release(pool);
+	m_bondBuffer.clear();
+	m_chunkBuffer.clear();
+}
+
+
+/**
+Strict weak ordering of damage programs, to group the damage queued with the same program.
+*/
+NV_FORCE_INLINE bool programLess(const NvBlastDamageProgram& a, const NvBlastDamageProgram& b)
+{
+	const uintptr_t graphA = reinterpret_cast<uintptr_t>(a.graphShaderFunction);
+	const uintptr_t graphB = reinterpret_cast<uintptr_t>(b.graphShaderFunction);
+	return graphA < graphB || (graphA == graphB && 
+		reinterpret_cast<uintptr_t>(a.subgraphShaderFunction) < reinterpret_cast<uintptr_t>(b.subgraphShaderFunction));
+}
+
+
+NV_FORCE_INLINE bool programEqual(const NvBlastDamageProgram& a, const NvBlastDamageProgram& b)
+{
+	return a.graphShaderFunction == b.graphShaderFunction && a.subgraphShaderFunction == b.subgraphShaderFunction;
+}
+
+
+void TkWorker::applyDamage(TkActorImpl* tkActor, const NvBlastDamageProgram& program, const void* programParams,
+	const NvBlastFractureBuffers& tempBuffer, TkEventQueue& events, NvBlastTimers* timers)
+{
+	NvBlastActor* actorLL = tkActor->getActorLLInternal();
+
+	NvBlastFractureBuffers commandBuffer = tempBuffer;
+
+	BLAST_PROFILE_ZONE_BEGIN("Material");
+	NvBlastActorGenerateFracture(&commandBuffer, actorLL, program, programParams, logLL, timers);
+	BLAST_PROFILE_ZONE_END("Material");
+
+	if (commandBuffer.chunkFractureCount > 0 || commandBuffer.bondFractureCount > 0)
+	{
+		BLAST_PROFILE_SCOPE_M("Fill Command Events");
+		reportFractureCommands(commandBuffer, m_bondBuffer, m_chunkBuffer, events, tkActor);
+	}
+
+	NvBlastFractureBuffers eventBuffer = tempBuffer;
+
+	BLAST_PROFILE_ZONE_BEGIN("Fracture");
+	NvBlastActorApplyFracture(&eventBuffer, actorLL, &commandBuffer, logLL, timers);
+	BLAST_PROFILE_ZONE_END("Fracture");
+
+	if (eventBuffer.chunkFractureCount > 0 || eventBuffer.bondFractureCount > 0)
+	{
+		BLAST_PROFILE_SCOPE_M("Fill Fracture Events");
+		tkActor->m_flags |= (TkActorFlag::DAMAGED);
+		reportFractureEvents(eventBuffer, m_bondBuffer, m_chunkBuffer, events, tkActor);
+	}
+}
+
+
+void TkWorker::applyDamageBuffer(TkActorImpl* tkActor, const NvBlastFractureBuffers& tempBuffer, TkEventQueue& events, NvBlastTimers* timers)
+{
+	const auto& damageBuffer = tkActor->m_damageBuffer;
+	const uint32_t damageCount = damageBuffer.size();
+	const TkDamageCoalescer* coalescer = m_group->m_damageCoalescer;
+	const uint32_t maxDamageCount = m_group->m_maxDamageCount;
+	const bool overLimit = maxDamageCount > 0 && damageCount > maxDamageCount;
+
+	if (coalescer == nullptr || damageCount == 1)
+	{
+		if (overLimit)
+		{
+			NVBLAST_LOG_WARNING("TkGroup: more damage than the group's maxDamageCount was queued on an actor and no damage coalescer is set, the damage past the limit is dropped.");
+		}
+		const uint32_t passCount = overLimit ? maxDamageCount : damageCount;
+		for (uint32_t i = 0; i < passCount; ++i)
+		{
+			applyDamage(tkActor, damageBuffer[i].program, damageBuffer[i].programParams, tempBuffer, events, timers);
+		}
+		return;
+	}
+
+	// group the damage by program, keeping the queue order within each program
+	BLAST_PROFILE_ZONE_BEGIN("Coalesce Damage");
+	m_damageOrder.resizeUninitialized(damageCount);
+	for (uint32_t i = 0; i < damageCount; ++i)
+	{
+		m_damageOrder[i] = i;
+	}
+	std::stable_sort(m_damageOrder.begin(), m_damageOrder.end(), [&damageBuffer](uint32_t a, uint32_t b)
+	{
+		return programLess(damageBuffer[a].program, damageBuffer[b].program);
+	});
+	BLAST_PROFILE_ZONE_END("Coalesce Damage");
+
+	// aggregate falloff: the combined damage of an actor over the limit amounts to maxDamageCount damage calls
+	const float damageScale = overLimit ? (float)maxDamageCount / damageCount : 1.0f;
+
+	uint32_t passCount = 0;
+	uint32_t runStart = 0;
+	while (runStart < damageCount && (maxDamageCount == 0 || passCount < maxDamageCount))
+	{
+		const NvBlastDamageProgram& program = damageBuffer[m_damageOrder[runStart]].program;
+		uint32_t runEnd = runStart + 1;
+		while (runEnd < damageCount && programEqual(damageBuffer[m_damageOrder[runEnd]].program, program))
+		{
+			++runEnd;
+		}
+		const uint32_t runCount = runEnd - runStart;
+
+		size_t combinedSize = 0;
+		if (runCount > 1 || overLimit)
+		{
+			m_damageParams.resizeUninitialized(runCount);
+			for (uint32_t i = 0; i < runCount; ++i)
+			{
+				m_damageParams[i] = damageBuffer[m_damageOrder[runStart + i]].programParams;
+			}
+			combinedSize = coalescer->getCombinedParamsSize(program, m_damageParams.begin(), runCount);
+		}
+
+		if (combinedSize > 0)
+		{
+			BLAST_PROFILE_ZONE_BEGIN("Coalesce Damage");
+			char* combinedParams = m_combinedParams.reserve(TkFrameworkImpl::get()->getScratchPool(), combinedSize);
+			coalescer->combineParams(combinedParams, program, m_damageParams.begin(), runCount, damageScale);
+			BLAST_PROFILE_ZONE_END("Coalesce Damage");
+
+			applyDamage(tkActor, program, combinedParams, tempBuffer, events, timers);
+			++passCount;
+		}
+		else
+		{
+			// the coalescer does not support this program, apply the damage as queued within the limit
+			for (uint32_t i = runStart; i < runEnd && (maxDamageCount == 0 || passCount < maxDamageCount); ++i)
+			{
+				const auto& damage = damageBuffer[m_damageOrder[i]];
+				applyDamage(tkActor, damage.program, damage.programParams, tempBuffer, events, timers);
+				++passCount;
+			}
+		}
+
+		runStart = runEnd;
+	}
+}
+
+
 void TkWorker::process(TkWorkerJob& j)
 {
 	NvBlastTimers* timers = nullptr;
@@ -173,34 +311,26 @@ void TkWorker::process(TkWorkerJob& j)
 	m_stats.processedActorsCount++;
 #endif
 
+	// temporary memory used to generate and apply fractures, it must fit this actor's bonds and lower-support chunks
+	NvBlastFractureBuffers tempBuffer = { 0, 0, nullptr, nullptr };
+	if (tkActor->m_damageBuffer.size() > 0)
+	{
+		BLAST_PROFILE_ZONE_BEGIN("Fracture Memory");
+		TkScratchPool& pool = TkFrameworkImpl::get()->getScratchPool();
+		const TkAssetImpl* asset = family.getAssetImpl();
+		const uint32_t graphNodeCount = NvBlastActorGetGraphNodeCount(actorLL, logLL);
+		tempBuffer.bondFractureCount = asset->getMaxBondFractureCount(graphNodeCount);
+		tempBuffer.chunkFractureCount = asset->getMaxChunkFractureCount(graphNodeCount);
+		tempBuffer.bondFractures = m_bondTempData.reserve(pool, tempBuffer.bondFractureCount);
+		tempBuffer.chunkFractures = m_chunkTempData.reserve(pool, tempBuffer.chunkFractureCount);
+		BLAST_PROFILE_ZONE_END("Fracture Memory");
+	}
+
 	// generate and apply fracture for all damage requested on this actor
 	// and queue events accordingly
-	for (const auto& damage : tkActor->m_damageBuffer)
+	if (tkActor->m_damageBuffer.size() > 0)
 	{
-		NvBlastFractureBuffers commandBuffer = m_tempBuffer;
-
-		BLAST_PROFILE_ZONE_BEGIN("Material");
-		NvBlastActorGenerateFracture(&commandBuffer, actorLL, damage.program, damage.programParams, logLL, timers);
-		BLAST_PROFILE_ZONE_END("Material");
-
-		if (commandBuffer.chunkFractureCount > 0 || commandBuffer.bondFractureCount > 0)
-		{
-			BLAST_PROFILE_SCOPE_M("Fill Command Events");
-			reportFractureCommands(commandBuffer, m_bondBuffer, m_chunkBuffer, events, tkActor);
-		}
-
-		NvBlastFractureBuffers eventBuffer = m_tempBuffer;
-
-		BLAST_PROFILE_ZONE_BEGIN("Fracture");
-		NvBlastActorApplyFracture(&eventBuffer, actorLL, &commandBuffer, logLL, timers);
-		BLAST_PROFILE_ZONE_END("Fracture");
-
-		if (eventBuffer.chunkFractureCount > 0 || eventBuffer.bondFractureCount > 0)
-		{
-			BLAST_PROFILE_SCOPE_M("Fill Fracture Events");
-			tkActor->m_flags |= (TkActorFlag::DAMAGED);
-			reportFractureEvents(eventBuffer, m_bondBuffer, m_chunkBuffer, events, tkActor);
-		}
+		applyDamageBuffer(tkActor, tempBuffer, events, timers);
 	}
 
 
@@ -213,9 +343,11 @@ void TkWorker::process(TkWorkerJob& j)
 		BLAST_PROFILE_ZONE_BEGIN("Split Memory");
 		uint32_t maxActorCount = NvBlastActorGetMaxActorCountForSplit(actorLL, logLL);
 		splitEvent.newActors = mem->reserveNewActors(maxActorCount);
+		const size_t requiredScratch = NvBlastActorGetRequiredScratchForSplit(actorLL, logLL);
+		void* splitScratch = m_splitScratch.reserve(TkFrameworkImpl::get()->getScratchPool(), requiredScratch);
 		BLAST_PROFILE_ZONE_END("Split Memory");
 		BLAST_PROFILE_ZONE_BEGIN("Split");
-		j.m_newActorsCount = NvBlastActorSplit(&splitEvent, actorLL, maxActorCount, m_splitScratch, logLL, timers);
+		j.m_newActorsCount = NvBlastActorSplit(&splitEvent, actorLL, maxActorCount, splitScratch, logLL, timers);
 		BLAST_PROFILE_ZONE_END("Split");
 
 		tkActor->m_flags.clear(TkActorFlag::DAMAGED);
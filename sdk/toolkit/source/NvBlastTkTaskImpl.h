@@ -68,63 +68,6 @@ struct TkWorkerJob
 
 
 
-/**
-A list of equally sized memory blocks sharable between tasks.
-*/
-template<typename T>
-class SharedBlock
-{
-public:
-
-	SharedBlock() : m_numElementsPerBlock(0), m_numBlocks(0), m_buffer(nullptr) {}
-
-	/**
-	Allocates one large memory block of elementsPerBlock*numBlocks elements.
-	*/
-	void allocate(uint32_t elementsPerBlock, uint32_t numBlocks)
-	{
-		NVBLAST_ASSERT(elementsPerBlock > 0 && numBlocks > 0);
-
-		m_buffer = reinterpret_cast<T*>(NVBLAST_ALLOC_NAMED(elementsPerBlock*numBlocks*sizeof(T), "SharedBlock"));
-		m_numElementsPerBlock = elementsPerBlock;
-		m_numBlocks = numBlocks;
-	}
-
-	/**
-	Returns the pointer to the first element of a block of numElementsPerBlock() elements.
-	*/
-	T* getBlock(uint32_t id)
-	{
-		NVBLAST_ASSERT(id < m_numBlocks || 0 == m_numElementsPerBlock);
-		return &m_buffer[id*m_numElementsPerBlock];
-	}
-
-	/**
-	The number of elements available per block.
-	*/
-	uint32_t numElementsPerBlock() const 
-	{
-		return m_numElementsPerBlock; 
-	}
-
-	/**
-	Frees the whole memory block.
-	*/
-	void release()
-	{
-		m_numBlocks = 0;
-		m_numElementsPerBlock = 0;
-		NVBLAST_FREE(m_buffer);
-		m_buffer = nullptr;
-	}
-
-private:
-	uint32_t	m_numElementsPerBlock;	//!< elements available in one block
-	uint32_t	m_numBlocks;			//!< number of virtual blocks available
-	T*			m_buffer;				//!< contiguous memory for all blocks
-};
-
-
 /**
 A preallocated, shared array from which can be allocated from in tasks.
 Intended to be used when the maximum amount of data (e.g. for a family) 
@@ -148,12 +91,12 @@ public:
 	}
 
 	/**
-	Preallocates memory for capacity elements.
+	Preallocates memory for capacity elements from the framework's scratch pool.
 	*/
 	void allocate(size_t capacity)
 	{
 		NVBLAST_ASSERT(m_buffer == nullptr);
-		m_buffer = reinterpret_cast<T*>(NVBLAST_ALLOC_NAMED(capacity*sizeof(T), "SplitMemory"));
+		m_buffer = reinterpret_cast<T*>(TkFrameworkImpl::get()->getScratchPool().acquire(capacity*sizeof(T)));
 		m_capacity = capacity;
 	}
 
@@ -166,12 +109,12 @@ public:
 	}
 
 	/**
-	Frees the preallocated array.
+	Returns the preallocated array to the framework's scratch pool.
 	*/
 	void release()
 	{
 		NVBLAST_ASSERT(m_buffer != nullptr);
-		NVBLAST_FREE(m_buffer);
+		TkFrameworkImpl::get()->getScratchPool().release(m_buffer);
 		m_buffer = nullptr;
 		m_capacity = m_used = 0;
 	}
@@ -184,22 +127,24 @@ private:
 
 
 /**
-Allocates from a preallocated, externally owned memory block initialized with.
-When blocks run out of space, new ones are allocated and owned by this class.
+Allocates from memory blocks acquired from the framework's scratch pool.
+When blocks run out of space, new larger ones are acquired. All blocks are kept until clear().
 */
 template<typename T>
 class LocalBuffer
 {
 public:
+	LocalBuffer() : m_currentBlock(nullptr), m_used(0), m_capacity(0) {}
+
 	/**
 	Returns the pointer to the first element of an array of n elements.
-	Allocates a new block of memory when exhausted, its size being the larger of n and capacity set with initialize().
+	Acquires a new block of memory when exhausted, at least twice the size of the previous one.
 	*/
 	T* allocate(size_t n)
 	{
 		if (m_used + n > m_capacity)
 		{
-			allocateNewBlock(n > m_capacity ? n : m_capacity);
+			allocateNewBlock(n > 2 * m_capacity ? n : 2 * m_capacity);
 		}
 
 		size_t index = m_used;
@@ -208,43 +153,36 @@ public:
 	}
 
 	/**
-	Release the additionally allocated memory blocks.
-	The externally owned memory block remains untouched.
+	Return all the memory blocks to the scratch pool.
 	*/
 	void clear()
 	{
+		TkScratchPool& pool = TkFrameworkImpl::get()->getScratchPool();
 		for (void* block : m_memoryBlocks)
 		{
-			NVBLAST_FREE(block);
+			pool.release(block);
 		}
 		m_memoryBlocks.clear();
-	}
-
-	/**
-	Set the externally owned memory block to start allocating from,
-	with a size of capacity elements.
-	*/
-	void initialize(T* block, size_t capacity)
-	{
-		m_currentBlock = block;
-		m_capacity = capacity;
+		m_currentBlock = nullptr;
 		m_used = 0;
+		m_capacity = 0;
 	}
 
 private:
 	/**
-	Allocates space for capacity elements.
+	Acquires space for at least capacity elements.
 	*/
 	void allocateNewBlock(size_t capacity)
 	{
 		BLAST_PROFILE_SCOPE_L("Local Buffer allocation");
-		m_capacity = capacity;
-		m_currentBlock = static_cast<T*>(NVBLAST_ALLOC_NAMED(capacity*sizeof(T), "Blast LocalBuffer"));
+		size_t size;
+		m_currentBlock = static_cast<T*>(TkFrameworkImpl::get()->getScratchPool().acquire(capacity*sizeof(T), &size));
+		m_capacity = size / sizeof(T);
 		m_memoryBlocks.pushBack(m_currentBlock);
 		m_used = 0;
 	}
 
-	InlineArray<void*, 4>::type		m_memoryBlocks; //!< storage for memory blocks
+	InlineArray<void*, 4>::type		m_memoryBlocks; //!< memory blocks acquired from the scratch pool
 	T*								m_currentBlock;	//!< memory block used to allocate from
 	size_t							m_used;			//!< elements used in current block
 	size_t							m_capacity;		//!< elements available in current block
@@ -346,22 +284,43 @@ The list of actual jobs is provided by the group owning this worker.
 class TkWorker final : public TkGroupWorker
 {
 public:
-	TkWorker() : m_id(~(uint32_t)0), m_group(nullptr), m_isBusy(false) {}
+	TkWorker() : m_id(~(uint32_t)0), m_group(nullptr) {}
 
 	void		process(uint32_t jobID);
 	void		initialize();
 
 	void		process(TkWorkerJob& job);
 
+	/**
+	Return all the memory used for processing to the framework's scratch pool.
+	To be called once the events referencing it have been dispatched.
+	*/
+	void		releaseMemory();
+
+	/**
+	Generate and apply the fracture for one damage pass on tkActor, queuing the command and fracture events.
+	*/
+	void		applyDamage(TkActorImpl* tkActor, const NvBlastDamageProgram& program, const void* programParams,
+							const NvBlastFractureBuffers& tempBuffer, TkEventQueue& events, NvBlastTimers* timers);
+
+	/**
+	Apply the damage queued on tkActor, merging damage with the same program using the group's damage coalescer
+	and limiting the number of damage passes to the group's maximum damage count.
+	*/
+	void		applyDamageBuffer(TkActorImpl* tkActor, const NvBlastFractureBuffers& tempBuffer, TkEventQueue& events, NvBlastTimers* timers);
+
 	uint32_t								m_id;			//!< this worker's id
 	TkGroupImpl*							m_group;		//!< the group owning this worker
 
 	LocalBuffer<NvBlastChunkFractureData>	m_chunkBuffer;	//!< memory manager for chunk event data
 	LocalBuffer<NvBlastBondFractureData>	m_bondBuffer;	//!< memory manager for bonds event data
 
-	void*									m_splitScratch;
-	NvBlastFractureBuffers					m_tempBuffer;
-	bool									m_isBusy;
+	TkScratchBlock<char>					m_splitScratch;		//!< scratch for splitting, held from the framework's scratch pool until endProcess
+	TkScratchBlock<NvBlastBondFractureData>	m_bondTempData;		//!< bond data for damage/fracture, held from the framework's scratch pool until endProcess
+	TkScratchBlock<NvBlastChunkFractureData>	m_chunkTempData;	//!< chunk data for damage/fracture, held from the framework's scratch pool until endProcess
+	TkScratchBlock<char>					m_combinedParams;	//!< program params combined by the group's damage coalescer
+	Array<uint32_t>::type					m_damageOrder;		//!< indices into the processed actor's damage buffer, ordered by program
+	Array<const void*>::type				m_damageParams;		//!< program params passed to the group's damage coalescer
 
 #if NV_PROFILE
 	TkGroupStats	m_stats;
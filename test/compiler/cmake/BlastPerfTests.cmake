@@ -26,6 +26,7 @@ SET(PERF_SOURCE_FILES
 	${PERF_SOURCE_DIR}/BlastBasePerfTest.h
 	${PERF_SOURCE_DIR}/SolverPerfTests.cpp
 	${PERF_SOURCE_DIR}/DamagePerfTests.cpp
+	${PERF_SOURCE_DIR}/StressPerfTests.cpp
 )
 
 SET(SDK_COMMON_FILES
@@ -148,7 +149,7 @@ TARGET_COMPILE_OPTIONS(BlastPerfTests
 
 TARGET_LINK_LIBRARIES(BlastPerfTests 
 
-	PRIVATE NvBlastExtShaders NvBlastTk NvBlastExtSerialization ${GOOGLETEST_LIBRARIES} 
+	PRIVATE NvBlastExtShaders NvBlastExtStress NvBlastTk NvBlastExtSerialization ${GOOGLETEST_LIBRARIES} 
 	PRIVATE ${BLASTPERFTESTS_PLATFORM_LINKED_LIBS}
 )
 
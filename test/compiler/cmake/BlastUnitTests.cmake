@@ -26,8 +26,10 @@ SET(UNITTEST_SOURCE_FILES
 	${UNITTEST_SOURCE_DIR}/ActorTests.cpp
 	${UNITTEST_SOURCE_DIR}/APITests.cpp
 	${UNITTEST_SOURCE_DIR}/CoreTests.cpp
+	${UNITTEST_SOURCE_DIR}/DamageShaderTests.cpp
 	${UNITTEST_SOURCE_DIR}/FamilyGraphTests.cpp
 	${UNITTEST_SOURCE_DIR}/MultithreadingTests.cpp
+	${UNITTEST_SOURCE_DIR}/StressSolverTests.cpp
 	${UNITTEST_SOURCE_DIR}/SyncTests.cpp
 	${UNITTEST_SOURCE_DIR}/TkCompositeTests.cpp
 	${UNITTEST_SOURCE_DIR}/TkTests.cpp
@@ -125,6 +127,7 @@ TARGET_INCLUDE_DIRECTORIES(BlastUnitTests
 	PRIVATE ${BLAST_ROOT_DIR}/sdk/extensions/assetutils/source
 	PRIVATE ${BLAST_ROOT_DIR}/sdk/extensions/assetutils/include
 	PRIVATE ${BLAST_ROOT_DIR}/sdk/extensions/serialization/include
+	PRIVATE ${BLAST_ROOT_DIR}/sdk/extensions/shaders/source
 	PRIVATE ${BLAST_ROOT_DIR}/shared/utils
 
 	PRIVATE ${PXSHAREDSDK_INCLUDE_DIRS}
@@ -166,7 +169,7 @@ MESSAGE("UnitTests LL: ${BLASTUNITTESTS_PLATFORM_LINKED_LIBS}")
 # Do final direct sets after the target has been defined
 TARGET_LINK_LIBRARIES(BlastUnitTests 
 
-	PRIVATE NvBlastExtShaders NvBlastExtPhysX NvBlastTk NvBlastExtSerialization NvBlastExtAssetUtils ${GOOGLETEST_LIBRARIES} 
+	PRIVATE NvBlastExtShaders NvBlastExtStress NvBlastExtPhysX NvBlastTk NvBlastExtSerialization NvBlastExtAssetUtils ${GOOGLETEST_LIBRARIES} 
 	PRIVATE ${BLASTUNITTESTS_PLATFORM_LINKED_LIBS}
 
 	PUBLIC $<$<CONFIG:debug>:${PHYSXFOUNDATION_LIB_DEBUG}> $<$<CONFIG:debug>:${PHYSXTASK_STATIC_LIB_DEBUG}>
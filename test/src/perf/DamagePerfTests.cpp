@@ -267,7 +267,7 @@ TEST_F(PerfTest, DISABLED_DamageRadialSimple)
 			std::cout << trial << ".. ";
 			std::cout.flush();
 		}
-		std::vector<uint32_t> history1, history2;
+		std::vector<uint32_t> history1, history2, history3;
 
 		uint32_t assetCount = 4;
 		uint32_t familyCount = 4;
@@ -279,8 +279,12 @@ TEST_F(PerfTest, DISABLED_DamageRadialSimple)
 		PerfResults results1 = damageLeafSupportActors(test_info_->name(), assetCount, familyCount, damageCount, 1, history2);
 		BlastBasePerfTestStrict::reportData("DamageRadialSimple total1 ", results1.totalTime);
 		BlastBasePerfTestStrict::reportData("DamageRadialSimple create1 ", results1.createTime);
+		PerfResults results2 = damageLeafSupportActors(test_info_->name(), assetCount, familyCount, damageCount, 2, history3);
+		BlastBasePerfTestStrict::reportData("DamageRadialSimple total2 ", results2.totalTime);
+		BlastBasePerfTestStrict::reportData("DamageRadialSimple create2 ", results2.createTime);
 
 		EXPECT_TRUE(history1 == history2);
+		EXPECT_TRUE(history1 == history3);
 	}
 	std::cout << "done." << std::endl;
 }
@@ -0,0 +1,198 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+#include "BlastBasePerfTest.h"
+#include "AssetGenerator.h"
+#include "NvBlastExtStressSolver.h"
+#include "NvBlastTime.h"
+#include <cmath>
+
+using namespace Nv::Blast;
+
+
+typedef BlastBasePerfTest<NvBlastMessage::Warning, 1> BlastBasePerfTestStrict;
+
+
+/**
+Procedural structure made of unit cube support chunks, bonded to the world (static) on some of its sides.
+*/
+struct StressStructure
+{
+	const char*						name;
+	GeneratorAsset::Vec3			aspect;		//!< slices per axis ratio, scaled to reach the node count
+	CubeAssetGenerator::BondFlags	bondFlags;
+};
+
+static const StressStructure s_structures[] =
+{
+	{ "tower",	GeneratorAsset::Vec3(1, 8, 1),	CubeAssetGenerator::ALL_INTERNAL_BONDS | CubeAssetGenerator::Y_MINUS_WORLD_BONDS },
+	{ "bridge",	GeneratorAsset::Vec3(16, 1, 2),	CubeAssetGenerator::ALL_INTERNAL_BONDS | CubeAssetGenerator::X_MINUS_WORLD_BONDS | CubeAssetGenerator::X_PLUS_WORLD_BONDS },
+	{ "grid",	GeneratorAsset::Vec3(1, 1, 1),	CubeAssetGenerator::ALL_INTERNAL_BONDS | CubeAssetGenerator::Y_MINUS_WORLD_BONDS }
+};
+
+static const uint32_t s_nodeCounts[] = { 1000, 10000, 50000, 200000 };
+
+
+class StressPerfTest : public BlastBasePerfTestStrict
+{
+public:
+	static void generateStructure(GeneratorAsset& asset, NvBlastAssetDesc& desc, const StressStructure& structure, uint32_t nodeCount)
+	{
+		const GeneratorAsset::Vec3& aspect = structure.aspect;
+		const float scale = std::pow(nodeCount / (aspect.x * aspect.y * aspect.z), 1.0f / 3.0f);
+		const GeneratorAsset::Vec3 slices(std::max(std::round(aspect.x * scale), 1.0f), std::max(std::round(aspect.y * scale), 1.0f), std::max(std::round(aspect.z * scale), 1.0f));
+
+		CubeAssetGenerator::Settings settings;
+		settings.extents = slices;	// unit cube chunks
+		settings.bondFlags = structure.bondFlags;
+		settings.depths.push_back(CubeAssetGenerator::DepthInfo(GeneratorAsset::Vec3(1, 1, 1)));
+		settings.depths.push_back(CubeAssetGenerator::DepthInfo(slices, NvBlastChunkDesc::SupportFlag));
+		CubeAssetGenerator::generate(asset, settings);
+
+		desc.bondCount = (uint32_t)asset.solverBonds.size();
+		desc.bondDescs = asset.solverBonds.data();
+		desc.chunkCount = (uint32_t)asset.solverChunks.size();
+		desc.chunkDescs = asset.solverChunks.data();
+	}
+
+	/**
+	Solves the structure under gravity for frameCount frames per graph reduction level, then lowers the hardness until 
+	bonds break and times fracture command generation.
+	*/
+	void stressStructure(const char* testName, const StressStructure& structure, uint32_t nodeCount, uint32_t frameCount, uint32_t maxReductionLevel)
+	{
+		GeneratorAsset generatorAsset;
+		NvBlastAssetDesc desc;
+		generateStructure(generatorAsset, desc, structure, nodeCount);
+
+		std::vector<char> scratch;
+		scratch.resize((size_t)NvBlastGetRequiredScratchForCreateAsset(&desc, messageLog));
+		void* assetMem = alignedZeroedAlloc(NvBlastGetAssetMemorySize(&desc, messageLog));
+		NvBlastAsset* asset = NvBlastCreateAsset(assetMem, &desc, scratch.data(), messageLog);
+		EXPECT_TRUE(asset != nullptr);
+
+		const uint32_t bondCount = NvBlastAssetGetBondCount(asset, messageLog);
+		const NvcVec3 gravity = { 0.0f, -9.81f, 0.0f };
+
+		for (uint32_t reductionLevel = 0; reductionLevel <= maxReductionLevel; ++reductionLevel)
+		{
+			NvBlastActorDesc actorDesc;
+			actorDesc.initialBondHealths = nullptr;
+			actorDesc.uniformInitialBondHealth = 1.0f;
+			actorDesc.initialSupportChunkHealths = nullptr;
+			actorDesc.uniformInitialLowerSupportChunkHealth = 1.0f;
+			void* familyMem = alignedZeroedAlloc(NvBlastAssetGetFamilyMemorySize(asset, messageLog));
+			NvBlastFamily* family = NvBlastAssetCreateFamily(familyMem, asset, messageLog);
+			EXPECT_TRUE(family != nullptr);
+			scratch.resize((size_t)NvBlastFamilyGetRequiredScratchForCreateFirstActor(family, messageLog));
+			NvBlastActor* actor = NvBlastFamilyCreateFirstActor(family, &actorDesc, scratch.data(), messageLog);
+			EXPECT_TRUE(actor != nullptr);
+
+			ExtStressSolverSettings settings;
+			settings.graphReductionLevel = reductionLevel;
+			ExtStressSolver* solver = ExtStressSolver::create(*family, settings);
+			solver->setAllNodesInfoFromLL();
+			solver->notifyActorCreated(*actor);
+
+			const std::string timingName = std::string(testName) + " " + structure.name + " nodes " + std::to_string(nodeCount) + " reduction " + std::to_string(reductionLevel);
+
+			for (uint32_t frame = 0; frame < frameCount; ++frame)
+			{
+				solver->addGravityForce(*actor, gravity);
+
+				// prepareUpdate() syncs the solver graph, solveUpdate() only solves it
+				Time time;
+				solver->prepareUpdate();
+				const int64_t syncTime = time.getElapsedTicks();
+				solver->solveUpdate();
+				const int64_t solveTime = time.getElapsedTicks();
+
+				// the first frame builds the solver graph and cold starts the solve, report it apart
+				const std::string frameName = frame == 0 ? timingName + " first" : timingName;
+				reportData(frameName + " sync", syncTime);
+				reportData(frameName + " solve", solveTime);
+				reportData(frameName + " update", syncTime + solveTime);
+
+				// time per 1000 bond iterations, to compare solvers of different sizes, on warm frames only
+				if (frame > 0)
+				{
+					const int64_t bondIterations = (int64_t)solver->getIterationsPerFrame() * (solver->getBondCount() + 1);
+					reportData(timingName + " solve per 1000 bond iterations", solveTime * 1000 / bondIterations);
+				}
+
+				// convergence, error per bond in millionths
+				const float error = (solver->getStressErrorLinear() + solver->getStressErrorAngular()) / (solver->getBondCount() + 1);
+				reportData(timingName + " error frame " + std::to_string(frame), (int64_t)(error * 1.0e6f));
+			}
+
+			// soften the bonds until they break under gravity
+			settings.hardness = 1.0e-3f;
+			solver->setSettings(settings);
+			solver->addGravityForce(*actor, gravity);
+			solver->update();
+
+			NvBlastFractureBuffers commands;
+			Time time;
+			solver->generateFractureCommands(commands);
+			reportData(timingName + " fracture commands", time.getElapsedTicks());
+			EXPECT_TRUE(commands.bondFractureCount > 0);
+			EXPECT_TRUE(commands.bondFractureCount <= bondCount);
+
+			solver->release();
+			NvBlastActorDeactivate(actor, messageLog);
+			alignedFree(familyMem);
+		}
+
+		alignedFree(assetMem);
+	}
+
+	void stressStructures(const char* testName, const StressStructure& structure)
+	{
+		for (uint32_t nodeCount : s_nodeCounts)
+		{
+			stressStructure(testName, structure, nodeCount, 8, 3);
+		}
+	}
+};
+
+
+// Tests
+TEST_F(StressPerfTest, DISABLED_StressTower)
+{
+	stressStructures(test_info_->name(), s_structures[0]);
+}
+
+TEST_F(StressPerfTest, DISABLED_StressBridge)
+{
+	stressStructures(test_info_->name(), s_structures[1]);
+}
+
+TEST_F(StressPerfTest, DISABLED_StressGrid)
+{
+	stressStructures(test_info_->name(), s_structures[2]);
+}
@@ -41,6 +41,80 @@ using namespace Nv::Blast;
 
 class APITest : public BlastBaseTest < NvBlastMessage::Error, 1 >
 {
+public:
+	/**
+	Bond fracture commands of a damage program on the ring of DamageBondsCompressive, sorted by node.
+	Bond i connects the graph nodes i and i + 1, the bond centroids b0 to b5 are (1, 2), (-1, 2), (-2, 1), (-2, -1),
+	(-1, -2) and (1, -2).
+	*/
+	std::vector<NvBlastBondFractureData> damageRingBonds(const NvBlastDamageProgram& program, const void* damageDesc)
+	{
+		const uint32_t bondsCount = 6;
+
+		const NvBlastChunkDesc c_chunks[8] =
+		{
+			// centroid           volume parent idx		flags                         ID
+			{ {0.0f, 0.0f, 0.0f}, 0.0f, UINT32_MAX, NvBlastChunkDesc::NoFlags, 0 },
+			{ {0.0f, 0.0f, 0.0f}, 0.0f, 0, NvBlastChunkDesc::SupportFlag, 1 },
+			{ {0.0f, 0.0f, 0.0f}, 0.0f, 0, NvBlastChunkDesc::SupportFlag, 2 },
+			{ {0.0f, 0.0f, 0.0f}, 0.0f, 0, NvBlastChunkDesc::SupportFlag, 3 },
+			{ {0.0f, 0.0f, 0.0f}, 0.0f, 0, NvBlastChunkDesc::SupportFlag, 4 },
+			{ {0.0f, 0.0f, 0.0f}, 0.0f, 0, NvBlastChunkDesc::SupportFlag, 5 },
+			{ {0.0f, 0.0f, 0.0f}, 0.0f, 0, NvBlastChunkDesc::SupportFlag, 6 },
+			{ {0.0f, 0.0f, 0.0f}, 0.0f, 0, NvBlastChunkDesc::SupportFlag, 7 }
+		};
+
+		const NvBlastBondDesc c_bonds[bondsCount] =
+		{
+			{ { {-1.0f, 0.0f, 0.0f }, 1.0f, { 1.0f, 2.0f, 0.0f }, 0 }, { 1, 2 } },
+			{ { {-1.0f, 0.0f, 0.0f }, 1.0f, {-1.0f, 2.0f, 0.0f }, 0 }, { 2, 3 } },
+			{ { { 0.0f,-1.0f, 0.0f }, 1.0f, {-2.0f, 1.0f, 0.0f }, 0 }, { 3, 4 } },
+			{ { { 0.0f,-1.0f, 0.0f }, 1.0f, {-2.0f,-1.0f, 0.0f }, 0 }, { 4, 5 } },
+			{ { { 1.0f, 0.0f, 0.0f }, 1.0f, {-1.0f,-2.0f, 0.0f }, 0 }, { 5, 6 } },
+			{ { { 1.0f, 0.0f, 0.0f }, 1.0f, { 1.0f,-2.0f, 0.0f }, 0 }, { 6, 7 } }
+		};
+
+		const NvBlastAssetDesc assetDesc = { 8, c_chunks, bondsCount, c_bonds };
+
+		std::vector<char> scratch((size_t)NvBlastGetRequiredScratchForCreateAsset(&assetDesc, messageLog));
+		void* amem = alignedZeroedAlloc(NvBlastGetAssetMemorySize(&assetDesc, messageLog));
+		NvBlastAsset* asset = NvBlastCreateAsset(amem, &assetDesc, scratch.data(), messageLog);
+		EXPECT_TRUE(asset != nullptr);
+
+		NvBlastActorDesc actorDesc;
+		actorDesc.initialBondHealths = actorDesc.initialSupportChunkHealths = nullptr;
+		actorDesc.uniformInitialBondHealth = actorDesc.uniformInitialLowerSupportChunkHealth = 1.0f;
+		void* fmem = alignedZeroedAlloc(NvBlastAssetGetFamilyMemorySize(asset, messageLog));
+		NvBlastFamily* family = NvBlastAssetCreateFamily(fmem, asset, messageLog);
+		scratch.resize((size_t)NvBlastFamilyGetRequiredScratchForCreateFirstActor(family, messageLog));
+		NvBlastActor* actor = NvBlastFamilyCreateFirstActor(family, &actorDesc, scratch.data(), messageLog);
+		EXPECT_TRUE(actor != nullptr);
+
+		std::vector<NvBlastBondFractureData> outCommands(bondsCount);
+		NvBlastFractureBuffers commands = { bondsCount, 0, outCommands.data(), nullptr };
+		const NvBlastExtProgramParams programParams(damageDesc);
+		NvBlastActorGenerateFracture(&commands, actor, program, &programParams, messageLog, nullptr);
+		EXPECT_EQ(0, commands.chunkFractureCount);
+
+		outCommands.resize(commands.bondFractureCount);
+		std::sort(outCommands.begin(), outCommands.end(), [](const NvBlastBondFractureData& a, const NvBlastBondFractureData& b) { return a.nodeIndex0 < b.nodeIndex0; });
+
+		EXPECT_TRUE(NvBlastActorDeactivate(actor, messageLog));
+		alignedFree(family);
+		alignedFree(asset);
+		return outCommands;
+	}
+
+	void expectCommands(const std::vector<NvBlastBondFractureData>& expected, const std::vector<NvBlastBondFractureData>& commands)
+	{
+		ASSERT_EQ(expected.size(), commands.size());
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			EXPECT_EQ(expected[i].nodeIndex0, commands[i].nodeIndex0);
+			EXPECT_EQ(expected[i].nodeIndex1, commands[i].nodeIndex1);
+			EXPECT_FLOAT_EQ(expected[i].health, commands[i].health);
+		}
+	}
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -215,6 +289,92 @@ TEST_F(APITest, DamageBondsCompressive)
 	alignedFree(asset);
 }
 
+TEST_F(APITest, DamageBondsCone)
+{
+	const NvBlastDamageProgram program = { NvBlastExtConeFalloffGraphShader, NvBlastExtConeFalloffSubgraphShader };
+
+	// cone along +x from the origin, b0 and b5 are 0.7 from its surface
+	NvBlastExtConeDamageDesc damage = {
+		1.0f,					// compressive
+		{ 0.0f, 0.0f, 0.0f },	// apex
+		{ 4.0f, 0.0f, 0.0f },	// base center
+		0.785398f,				// half angle, 45 degrees
+		1.0f,					// min radius - maximum damage
+		2.0f					// max radius - zero damage
+	};
+	expectCommands({ { 0, 0, 1, 1.0f }, { 0, 5, 6, 1.0f } }, damageRingBonds(program, &damage));
+
+	// angles beyond PI/2 are clamped below it: a half space in front of the apex, b2 and b3 are culled behind it
+	damage.angle = 2.0f;
+	damage.minRadius = 0.5f;
+	damage.maxRadius = 1.5f;
+	std::vector<NvBlastBondFractureData> commands = damageRingBonds(program, &damage);
+	ASSERT_EQ(4u, commands.size());
+	EXPECT_EQ(0, commands[0].nodeIndex0);
+	EXPECT_EQ(1.0f, commands[0].health);
+	EXPECT_EQ(5, commands[3].nodeIndex0);
+	EXPECT_EQ(1.0f, commands[3].health);
+	for (const NvBlastBondFractureData& command : commands)
+	{
+		EXPECT_TRUE(command.health > 0.0f && command.health <= 1.0f);
+		EXPECT_TRUE(command.nodeIndex0 != 2 && command.nodeIndex0 != 3);
+	}
+
+	// negative angles are clamped to 0: the segment from apex to base, 2 from b0 and b5
+	damage.angle = -0.5f;
+	damage.minRadius = 0.5f;
+	damage.maxRadius = 2.5f;
+	commands = damageRingBonds(program, &damage);
+	ASSERT_LE(2u, commands.size());
+	EXPECT_EQ(0, commands.front().nodeIndex0);
+	EXPECT_FLOAT_EQ(0.25f, commands.front().health);
+	EXPECT_EQ(5, commands.back().nodeIndex0);
+	EXPECT_FLOAT_EQ(0.25f, commands.back().health);
+}
+
+TEST_F(APITest, DamageBondsBox)
+{
+	const NvBlastDamageProgram program = { NvBlastExtBoxFalloffGraphShader, NvBlastExtBoxFalloffSubgraphShader };
+
+	// box around b0 and b1, b2 is 0.7 from it
+	NvBlastExtBoxDamageDesc damage = {
+		1.0f,							// compressive
+		{ 0.0f, 2.0f, 0.0f },			// center
+		{ 1.5f, 0.5f, 1.0f },			// half extents
+		{ 0.0f, 0.0f, 0.0f, 1.0f },		// rotation
+		0.0f,							// min radius - maximum damage
+		0.5f							// max radius - zero damage
+	};
+	expectCommands({ { 0, 0, 1, 1.0f }, { 0, 1, 2, 1.0f } }, damageRingBonds(program, &damage));
+
+	// the same box turned by 90 degrees around z, around b2 and b3
+	damage.position[0] = -2.0f;
+	damage.position[1] = 0.0f;
+	damage.rotation[2] = damage.rotation[3] = 0.70710678f;
+	expectCommands({ { 0, 2, 3, 1.0f }, { 0, 3, 4, 1.0f } }, damageRingBonds(program, &damage));
+}
+
+TEST_F(APITest, DamageBondsFrustum)
+{
+	const NvBlastDamageProgram program = { NvBlastExtFrustumFalloffGraphShader, NvBlastExtFrustumFalloffSubgraphShader };
+
+	// 0.5 <= x <= 3, |y| <= 3, |z| <= 1: b0 and b5 inside, b1 and b4 1.5 from the left plane, b2 and b3 2.5
+	NvBlastExtFrustumDamageDesc damage = {
+		1.0f,								// compressive
+		{
+			{-1.0f, 0.0f, 0.0f, 0.5f },		// left
+			{ 1.0f, 0.0f, 0.0f,-3.0f },		// right
+			{ 0.0f,-1.0f, 0.0f,-3.0f },		// bottom
+			{ 0.0f, 1.0f, 0.0f,-3.0f },		// top
+			{ 0.0f, 0.0f,-1.0f,-1.0f },		// near
+			{ 0.0f, 0.0f, 1.0f,-1.0f }		// far
+		},
+		0.5f,								// min radius - maximum damage
+		2.0f								// max radius - zero damage
+	};
+	expectCommands({ { 0, 0, 1, 1.0f }, { 0, 1, 2, 1.0f / 3.0f }, { 0, 4, 5, 1.0f / 3.0f }, { 0, 5, 6, 1.0f } }, damageRingBonds(program, &damage));
+}
+
 TEST_F(APITest, DirectFractureKillsChunk)
 {
 	// 1--2
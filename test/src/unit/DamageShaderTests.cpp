@@ -0,0 +1,874 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+
+#include "BlastBaseTest.h"
+#include "NvBlastIndexFns.h"
+#include "NvBlastExtDamageShaders.h"
+#include "NvBlastExtDamageAcceleratorInternal.h"
+#include "NvBlastExtDamageField.h"
+#include "NvBlastActor.h"
+
+#include "PxPlane.h"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Utils / Tests Common
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace Nv::Blast;
+using namespace physx;
+
+class DamageShaderTest : public BlastBaseTest < NvBlastMessage::Error, 1 >
+{
+public:
+	/**
+	Collects the bond indices reported by an accelerator query, sorted for comparison, and the node0 of each in report order.
+	*/
+	class BondCollector : public ExtDamageAcceleratorInternal::ResultCallback
+	{
+	public:
+		BondCollector() : ResultCallback(m_buffer, sizeof(m_buffer) / sizeof(m_buffer[0])) {}
+
+		virtual void processResults(const ExtDamageAcceleratorInternal::QueryBondData* bondBuffer, uint32_t count) override
+		{
+			for (uint32_t i = 0; i < count; i++)
+			{
+				bonds.push_back(bondBuffer[i].bond);
+				nodes0.push_back(bondBuffer[i].node0);
+			}
+		}
+
+		std::vector<uint32_t> sorted()
+		{
+			std::sort(bonds.begin(), bonds.end());
+			return bonds;
+		}
+
+		std::vector<uint32_t> bonds;
+		std::vector<uint32_t> nodes0;
+
+	private:
+		ExtDamageAcceleratorInternal::QueryBondData m_buffer[64];
+	};
+
+	virtual void TearDown() override
+	{
+		for (void* mem : m_familyMems)
+		{
+			alignedFree(mem);
+		}
+		m_familyMems.clear();
+		for (void* mem : m_assetMems)
+		{
+			alignedFree(mem);
+		}
+		m_assetMems.clear();
+	}
+
+	// cube of width^3 support chunks in [-0.5, 0.5]^3
+	NvBlastAsset* createCubeAsset(size_t width)
+	{
+		GeneratorAsset cube;
+		NvBlastAssetDesc assetDesc;
+		generateCube(cube, assetDesc, 2, width);
+
+		std::vector<char> scratch((size_t)NvBlastGetRequiredScratchForCreateAsset(&assetDesc, messageLog));
+		void* mem = alignedZeroedAlloc(NvBlastGetAssetMemorySize(&assetDesc, messageLog));
+		NvBlastAsset* asset = NvBlastCreateAsset(mem, &assetDesc, scratch.data(), messageLog);
+		EXPECT_TRUE(asset != nullptr);
+		m_assetMems.push_back(mem);
+		return asset;
+	}
+
+	NvBlastActor* createFirstActor(const NvBlastAsset* asset)
+	{
+		void* mem = alignedZeroedAlloc(NvBlastAssetGetFamilyMemorySize(asset, messageLog));
+		NvBlastFamily* family = NvBlastAssetCreateFamily(mem, asset, messageLog);
+		m_familyMems.push_back(mem);
+
+		NvBlastActorDesc actorDesc;
+		actorDesc.initialBondHealths = actorDesc.initialSupportChunkHealths = nullptr;
+		actorDesc.uniformInitialBondHealth = actorDesc.uniformInitialLowerSupportChunkHealth = 1.0f;
+		std::vector<char> scratch((size_t)NvBlastFamilyGetRequiredScratchForCreateFirstActor(family, messageLog));
+		NvBlastActor* actor = NvBlastFamilyCreateFirstActor(family, &actorDesc, scratch.data(), messageLog);
+		EXPECT_TRUE(actor != nullptr);
+		return actor;
+	}
+
+	// fracture every bond of the actor with centroid[axis] == coord, and split the actor
+	std::vector<NvBlastActor*> slice(NvBlastActor* actor, uint32_t axis, float coord)
+	{
+		const NvBlastFamily* family = NvBlastActorGetFamily(actor, messageLog);
+		const NvBlastAsset* asset = NvBlastFamilyGetAsset(family, messageLog);
+		const NvBlastSupportGraph graph = NvBlastAssetGetSupportGraph(asset, messageLog);
+		const NvBlastBond* bonds = NvBlastAssetGetBonds(asset, messageLog);
+
+		std::vector<NvBlastBondFractureData> bondFractures;
+		for (uint32_t node0 = 0; node0 < graph.nodeCount; node0++)
+		{
+			for (uint32_t i = graph.adjacencyPartition[node0]; i < graph.adjacencyPartition[node0 + 1]; i++)
+			{
+				const uint32_t node1 = graph.adjacentNodeIndices[i];
+				if (node0 < node1 && bonds[graph.adjacentBondIndices[i]].centroid[axis] == coord
+					&& NvBlastFamilyGetChunkActor(family, graph.chunkIndices[node0], messageLog) == actor)
+				{
+					const NvBlastBondFractureData data = { 0, node0, node1, 1.0f };
+					bondFractures.push_back(data);
+				}
+			}
+		}
+		NvBlastFractureBuffers commands = { (uint32_t)bondFractures.size(), 0, bondFractures.data(), nullptr };
+		NvBlastActorApplyFracture(nullptr, actor, &commands, messageLog, nullptr);
+
+		std::vector<NvBlastActor*> newActors(NvBlastActorGetMaxActorCountForSplit(actor, messageLog));
+		NvBlastActorSplitEvent result = { nullptr, newActors.data() };
+		std::vector<char> scratch((size_t)NvBlastActorGetRequiredScratchForSplit(actor, messageLog));
+		newActors.resize(NvBlastActorSplit(&result, actor, (uint32_t)newActors.size(), scratch.data(), messageLog, nullptr));
+		return newActors;
+	}
+
+	// the actor as a graph shader sees it, its arrays point to the family and stay valid until the family changes
+	NvBlastGraphShaderActor getGraphShaderActor(const NvBlastActor* actor)
+	{
+		struct Capture
+		{
+			static void graphShader(NvBlastFractureBuffers*, const NvBlastGraphShaderActor* shaderActor, const void* params)
+			{
+				*static_cast<NvBlastGraphShaderActor*>(const_cast<void*>(params)) = *shaderActor;
+			}
+		};
+
+		NvBlastGraphShaderActor shaderActor = {};
+		NvBlastBondFractureData bondFracture;
+		NvBlastFractureBuffers commands = { 1, 0, &bondFracture, nullptr };
+		const NvBlastDamageProgram program = { Capture::graphShader, nullptr };
+		NvBlastActorGenerateFracture(&commands, actor, program, &shaderActor, messageLog, nullptr);
+		return shaderActor;
+	}
+
+	// damage of every bond of the asset from a graph shader call, 0 for the bonds without fracture command
+	std::vector<float> getBondDamages(const NvBlastActor* actor, const NvBlastDamageProgram& program, const NvBlastExtProgramParams& programParams)
+	{
+		const NvBlastAsset* asset = NvBlastFamilyGetAsset(NvBlastActorGetFamily(actor, messageLog), messageLog);
+		const NvBlastSupportGraph graph = NvBlastAssetGetSupportGraph(asset, messageLog);
+		const uint32_t bondCount = NvBlastAssetGetBondCount(asset, messageLog);
+
+		std::vector<NvBlastBondFractureData> bondFractures(bondCount);
+		NvBlastFractureBuffers commands = { bondCount, 0, bondFractures.data(), nullptr };
+		NvBlastActorGenerateFracture(&commands, actor, program, &programParams, messageLog, nullptr);
+
+		std::vector<float> damages(bondCount, 0.0f);
+		for (uint32_t i = 0; i < commands.bondFractureCount; i++)
+		{
+			const NvBlastBondFractureData& data = commands.bondFractures[i];
+			for (uint32_t adj = graph.adjacencyPartition[data.nodeIndex0]; adj < graph.adjacencyPartition[data.nodeIndex0 + 1]; adj++)
+			{
+				if (graph.adjacentNodeIndices[adj] == data.nodeIndex1)
+				{
+					damages[graph.adjacentBondIndices[adj]] = data.health;
+				}
+			}
+		}
+		return damages;
+	}
+
+private:
+	std::vector<void*> m_assetMems;
+	std::vector<void*> m_familyMems;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//														Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(DamageShaderTest, AcceleratorBVH4MatchesAABBTree)
+{
+	// 2 wide: fewer bonds than one leaf per child, the BVH4 root has unused children
+	for (size_t width : { 2, 10 })
+	{
+		NvBlastAsset* asset = createCubeAsset(width);
+		const uint32_t bondCount = NvBlastAssetGetBondCount(asset, messageLog);
+
+		NvBlastExtDamageAccelerator* aabbTreeAccelerator = NvBlastExtDamageAcceleratorCreate(asset, 1);
+		NvBlastExtDamageAccelerator* bvh4Accelerator = NvBlastExtDamageAcceleratorCreate(asset, 2);
+		const ExtDamageAcceleratorInternal* aabbTree = static_cast<const ExtDamageAcceleratorInternal*>(aabbTreeAccelerator);
+		const ExtDamageAcceleratorInternal* bvh4 = static_cast<const ExtDamageAcceleratorInternal*>(bvh4Accelerator);
+
+		auto expectSameBounds = [&](const PxBounds3& bounds)
+		{
+			BondCollector expected, actual;
+			aabbTree->findBondCentroidsInBounds(bounds, expected);
+			bvh4->findBondCentroidsInBounds(bounds, actual);
+			EXPECT_EQ(expected.sorted(), actual.sorted());
+
+			BondCollector expectedSegments, actualSegments;
+			aabbTree->findBondSegmentsInBounds(bounds, expectedSegments);
+			bvh4->findBondSegmentsInBounds(bounds, actualSegments);
+			EXPECT_EQ(expectedSegments.sorted(), actualSegments.sorted());
+		};
+
+		// infinite bounds find every bond once
+		const PxBounds3 infinite(PxVec3(-PX_MAX_F32), PxVec3(PX_MAX_F32));
+		BondCollector all;
+		bvh4->findBondCentroidsInBounds(infinite, all);
+		std::vector<uint32_t> allBonds(bondCount);
+		for (uint32_t i = 0; i < bondCount; i++)
+		{
+			allBonds[i] = i;
+		}
+		EXPECT_EQ(allBonds, all.sorted());
+		expectSameBounds(infinite);
+
+		std::mt19937 rnd(static_cast<uint32_t>(width));
+		std::uniform_real_distribution<float> coord(-0.75f, 0.75f);
+		for (uint32_t i = 0; i < 100; i++)
+		{
+			const PxVec3 p0(coord(rnd), coord(rnd), coord(rnd));
+			const PxVec3 p1(coord(rnd), coord(rnd), coord(rnd));
+			expectSameBounds(PxBounds3(p0.minimum(p1), p0.maximum(p1)));
+
+			const PxVec3 normal = (p1 - p0).getNormalized();
+			const PxPlane plane(p0, normal);
+			BondCollector expected, actual;
+			aabbTree->findBondSegmentsPlaneIntersected(plane, expected);
+			bvh4->findBondSegmentsPlaneIntersected(plane, actual);
+			EXPECT_EQ(expected.sorted(), actual.sorted());
+		}
+
+		aabbTreeAccelerator->release();
+		bvh4Accelerator->release();
+	}
+}
+
+TEST_F(DamageShaderTest, AcceleratorActorFilter)
+{
+	NvBlastAsset* asset = createCubeAsset(10);
+	NvBlastActor* actor = createFirstActor(asset);
+	const uint32_t bondCount = NvBlastAssetGetBondCount(asset, messageLog);
+
+	// 3 actors: the x > 0 half and the x < 0 half cut in two along y
+	std::vector<NvBlastActor*> halves = slice(actor, 0, 0.0f);
+	ASSERT_EQ(2u, halves.size());
+	std::vector<NvBlastActor*> actors = slice(halves[0], 1, 0.0f);
+	ASSERT_EQ(2u, actors.size());
+	actors.push_back(halves[1]);
+
+	const uint32_t* nodeActorIndices = static_cast<Actor*>(actor)->getFamilyHeader()->getFamilyGraph()->getIslandIds();
+
+	NvBlastExtDamageAccelerator* accelerators[] = { NvBlastExtDamageAcceleratorCreate(asset, 1), NvBlastExtDamageAcceleratorCreate(asset, 2) };
+
+	// every query reports the bonds the unfiltered query finds with node0 in the actor, each bond for exactly one actor
+	auto expectFiltered = [&](const std::function<void(BondCollector&)>& query)
+	{
+		BondCollector unfiltered;
+		query(unfiltered);
+
+		std::vector<uint32_t> allFiltered;
+		for (NvBlastActor* a : actors)
+		{
+			const uint32_t actorIndex = NvBlastActorGetIndex(a, messageLog);
+
+			std::vector<uint32_t> expected;
+			for (size_t i = 0; i < unfiltered.bonds.size(); i++)
+			{
+				if (nodeActorIndices[unfiltered.nodes0[i]] == actorIndex)
+				{
+					expected.push_back(unfiltered.bonds[i]);
+				}
+			}
+			std::sort(expected.begin(), expected.end());
+
+			BondCollector filtered;
+			filtered.setActorFilter(nodeActorIndices, actorIndex);
+			query(filtered);
+			EXPECT_EQ(expected, filtered.sorted());
+			for (uint32_t node0 : filtered.nodes0)
+			{
+				EXPECT_EQ(actorIndex, nodeActorIndices[node0]);
+			}
+			allFiltered.insert(allFiltered.end(), filtered.bonds.begin(), filtered.bonds.end());
+		}
+		std::sort(allFiltered.begin(), allFiltered.end());
+		EXPECT_EQ(unfiltered.sorted(), allFiltered);
+	};
+
+	for (NvBlastExtDamageAccelerator* accelerator : accelerators)
+	{
+		const ExtDamageAcceleratorInternal* internal = static_cast<const ExtDamageAcceleratorInternal*>(accelerator);
+
+		const PxBounds3 infinite(PxVec3(-PX_MAX_F32), PxVec3(PX_MAX_F32));
+		BondCollector all;
+		internal->findBondCentroidsInBounds(infinite, all);
+		EXPECT_EQ(bondCount, all.bonds.size());
+		expectFiltered([&](BondCollector& cb) { internal->findBondCentroidsInBounds(infinite, cb); });
+
+		std::mt19937 rnd(0);
+		std::uniform_real_distribution<float> coord(-0.75f, 0.75f);
+		for (uint32_t i = 0; i < 50; i++)
+		{
+			const PxVec3 p0(coord(rnd), coord(rnd), coord(rnd));
+			const PxVec3 p1(coord(rnd), coord(rnd), coord(rnd));
+			const PxBounds3 bounds(p0.minimum(p1), p0.maximum(p1));
+			const PxPlane plane(p0, (p1 - p0).getNormalized());
+			expectFiltered([&](BondCollector& cb) { internal->findBondCentroidsInBounds(bounds, cb); });
+			expectFiltered([&](BondCollector& cb) { internal->findBondSegmentsInBounds(bounds, cb); });
+			expectFiltered([&](BondCollector& cb) { internal->findBondSegmentsPlaneIntersected(plane, cb); });
+		}
+
+		accelerator->release();
+	}
+}
+
+TEST_F(DamageShaderTest, AcceleratorClosestNodeMatchesLinearSearch)
+{
+	NvBlastAsset* asset = createCubeAsset(10);
+	NvBlastActor* actor = createFirstActor(asset);
+	const NvBlastSupportGraph graph = NvBlastAssetGetSupportGraph(asset, messageLog);
+	const NvBlastChunk* chunks = NvBlastAssetGetChunks(asset, messageLog);
+
+	std::vector<NvBlastActor*> halves = slice(actor, 0, 0.0f);
+	ASSERT_EQ(2u, halves.size());
+
+	// kill a quarter of the support chunks of one half, without splitting it: dead nodes stay in the actor
+	std::mt19937 rnd(0);
+	std::vector<NvBlastChunkFractureData> chunkFractures;
+	const NvBlastFamily* family = NvBlastActorGetFamily(halves[0], messageLog);
+	for (uint32_t node = 0; node < graph.nodeCount; node++)
+	{
+		if (!isInvalidIndex(graph.chunkIndices[node]) && NvBlastFamilyGetChunkActor(family, graph.chunkIndices[node], messageLog) == halves[0] && rnd() % 4 == 0)
+		{
+			const NvBlastChunkFractureData data = { 0, graph.chunkIndices[node], 1.0f };
+			chunkFractures.push_back(data);
+		}
+	}
+	ASSERT_FALSE(chunkFractures.empty());
+	NvBlastFractureBuffers commands = { 0, (uint32_t)chunkFractures.size(), nullptr, chunkFractures.data() };
+	NvBlastActorApplyFracture(nullptr, halves[0], &commands, messageLog, nullptr);
+
+	auto findClosestNodeLinear = [&](const PxVec3& point, const NvBlastGraphShaderActor& shaderActor)
+	{
+		uint32_t closestNode = invalidIndex<uint32_t>();
+		float minDistSq = PX_MAX_F32;
+		for (uint32_t node = 0; node < graph.nodeCount; node++)
+		{
+			if (isInvalidIndex(graph.chunkIndices[node]) || shaderActor.nodeActorIndices[node] != shaderActor.actorIndex || shaderActor.supportChunkHealths[node] <= 0.0f)
+			{
+				continue;
+			}
+			const float distSq = (point - reinterpret_cast<const PxVec3&>(chunks[graph.chunkIndices[node]].centroid)).magnitudeSquared();
+			if (distSq < minDistSq)
+			{
+				minDistSq = distSq;
+				closestNode = node;
+			}
+		}
+		return closestNode;
+	};
+
+	NvBlastExtDamageAccelerator* accelerators[] = { NvBlastExtDamageAcceleratorCreate(asset, 1), NvBlastExtDamageAcceleratorCreate(asset, 2) };
+	std::uniform_real_distribution<float> coord(-0.75f, 0.75f);
+	std::uniform_real_distribution<float> farCoord(-10.0f, 10.0f);
+	for (NvBlastActor* half : halves)
+	{
+		const NvBlastGraphShaderActor shaderActor = getGraphShaderActor(half);
+		ASSERT_EQ(NvBlastActorGetIndex(half, messageLog), shaderActor.actorIndex);
+
+		for (uint32_t i = 0; i < 200; i++)
+		{
+			const PxVec3 point = i % 10 == 0 ? PxVec3(farCoord(rnd), farCoord(rnd), farCoord(rnd)) : PxVec3(coord(rnd), coord(rnd), coord(rnd));
+			const uint32_t expected = findClosestNodeLinear(point, shaderActor);
+			ASSERT_FALSE(isInvalidIndex(expected));
+			for (NvBlastExtDamageAccelerator* accelerator : accelerators)
+			{
+				EXPECT_EQ(expected, static_cast<const ExtDamageAcceleratorInternal*>(accelerator)->findClosestNode(point, &shaderActor));
+			}
+		}
+	}
+
+	for (NvBlastExtDamageAccelerator* accelerator : accelerators)
+	{
+		accelerator->release();
+	}
+}
+
+TEST_F(DamageShaderTest, DamageFieldDeposit)
+{
+	NvBlastAsset* asset = createCubeAsset(4);
+	NvBlastActor* actor = createFirstActor(asset);
+	NvBlastFamily* family = NvBlastActorGetFamily(actor, messageLog);
+	const uint32_t bondCount = NvBlastAssetGetBondCount(asset, messageLog);
+
+	ExtDamageField* field = ExtDamageField::create(*family);
+	EXPECT_EQ(0u, field->getAccumulatedBondCount());
+
+	// bond damage adds up, nothing is pending before update()
+	field->addBondDamage(0, 0.25f);
+	field->addBondDamage(0, 0.25f);
+	field->addBondDamage(0, 0.0f);
+	field->addBondDamage(1, 0.0f);
+	EXPECT_EQ(1u, field->getAccumulatedBondCount());
+	EXPECT_EQ(0.5f, field->getAccumulatedDamage(0));
+	EXPECT_EQ(0.0f, field->getAccumulatedDamage(1));
+	EXPECT_EQ(0u, field->getPendingBondCount());
+
+	field->reset();
+	EXPECT_EQ(0u, field->getAccumulatedBondCount());
+	EXPECT_EQ(0.0f, field->getAccumulatedDamage(0));
+
+	// volume damage finds the same bonds with and without accelerator, and adds the shaders' falloff
+	NvBlastExtDamageAccelerator* accelerator = NvBlastExtDamageAcceleratorCreate(asset, 1);
+	ExtDamageField* acceleratedField = ExtDamageField::create(*family, accelerator);
+
+	// centered on the bond between the chunks centered at (0.125, 0.125, 0.125) and (0.375, 0.125, 0.125)
+	const NvBlastExtRadialDamageDesc radial = { 0.5f, { 0.25f, 0.125f, 0.125f }, 0.1f, 0.4f };
+	const NvBlastExtCapsuleRadialDamageDesc capsule = { 0.5f, { -0.5f, -0.25f, 0.0f }, { 0.5f, -0.25f, 0.0f }, 0.0f, 0.2f };
+	for (ExtDamageField* f : { field, acceleratedField })
+	{
+		f->addRadialDamage(radial);
+		f->addCapsuleDamage(capsule);
+	}
+	EXPECT_LT(0u, field->getAccumulatedBondCount());
+	EXPECT_GT(bondCount, field->getAccumulatedBondCount());
+	EXPECT_EQ(field->getAccumulatedBondCount(), acceleratedField->getAccumulatedBondCount());
+
+	const NvBlastBond* bonds = NvBlastAssetGetBonds(asset, messageLog);
+	uint32_t fullDamageCount = 0;
+	for (uint32_t bondIndex = 0; bondIndex < bondCount; bondIndex++)
+	{
+		EXPECT_FLOAT_EQ(field->getAccumulatedDamage(bondIndex), acceleratedField->getAccumulatedDamage(bondIndex));
+
+		const PxVec3& centroid = reinterpret_cast<const PxVec3&>(bonds[bondIndex].centroid);
+		if ((centroid - reinterpret_cast<const PxVec3&>(radial.position)).magnitude() < radial.minRadius)
+		{
+			EXPECT_LE(radial.damage, field->getAccumulatedDamage(bondIndex));
+			fullDamageCount++;
+		}
+	}
+	EXPECT_EQ(1u, fullDamageCount);
+
+	acceleratedField->release();
+	accelerator->release();
+	field->release();
+}
+
+TEST_F(DamageShaderTest, DamageFieldThresholdAndFlush)
+{
+	NvBlastAsset* asset = createCubeAsset(4);
+	NvBlastActor* actor = createFirstActor(asset);
+	NvBlastFamily* family = NvBlastActorGetFamily(actor, messageLog);
+
+	ExtDamageFieldSettings settings;
+	settings.fractureThreshold = 0.5f;
+	ExtDamageField* field = ExtDamageField::create(*family, nullptr, settings);
+
+	// pending once the damage reaches the threshold times the bond health of 1
+	field->addBondDamage(0, 0.25f);
+	field->update(0.1f);
+	EXPECT_EQ(0u, field->getPendingBondCount());
+	field->addBondDamage(0, 0.25f);
+	field->update(0.1f);
+	EXPECT_EQ(1u, field->getPendingBondCount());
+
+	// lower damage is kept without a flush interval
+	field->reset();
+	field->addBondDamage(1, 0.1f);
+	for (uint32_t i = 0; i < 10; i++)
+	{
+		field->update(1.0f);
+	}
+	EXPECT_EQ(0u, field->getPendingBondCount());
+	EXPECT_EQ(0.1f, field->getAccumulatedDamage(1));
+
+	// every accumulated damage is pending once the flush interval elapsed, until commands are generated
+	settings.flushInterval = 1.0f;
+	field->setSettings(settings);
+	field->reset();
+	field->addBondDamage(1, 0.1f);
+	field->addBondDamage(2, 0.2f);
+	field->update(0.5f);
+	EXPECT_EQ(0u, field->getPendingBondCount());
+	field->update(0.5f);
+	EXPECT_EQ(2u, field->getPendingBondCount());
+	field->update(0.1f);
+	EXPECT_EQ(2u, field->getPendingBondCount());
+
+	NvBlastFractureBuffers commands;
+	field->generateFractureCommands(commands);
+	EXPECT_EQ(2u, commands.bondFractureCount);
+	EXPECT_EQ(0u, field->getAccumulatedBondCount());
+
+	field->addBondDamage(1, 0.1f);
+	field->update(0.1f);
+	EXPECT_EQ(0u, field->getPendingBondCount());
+
+	field->release();
+}
+
+TEST_F(DamageShaderTest, DamageFieldFractureCommands)
+{
+	NvBlastAsset* asset = createCubeAsset(4);
+	NvBlastActor* actor = createFirstActor(asset);
+	NvBlastFamily* family = NvBlastActorGetFamily(actor, messageLog);
+	const uint32_t bondCount = NvBlastAssetGetBondCount(asset, messageLog);
+	const float* bondHealths = NvBlastActorGetBondHealths(actor, messageLog);
+
+	ExtDamageField* field = ExtDamageField::create(*family);
+
+	// one bond is fractured, the other one is damaged
+	field->addBondDamage(0, 1.0f);
+	field->addBondDamage(1, 0.5f);
+	field->update(0.1f);
+	ASSERT_EQ(1u, field->getPendingBondCount());
+
+	NvBlastFractureBuffers commands;
+	field->generateFractureCommands(commands);
+	ASSERT_EQ(1u, commands.bondFractureCount);
+	EXPECT_EQ(0u, commands.chunkFractureCount);
+	EXPECT_EQ(1.0f, commands.bondFractures[0].health);
+	EXPECT_EQ(0u, field->getPendingBondCount());
+	EXPECT_EQ(1u, field->getAccumulatedBondCount());
+
+	NvBlastActorApplyFracture(nullptr, actor, &commands, messageLog, nullptr);
+	EXPECT_EQ(0.0f, bondHealths[0]);
+	EXPECT_EQ(1.0f, bondHealths[1]);
+
+	// damage on bonds broken since is dropped
+	field->addBondDamage(1, 0.5f);
+	field->addBondDamage(2, 0.5f);
+	field->addBondDamage(0, 1.0f);
+	EXPECT_EQ(2u, field->getAccumulatedBondCount());
+	NvBlastBondFractureData breakBond2 = commands.bondFractures[0];
+	const NvBlastSupportGraph graph = NvBlastAssetGetSupportGraph(asset, messageLog);
+	for (uint32_t node0 = 0; node0 < graph.nodeCount; node0++)
+	{
+		for (uint32_t i = graph.adjacencyPartition[node0]; i < graph.adjacencyPartition[node0 + 1]; i++)
+		{
+			if (graph.adjacentBondIndices[i] == 2)
+			{
+				breakBond2.nodeIndex0 = node0;
+				breakBond2.nodeIndex1 = graph.adjacentNodeIndices[i];
+			}
+		}
+	}
+	NvBlastFractureBuffers breakCommands = { 1, 0, &breakBond2, nullptr };
+	NvBlastActorApplyFracture(nullptr, actor, &breakCommands, messageLog, nullptr);
+	field->update(0.1f);
+	EXPECT_EQ(1u, field->getAccumulatedBondCount());
+	EXPECT_EQ(1u, field->getPendingBondCount());
+
+	field->generateFractureCommands(commands);
+	ASSERT_EQ(1u, commands.bondFractureCount);
+	NvBlastActorApplyFracture(nullptr, actor, &commands, messageLog, nullptr);
+	EXPECT_EQ(0.0f, bondHealths[1]);
+	EXPECT_EQ(bondCount - 3, (uint32_t)std::count_if(bondHealths, bondHealths + bondCount, [](float health) { return health > 0.0f; }));
+
+	field->release();
+}
+
+TEST_F(DamageShaderTest, DamageFieldFractureCommandsPerActor)
+{
+	NvBlastAsset* asset = createCubeAsset(4);
+	NvBlastActor* actor = createFirstActor(asset);
+	NvBlastFamily* family = NvBlastActorGetFamily(actor, messageLog);
+	const NvBlastSupportGraph graph = NvBlastAssetGetSupportGraph(asset, messageLog);
+	const NvBlastBond* bonds = NvBlastAssetGetBonds(asset, messageLog);
+	const uint32_t bondCount = NvBlastAssetGetBondCount(asset, messageLog);
+
+	std::vector<NvBlastActor*> halves = slice(actor, 0, 0.0f);
+	ASSERT_EQ(2u, halves.size());
+
+	ExtDamageField* field = ExtDamageField::create(*family);
+
+	// break every intact bond in the x < 0 half and one in the other
+	uint32_t negativeBondCount = 0;
+	uint32_t positiveBond = invalidIndex<uint32_t>();
+	for (uint32_t bondIndex = 0; bondIndex < bondCount; bondIndex++)
+	{
+		if (bonds[bondIndex].centroid[0] < 0.0f)
+		{
+			field->addBondDamage(bondIndex, 1.0f);
+			negativeBondCount++;
+		}
+		else if (bonds[bondIndex].centroid[0] > 0.0f && isInvalidIndex(positiveBond))
+		{
+			field->addBondDamage(bondIndex, 1.0f);
+			positiveBond = bondIndex;
+		}
+	}
+	field->update(0.1f);
+	EXPECT_EQ(negativeBondCount + 1, field->getPendingBondCount());
+
+	auto getNodeActor = [&](uint32_t node)
+	{
+		return NvBlastFamilyGetChunkActor(family, graph.chunkIndices[node], messageLog);
+	};
+
+	// one actor per call, the other actor's bonds stay pending
+	uint32_t fracturedBondCount = 0;
+	std::vector<const NvBlastActor*> fracturedActors;
+	for (uint32_t call = 0; call < 2; call++)
+	{
+		const NvBlastActor* actorBuffer[1];
+		NvBlastFractureBuffers commandsBuffer[1];
+		ASSERT_EQ(1u, field->generateFractureCommandsPerActor(actorBuffer, commandsBuffer, 1));
+		EXPECT_TRUE(std::find(halves.begin(), halves.end(), actorBuffer[0]) != halves.end());
+		fracturedActors.push_back(actorBuffer[0]);
+
+		const NvBlastFractureBuffers& commands = commandsBuffer[0];
+		for (uint32_t i = 0; i < commands.bondFractureCount; i++)
+		{
+			EXPECT_EQ(actorBuffer[0], getNodeActor(commands.bondFractures[i].nodeIndex0));
+			EXPECT_EQ(actorBuffer[0], getNodeActor(commands.bondFractures[i].nodeIndex1));
+		}
+		fracturedBondCount += commands.bondFractureCount;
+	}
+	EXPECT_NE(fracturedActors[0], fracturedActors[1]);
+	EXPECT_EQ(negativeBondCount + 1, fracturedBondCount);
+	EXPECT_EQ(0u, field->getAccumulatedBondCount());
+
+	const NvBlastActor* actorBuffer[2];
+	NvBlastFractureBuffers commandsBuffer[2];
+	EXPECT_EQ(0u, field->generateFractureCommandsPerActor(actorBuffer, commandsBuffer, 2));
+
+	field->release();
+}
+
+TEST_F(DamageShaderTest, PatternAcceleratedMatchesBruteForce)
+{
+	NvBlastAsset* asset = createCubeAsset(10);
+	NvBlastActor* actor = createFirstActor(asset);
+	const uint32_t bondCount = NvBlastAssetGetBondCount(asset, messageLog);
+
+	// a triangle in the x = 0 plane, its bounds contain no chunk centroid but it crosses 3 bond segments
+	const NvcVec3 vertices[] = { { 0.0f, -0.02f, -0.02f }, { 0.0f, 0.3f, -0.02f }, { 0.0f, -0.02f, 0.3f } };
+	const uint32_t indices[] = { 0, 1, 2 };
+	NvBlastExtDamagePattern* pattern = NvBlastExtDamagePatternCreate(vertices, indices, 1);
+
+	NvBlastExtDamageAccelerator* accelerators[] = { nullptr, NvBlastExtDamageAcceleratorCreate(asset, 1), NvBlastExtDamageAcceleratorCreate(asset, 2) };
+
+	const NvBlastDamageProgram program = { NvBlastExtPatternGraphShader, NvBlastExtPatternSubgraphShader };
+	auto getFracturedBonds = [&](const NvBlastExtPatternDamageDesc& desc, NvBlastExtDamageAccelerator* accelerator)
+	{
+		std::vector<NvBlastBondFractureData> bondFractures(bondCount);
+		NvBlastFractureBuffers commands = { bondCount, 0, bondFractures.data(), nullptr };
+		const NvBlastExtProgramParams programParams(&desc, nullptr, accelerator);
+		NvBlastActorGenerateFracture(&commands, actor, program, &programParams, messageLog, nullptr);
+
+		std::vector<std::pair<uint32_t, uint32_t>> bonds;
+		for (uint32_t i = 0; i < commands.bondFractureCount; i++)
+		{
+			const NvBlastBondFractureData& data = commands.bondFractures[i];
+			bonds.push_back(std::make_pair(std::min(data.nodeIndex0, data.nodeIndex1), std::max(data.nodeIndex0, data.nodeIndex1)));
+		}
+		std::sort(bonds.begin(), bonds.end());
+		return bonds;
+	};
+
+	NvBlastExtPatternDamageDesc desc = { 1.0f, { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } }, 1.0f, pattern };
+	const std::vector<std::pair<uint32_t, uint32_t>> expected = getFracturedBonds(desc, nullptr);
+	EXPECT_EQ(3u, expected.size());
+	for (NvBlastExtDamageAccelerator* accelerator : accelerators)
+	{
+		EXPECT_EQ(expected, getFracturedBonds(desc, accelerator));
+	}
+
+	std::mt19937 rnd(0);
+	std::uniform_real_distribution<float> coord(-0.5f, 0.5f);
+	std::uniform_real_distribution<float> scale(0.2f, 1.0f);
+	std::normal_distribution<float> normal;
+	for (uint32_t i = 0; i < 20; i++)
+	{
+		float q[4] = { normal(rnd), normal(rnd), normal(rnd), normal(rnd) };
+		const float invLength = 1.0f / PxSqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+		desc.pose.q = { q[0] * invLength, q[1] * invLength, q[2] * invLength, q[3] * invLength };
+		desc.pose.p = { coord(rnd), coord(rnd), coord(rnd) };
+		desc.scale = scale(rnd);
+
+		const std::vector<std::pair<uint32_t, uint32_t>> bruteForce = getFracturedBonds(desc, nullptr);
+		for (NvBlastExtDamageAccelerator* accelerator : accelerators)
+		{
+			EXPECT_EQ(bruteForce, getFracturedBonds(desc, accelerator));
+		}
+	}
+
+	for (NvBlastExtDamageAccelerator* accelerator : accelerators)
+	{
+		if (accelerator != nullptr)
+		{
+			accelerator->release();
+		}
+	}
+	pattern->release();
+}
+
+TEST_F(DamageShaderTest, ExpressionStackedDescs)
+{
+	NvBlastAsset* asset = createCubeAsset(4);
+	NvBlastActor* actor = createFirstActor(asset);
+	const uint32_t bondCount = NvBlastAssetGetBondCount(asset, messageLog);
+	const NvBlastBond* bonds = NvBlastAssetGetBonds(asset, messageLog);
+
+	// bonds along x only, and all bonds
+	NvBlastExtDamageExpression xBondsExpression;
+	EXPECT_TRUE(NvBlastExtDamageExpressionParse(&xBondsExpression, "shape=sphere profile=cutter normal=1,0,0,0.9"));
+	NvBlastExtDamageExpression allBondsExpression;
+	EXPECT_TRUE(NvBlastExtDamageExpressionParse(&allBondsExpression, "shape=sphere profile=cutter"));
+
+	NvBlastExtShapeDamageDesc descs[2];
+	memset(descs, 0, sizeof(descs));
+	descs[0].damage = 0.25f;
+	descs[0].maxRadius = 1.0f;
+	descs[0].expression = &xBondsExpression;
+	descs[1] = descs[0];
+	descs[1].damage = 0.5f;
+	descs[1].expression = &allBondsExpression;
+
+	// each desc's filters apply to its own damage, whatever the expression the program was compiled from
+	for (const NvBlastExtDamageExpression* compiled : { &xBondsExpression, &allBondsExpression })
+	{
+		NvBlastDamageProgram program;
+		ASSERT_TRUE(NvBlastExtDamageExpressionCompile(&program, compiled));
+		const std::vector<float> damages = getBondDamages(actor, program, NvBlastExtProgramParams(descs, nullptr, nullptr, 2));
+		for (uint32_t bondIndex = 0; bondIndex < bondCount; bondIndex++)
+		{
+			EXPECT_EQ(bonds[bondIndex].normal[0] != 0.0f ? 0.75f : 0.5f, damages[bondIndex]);
+		}
+	}
+
+	// descs without expression do no damage, curve profile included
+	NvBlastExtDamageExpression curveExpression;
+	EXPECT_TRUE(NvBlastExtDamageExpressionParse(&curveExpression, "profile=curve curve=1,0.5"));
+	for (const NvBlastExtDamageExpression* compiled : { &allBondsExpression, &curveExpression })
+	{
+		NvBlastDamageProgram program;
+		ASSERT_TRUE(NvBlastExtDamageExpressionCompile(&program, compiled));
+		descs[1].expression = nullptr;
+		const std::vector<float> damages = getBondDamages(actor, program, NvBlastExtProgramParams(&descs[1]));
+		EXPECT_EQ(bondCount, (uint32_t)std::count(damages.begin(), damages.end(), 0.0f));
+	}
+}
+
+class DamageExpressionTest : public BlastBaseTest < -1, 0 >
+{
+};
+
+TEST_F(DamageExpressionTest, Parse)
+{
+	NvBlastExtDamageExpression expression;
+	EXPECT_TRUE(NvBlastExtDamageExpressionParse(&expression, " shape=capsule\tprofile=curve curve=1,1,0.5,0.1 normal=0,1,0,0.7 material=1\n"));
+	EXPECT_EQ(NvBlastExtDamageShape::CAPSULE, expression.shape);
+	EXPECT_EQ(NvBlastExtDamageProfile::CURVE, expression.profile);
+	ASSERT_EQ(4u, expression.curveSize);
+	EXPECT_EQ(1.0f, expression.curve[0]);
+	EXPECT_EQ(0.1f, expression.curve[3]);
+	EXPECT_EQ(1.0f, expression.normal[1]);
+	EXPECT_EQ(0.7f, expression.minNormalDot);
+	EXPECT_TRUE(expression.useMaterial);
+
+	// omitted keys keep their value
+	EXPECT_TRUE(NvBlastExtDamageExpressionParse(&expression, "shape=cone"));
+	EXPECT_EQ(NvBlastExtDamageShape::CONE, expression.shape);
+	EXPECT_EQ(4u, expression.curveSize);
+
+	// malformed values and lists are rejected and keep the previous value
+	const char* invalidTexts[] =
+	{
+		"curve=1,0.5,",
+		"curve=,1",
+		"curve=1,,0.5",
+		"curve=",
+		"curve=1,1,1,1,1,1,1,1,1",
+		"curve=1;0.5",
+		"normal=0,1,0",
+		"normal=0,1,0,0.5,",
+		"normal=0,1,0,0.5,1",
+		"shape=torus",
+		"profile=",
+		"material=2",
+		"unknown=1",
+		"shape",
+	};
+	for (const char* text : invalidTexts)
+	{
+		EXPECT_FALSE(NvBlastExtDamageExpressionParse(&expression, text)) << text;
+	}
+	EXPECT_EQ(4u, expression.curveSize);
+	EXPECT_EQ(1.0f, expression.curve[1]);
+	EXPECT_EQ(0.7f, expression.minNormalDot);
+
+	// the valid tokens of an invalid text are still parsed
+	EXPECT_FALSE(NvBlastExtDamageExpressionParse(&expression, "shape=box curve=1,"));
+	EXPECT_EQ(NvBlastExtDamageShape::BOX, expression.shape);
+
+	EXPECT_FALSE(NvBlastExtDamageExpressionParse(nullptr, "shape=box"));
+	EXPECT_FALSE(NvBlastExtDamageExpressionParse(&expression, nullptr));
+}
+
+TEST_F(DamageExpressionTest, Compile)
+{
+	NvBlastDamageProgram program = { nullptr, nullptr };
+	NvBlastExtDamageExpression expression;
+	EXPECT_FALSE(NvBlastExtDamageExpressionCompile(&program, nullptr));
+	EXPECT_FALSE(NvBlastExtDamageExpressionCompile(nullptr, &expression));
+
+	// every shape and profile has a program
+	for (uint32_t shape = NvBlastExtDamageShape::SPHERE; shape <= NvBlastExtDamageShape::CONE; shape++)
+	{
+		for (uint32_t profile = NvBlastExtDamageProfile::FALLOFF; profile <= NvBlastExtDamageProfile::CURVE; profile++)
+		{
+			expression.shape = static_cast<NvBlastExtDamageShape::Enum>(shape);
+			expression.profile = static_cast<NvBlastExtDamageProfile::Enum>(profile);
+			expression.curveSize = 1;
+			program.graphShaderFunction = nullptr;
+			program.subgraphShaderFunction = nullptr;
+			EXPECT_TRUE(NvBlastExtDamageExpressionCompile(&program, &expression));
+			EXPECT_TRUE(program.graphShaderFunction != nullptr);
+			EXPECT_TRUE(program.subgraphShaderFunction != nullptr);
+		}
+	}
+
+	// the curve profile needs samples
+	expression.profile = NvBlastExtDamageProfile::CURVE;
+	expression.curveSize = 0;
+	EXPECT_FALSE(NvBlastExtDamageExpressionCompile(&program, &expression));
+	expression.curveSize = NVBLASTEXT_DAMAGE_CURVE_MAX_SIZE + 1;
+	EXPECT_FALSE(NvBlastExtDamageExpressionCompile(&program, &expression));
+
+	expression.curveSize = 1;
+	expression.shape = static_cast<NvBlastExtDamageShape::Enum>(NvBlastExtDamageShape::CONE + 1);
+	EXPECT_FALSE(NvBlastExtDamageExpressionCompile(&program, &expression));
+	expression.shape = NvBlastExtDamageShape::SPHERE;
+	expression.profile = static_cast<NvBlastExtDamageProfile::Enum>(NvBlastExtDamageProfile::CURVE + 1);
+	EXPECT_FALSE(NvBlastExtDamageExpressionCompile(&program, &expression));
+}
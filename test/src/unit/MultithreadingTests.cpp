@@ -401,6 +401,124 @@ public:
 		}
 		std::cout << "done.\n";
 	}
+
+	/**
+	Damage familyCount families of the same asset with one shared damage accelerator, one thread per family, and compare 
+	the fracture history of every family with a single threaded run.
+	*/
+	void damageFamiliesSharedAccelerator(uint32_t width, uint32_t familyCount, uint32_t damageCount)
+	{
+		CubeAssetGenerator::Settings settings;
+		settings.extents = GeneratorAsset::Vec3(1, 1, 1);
+		settings.depths.push_back(CubeAssetGenerator::DepthInfo(GeneratorAsset::Vec3(1, 1, 1)));
+		settings.depths.push_back(CubeAssetGenerator::DepthInfo(GeneratorAsset::Vec3((float)width, (float)width, (float)width), NvBlastChunkDesc::SupportFlag));
+
+		GeneratorAsset testAsset;
+		CubeAssetGenerator::generate(testAsset, settings);
+
+		NvBlastAssetDesc desc;
+		desc.chunkDescs = testAsset.solverChunks.data();
+		desc.chunkCount = (uint32_t)testAsset.solverChunks.size();
+		desc.bondDescs = testAsset.solverBonds.data();
+		desc.bondCount = (uint32_t)testAsset.solverBonds.size();
+
+		std::vector<char> scratch;
+		scratch.resize((size_t)NvBlastGetRequiredScratchForCreateAsset(&desc, messageLog));
+		void* mem = alloc(NvBlastGetAssetMemorySize(&desc, messageLog));
+		NvBlastAsset* asset = NvBlastCreateAsset(mem, &desc, scratch.data(), messageLog);
+		EXPECT_TRUE(asset != nullptr);
+
+		NvBlastExtDamageAccelerator* accelerator = NvBlastExtDamageAcceleratorCreate(asset, 1);
+		EXPECT_TRUE(accelerator != nullptr);
+
+		// same damage sequence for every family
+		srand(0);
+		std::vector<NvBlastExtImpactSpreadDamageDesc> damages(damageCount);
+		for (NvBlastExtImpactSpreadDamageDesc& damage : damages)
+		{
+			damage.damage = 0.5f;
+			damage.position[0] = (float)rand() / RAND_MAX - 0.5f;
+			damage.position[1] = (float)rand() / RAND_MAX - 0.5f;
+			damage.position[2] = (float)rand() / RAND_MAX - 0.5f;
+			damage.minRadius = 0.1f;
+			damage.maxRadius = 0.3f;
+		}
+
+		// damages the family's first actor in place, records the fracture command counts
+		auto damageFamily = [&](NvBlastFamily* family, std::vector<uint32_t>& history)
+		{
+			NvBlastActor* actor;
+			NvBlastFamilyGetActors(&actor, 1, family, messageLog);
+
+			std::vector<NvBlastChunkFractureData> chunkEvents(testAsset.solverChunks.size());
+			std::vector<NvBlastBondFractureData> bondEvents(testAsset.solverBonds.size());
+			NvBlastDamageProgram program = { NvBlastExtImpactSpreadGraphShader, nullptr };
+
+			for (const NvBlastExtImpactSpreadDamageDesc& damage : damages)
+			{
+				NvBlastExtProgramParams programParams(&damage, nullptr, accelerator);
+				NvBlastFractureBuffers events = { (uint32_t)bondEvents.size(), (uint32_t)chunkEvents.size(), bondEvents.data(), chunkEvents.data() };
+				NvBlastActorGenerateFracture(&events, actor, program, &programParams, nullptr, nullptr);
+				NvBlastActorApplyFracture(nullptr, actor, &events, nullptr, nullptr);
+				history.push_back(events.bondFractureCount);
+				history.push_back(events.chunkFractureCount);
+			}
+		};
+
+		NvBlastActorDesc actorDesc;
+		actorDesc.initialBondHealths = actorDesc.initialSupportChunkHealths = nullptr;
+		actorDesc.uniformInitialBondHealth = actorDesc.uniformInitialLowerSupportChunkHealth = 1.0f;
+		auto createFamily = [&]()
+		{
+			NvBlastFamily* family = NvBlastAssetCreateFamily(alloc(NvBlastAssetGetFamilyMemorySize(asset, messageLog)), asset, messageLog);
+			std::vector<char> actorScratch((size_t)NvBlastFamilyGetRequiredScratchForCreateFirstActor(family, messageLog));
+			NvBlastActor* actor = NvBlastFamilyCreateFirstActor(family, &actorDesc, actorScratch.data(), messageLog);
+			EXPECT_TRUE(actor != nullptr);
+			return family;
+		};
+		auto releaseFamily = [&](NvBlastFamily* family)
+		{
+			NvBlastActor* actor;
+			NvBlastFamilyGetActors(&actor, 1, family, messageLog);
+			NvBlastActorDeactivate(actor, messageLog);
+			free(family);
+		};
+
+		// reference
+		std::vector<uint32_t> expectedHistory;
+		{
+			NvBlastFamily* family = createFamily();
+			damageFamily(family, expectedHistory);
+			releaseFamily(family);
+		}
+
+		// all families at once
+		std::vector<NvBlastFamily*> families(familyCount);
+		std::vector<std::vector<uint32_t>> histories(familyCount);
+		for (NvBlastFamily*& family : families)
+		{
+			family = createFamily();
+		}
+
+		std::vector<std::thread> threads;
+		for (uint32_t i = 0; i < familyCount; ++i)
+		{
+			threads.push_back(std::thread(damageFamily, families[i], std::ref(histories[i])));
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (uint32_t i = 0; i < familyCount; ++i)
+		{
+			EXPECT_TRUE(histories[i] == expectedHistory);
+			releaseFamily(families[i]);
+		}
+
+		accelerator->release();
+		free(asset);
+	}
 };
 
 
@@ -418,3 +536,8 @@ TEST_F(MultithreadingTestStrict, MultithreadingTestDamageLeafSupportActors)
 {
 	damageLeafSupportActorsParallelized(1, 3000, 1000, 4, nullptr, nullptr);
 }
+
+TEST_F(MultithreadingTestStrict, MultithreadingTestDamageFamiliesSharedAccelerator)
+{
+	damageFamiliesSharedAccelerator(16, 8, 20);
+}
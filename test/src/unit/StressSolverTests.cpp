@@ -0,0 +1,660 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2016-2020 NVIDIA Corporation. All rights reserved.
+
+
+#include "BlastBaseTest.h"
+#include "AssetGenerator.h"
+#include "NvBlastExtStressSolver.h"
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Utils / Tests Common
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace Nv::Blast;
+
+/**
+Runs the jobs of every parallelFor() call on a few threads and counts the calls.
+*/
+class ThreadStressSolverDispatcher : public ExtStressSolverDispatcher
+{
+public:
+	ThreadStressSolverDispatcher(uint32_t threadCount) : parallelForCount(0), m_threadCount(threadCount) {}
+
+	virtual void parallelFor(uint32_t jobCount, JobFunction job, void* jobData) override
+	{
+		std::atomic<uint32_t> nextJob(0);
+		auto worker = [&]()
+		{
+			for (uint32_t jobIndex = nextJob++; jobIndex < jobCount; jobIndex = nextJob++)
+			{
+				job(jobData, jobIndex);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (uint32_t i = 1; i < m_threadCount; i++)
+		{
+			threads.emplace_back(worker);
+		}
+		worker();
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		parallelForCount++;
+	}
+
+	uint32_t parallelForCount;
+
+private:
+	uint32_t m_threadCount;
+};
+
+class StressSolverTest : public BlastBaseTest<NvBlastMessage::Warning, 1>
+{
+public:
+	virtual void TearDown() override
+	{
+		for (void* mem : m_familyMems)
+		{
+			alignedFree(mem);
+		}
+		m_familyMems.clear();
+		for (void* mem : m_assetMems)
+		{
+			alignedFree(mem);
+		}
+		m_assetMems.clear();
+	}
+
+	// slices.x * slices.y * slices.z unit cube support chunks
+	NvBlastAsset* createStructure(const GeneratorAsset::Vec3& slices, CubeAssetGenerator::BondFlags bondFlags)
+	{
+		CubeAssetGenerator::Settings settings;
+		settings.extents = slices;
+		settings.bondFlags = bondFlags;
+		settings.depths.push_back(CubeAssetGenerator::DepthInfo(GeneratorAsset::Vec3(1, 1, 1)));
+		settings.depths.push_back(CubeAssetGenerator::DepthInfo(slices, NvBlastChunkDesc::SupportFlag));
+		GeneratorAsset generatorAsset;
+		CubeAssetGenerator::generate(generatorAsset, settings);
+
+		NvBlastAssetDesc desc;
+		desc.bondCount = (uint32_t)generatorAsset.solverBonds.size();
+		desc.bondDescs = generatorAsset.solverBonds.data();
+		desc.chunkCount = (uint32_t)generatorAsset.solverChunks.size();
+		desc.chunkDescs = generatorAsset.solverChunks.data();
+
+		std::vector<char> scratch((size_t)NvBlastGetRequiredScratchForCreateAsset(&desc, messageLog));
+		void* mem = alignedZeroedAlloc(NvBlastGetAssetMemorySize(&desc, messageLog));
+		NvBlastAsset* asset = NvBlastCreateAsset(mem, &desc, scratch.data(), messageLog);
+		EXPECT_TRUE(asset != nullptr);
+		m_assetMems.push_back(mem);
+		return asset;
+	}
+
+	NvBlastActor* createFirstActor(const NvBlastAsset* asset)
+	{
+		void* mem = alignedZeroedAlloc(NvBlastAssetGetFamilyMemorySize(asset, messageLog));
+		NvBlastFamily* family = NvBlastAssetCreateFamily(mem, asset, messageLog);
+		m_familyMems.push_back(mem);
+
+		NvBlastActorDesc actorDesc;
+		actorDesc.initialBondHealths = actorDesc.initialSupportChunkHealths = nullptr;
+		actorDesc.uniformInitialBondHealth = actorDesc.uniformInitialLowerSupportChunkHealth = 1.0f;
+		std::vector<char> scratch((size_t)NvBlastFamilyGetRequiredScratchForCreateFirstActor(family, messageLog));
+		NvBlastActor* actor = NvBlastFamilyCreateFirstActor(family, &actorDesc, scratch.data(), messageLog);
+		EXPECT_TRUE(actor != nullptr);
+		return actor;
+	}
+
+	// solver with node info from the asset, on every active actor of the family
+	static ExtStressSolver* createSolver(NvBlastFamily* family, const ExtStressSolverSettings& settings)
+	{
+		ExtStressSolver* solver = ExtStressSolver::create(*family, settings);
+		solver->setAllNodesInfoFromLL();
+		for (NvBlastActor* actor : getActors(family))
+		{
+			solver->notifyActorCreated(*actor);
+		}
+		return solver;
+	}
+
+	static std::vector<NvBlastActor*> getActors(const NvBlastFamily* family)
+	{
+		std::vector<NvBlastActor*> actors(NvBlastFamilyGetActorCount(family, messageLog));
+		actors.resize(NvBlastFamilyGetActors(actors.data(), (uint32_t)actors.size(), family, messageLog));
+		return actors;
+	}
+
+	// apply gravity on every actor of the family and update the solver, frameCount times
+	static void update(ExtStressSolver* solver, const NvBlastFamily* family, uint32_t frameCount, NvcVec3 gravity = { 0.0f, -9.81f, 0.0f })
+	{
+		for (uint32_t frame = 0; frame < frameCount; frame++)
+		{
+			for (NvBlastActor* actor : getActors(family))
+			{
+				solver->addGravityForce(*actor, gravity);
+			}
+			solver->update();
+		}
+	}
+
+	// apply the fracture commands to the actor, split it and notify the solver of the actors it was split into
+	static void fractureActor(ExtStressSolver* solver, NvBlastActor* actor, const NvBlastFractureBuffers& commands)
+	{
+		NvBlastActorApplyFracture(nullptr, actor, &commands, messageLog, nullptr);
+
+		std::vector<char> scratch((size_t)NvBlastActorGetRequiredScratchForSplit(actor, messageLog));
+		std::vector<NvBlastActor*> newActors(NvBlastActorGetMaxActorCountForSplit(actor, messageLog));
+		NvBlastActorSplitEvent result;
+		result.deletedActor = nullptr;
+		result.newActors = newActors.data();
+		newActors.resize(NvBlastActorSplit(&result, actor, (uint32_t)newActors.size(), scratch.data(), messageLog, nullptr));
+
+		// without split the actor still lost bonds, notifying it again marks the solver dirty
+		solver->notifyActorDestroyed(*actor);
+		if (newActors.empty())
+		{
+			newActors.push_back(actor);
+		}
+		for (NvBlastActor* newActor : newActors)
+		{
+			solver->notifyActorCreated(*newActor);
+		}
+	}
+
+	// break one bond of the actor holding it
+	static void breakBond(ExtStressSolver* solver, const NvBlastFamily* family, uint32_t bondIndex)
+	{
+		const NvBlastSupportGraph graph = NvBlastAssetGetSupportGraph(NvBlastFamilyGetAsset(family, messageLog), messageLog);
+		NvBlastBondFractureData fracture = { 0, UINT32_MAX, UINT32_MAX, 1.0f };
+		for (uint32_t node = 0; node < graph.nodeCount; node++)
+		{
+			for (uint32_t i = graph.adjacencyPartition[node]; i < graph.adjacencyPartition[node + 1]; i++)
+			{
+				if (graph.adjacentBondIndices[i] == bondIndex)
+				{
+					fracture.nodeIndex0 = node;
+					fracture.nodeIndex1 = graph.adjacentNodeIndices[i];
+				}
+			}
+		}
+		ASSERT_NE(UINT32_MAX, fracture.nodeIndex0);
+
+		for (NvBlastActor* actor : getActors(family))
+		{
+			std::vector<uint32_t> nodes(NvBlastActorGetGraphNodeCount(actor, messageLog));
+			nodes.resize(NvBlastActorGetGraphNodeIndices(nodes.data(), (uint32_t)nodes.size(), actor, messageLog));
+			if (std::find(nodes.begin(), nodes.end(), fracture.nodeIndex0) != nodes.end() || std::find(nodes.begin(), nodes.end(), fracture.nodeIndex1) != nodes.end())
+			{
+				const NvBlastFractureBuffers commands = { 1, 0, &fracture, nullptr };
+				fractureActor(solver, actor, commands);
+				return;
+			}
+		}
+		FAIL() << "no actor holds bond " << bondIndex;
+	}
+
+	// asset bond index between two support graph nodes, UINT32_MAX if none
+	static uint32_t findBond(const NvBlastFamily* family, uint32_t node0, uint32_t node1)
+	{
+		const NvBlastSupportGraph graph = NvBlastAssetGetSupportGraph(NvBlastFamilyGetAsset(family, messageLog), messageLog);
+		for (uint32_t i = graph.adjacencyPartition[node0]; i < graph.adjacencyPartition[node0 + 1]; i++)
+		{
+			if (graph.adjacentNodeIndices[i] == node1)
+			{
+				return graph.adjacentBondIndices[i];
+			}
+		}
+		return UINT32_MAX;
+	}
+
+	static std::vector<float> getBondStresses(const ExtStressSolver* solver, const NvBlastFamily* family)
+	{
+		std::vector<float> stresses(NvBlastAssetGetBondCount(NvBlastFamilyGetAsset(family, messageLog), messageLog));
+		for (uint32_t i = 0; i < stresses.size(); i++)
+		{
+			stresses[i] = solver->getBondStress(i);
+		}
+		return stresses;
+	}
+
+	// every bond stress within relativeTolerance of the highest expected stress
+	static void expectBondStressesNear(const std::vector<float>& expected, const std::vector<float>& actual, float relativeTolerance)
+	{
+		ASSERT_EQ(expected.size(), actual.size());
+		const float maxStress = *std::max_element(expected.begin(), expected.end());
+		EXPECT_GT(maxStress, 0.0f);
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			EXPECT_NEAR(expected[i], actual[i], relativeTolerance * maxStress) << "bond " << i;
+		}
+	}
+
+private:
+	std::vector<void*> m_assetMems;
+	std::vector<void*> m_familyMems;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//													Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(StressSolverTest, DispatcherSameResult)
+{
+	// graph large enough to be solved in batches, with several jobs per color
+	NvBlastAsset* asset = createStructure(GeneratorAsset::Vec3(16, 8, 16), CubeAssetGenerator::ALL_INTERNAL_BONDS | CubeAssetGenerator::Y_MINUS_WORLD_BONDS);
+	NvBlastFamily* family = NvBlastActorGetFamily(createFirstActor(asset), messageLog);
+
+	ExtStressSolverSettings settings;
+	settings.graphReductionLevel = 0;
+	ExtStressSolver* sequential = createSolver(family, settings);
+
+	ThreadStressSolverDispatcher dispatcher(4);
+	settings.dispatcher = &dispatcher;
+	ExtStressSolver* parallel = createSolver(family, settings);
+
+	// bonds of a color don't share dynamic nodes and the job errors are summed in job order, the results are identical
+	for (uint32_t frame = 0; frame < 4; frame++)
+	{
+		update(sequential, family, 1);
+		update(parallel, family, 1);
+		EXPECT_EQ(getBondStresses(sequential, family), getBondStresses(parallel, family));
+		EXPECT_EQ(sequential->getStressErrorLinear(), parallel->getStressErrorLinear());
+		EXPECT_EQ(sequential->getStressErrorAngular(), parallel->getStressErrorAngular());
+	}
+	EXPECT_GT(dispatcher.parallelForCount, 0u);
+
+	sequential->release();
+	parallel->release();
+}
+
+TEST_F(StressSolverTest, BatchedSameResultAsBondByBond)
+{
+	// rows of 8 cantilevered chunks along x then along z, bending under a tilted gravity, with enough bonds to be solved
+	// in batches by default. Every row is statically determinate: solving bonds in batches of a color or one by one
+	// converges to the same impulses.
+	const GeneratorAsset::Vec3 slices[] = { GeneratorAsset::Vec3(8, 16, 16), GeneratorAsset::Vec3(16, 16, 8) };
+	const CubeAssetGenerator::BondFlags bondFlags[] = { CubeAssetGenerator::X_BONDS | CubeAssetGenerator::X_MINUS_WORLD_BONDS, CubeAssetGenerator::Z_BONDS | CubeAssetGenerator::Z_MINUS_WORLD_BONDS };
+	const NvcVec3 gravity = { 3.0f, -9.81f, 2.0f };
+
+	for (uint32_t i = 0; i < 2; i++)
+	{
+		NvBlastAsset* asset = createStructure(slices[i], bondFlags[i]);
+		NvBlastFamily* family = NvBlastActorGetFamily(createFirstActor(asset), messageLog);
+
+		ExtStressSolverSettings settings;
+		settings.graphReductionLevel = 0;
+		settings.bondIterationsPerFrame = 200000;
+		ExtStressSolver* batched = createSolver(family, settings);
+
+		settings.minBatchedBondCount = UINT32_MAX;
+		ExtStressSolver* bondByBond = createSolver(family, settings);
+
+		for (uint32_t frame = 0; frame < 10; frame++)
+		{
+			update(batched, family, 1, gravity);
+			update(bondByBond, family, 1, gravity);
+			expectBondStressesNear(getBondStresses(bondByBond, family), getBondStresses(batched, family), 5.0e-3f);
+			EXPECT_NEAR(bondByBond->getStressErrorLinear(), batched->getStressErrorLinear(), 0.02f * bondByBond->getStressErrorLinear());
+			EXPECT_NEAR(bondByBond->getStressErrorAngular(), batched->getStressErrorAngular(), 0.02f * bondByBond->getStressErrorAngular());
+		}
+		EXPECT_GE(batched->getBondCount(), ExtStressSolverSettings().minBatchedBondCount);
+
+		batched->release();
+		bondByBond->release();
+	}
+}
+
+TEST_F(StressSolverTest, ConjugateGradientSameResultAsImpulse)
+{
+	// a cantilevered row and a column standing on the world, under a tilted gravity, both statically determinate.
+	// The conjugate gradient solver converges within a frame to the stresses the impulse solver reaches over many frames.
+	const GeneratorAsset::Vec3 slices[] = { GeneratorAsset::Vec3(8, 1, 1), GeneratorAsset::Vec3(1, 8, 1) };
+	const CubeAssetGenerator::BondFlags bondFlags[] = { CubeAssetGenerator::X_BONDS | CubeAssetGenerator::X_MINUS_WORLD_BONDS, CubeAssetGenerator::Y_BONDS | CubeAssetGenerator::Y_MINUS_WORLD_BONDS };
+	const NvcVec3 gravity = { 3.0f, -9.81f, 2.0f };
+
+	for (uint32_t i = 0; i < 2; i++)
+	{
+		NvBlastAsset* asset = createStructure(slices[i], bondFlags[i]);
+		NvBlastFamily* family = NvBlastActorGetFamily(createFirstActor(asset), messageLog);
+
+		ExtStressSolverSettings settings;
+		settings.graphReductionLevel = 0;
+		settings.bondIterationsPerFrame = 100000;
+		ExtStressSolver* impulse = createSolver(family, settings);
+
+		settings.solverType = ExtStressSolverType::CONJUGATE_GRADIENT;
+		settings.bondIterationsPerFrame = 1000;
+		ExtStressSolver* conjugateGradient = createSolver(family, settings);
+
+		update(impulse, family, 100, gravity);
+		EXPECT_LT(impulse->getStressErrorLinear(), 1.0e-5f);
+		EXPECT_LT(impulse->getStressErrorAngular(), 1.0e-5f);
+
+		// converged within the first frame, down to the float precision once warm started
+		for (uint32_t frame = 0; frame < 2; frame++)
+		{
+			update(conjugateGradient, family, 1, gravity);
+			expectBondStressesNear(getBondStresses(impulse, family), getBondStresses(conjugateGradient, family), 1.0e-3f);
+		}
+		EXPECT_LT(conjugateGradient->getStressErrorLinear(), 1.0e-6f);
+		EXPECT_LT(conjugateGradient->getStressErrorAngular(), 1.0e-6f);
+
+		impulse->release();
+		conjugateGradient->release();
+	}
+}
+
+TEST_F(StressSolverTest, IncrementalSyncSameResultAsFullSync)
+{
+	// a cantilevered row reduced to pairs of chunks, one pair then split by breaking the bond within it.
+	// The solver reducing again only the split pair must solve the same graph as a new solver reducing the whole family.
+	NvBlastAsset* asset = createStructure(GeneratorAsset::Vec3(8, 1, 1), CubeAssetGenerator::X_BONDS | CubeAssetGenerator::X_MINUS_WORLD_BONDS);
+	NvBlastFamily* family = NvBlastActorGetFamily(createFirstActor(asset), messageLog);
+
+	ExtStressSolverSettings settings;
+	settings.graphReductionLevel = 1;
+	settings.bondIterationsPerFrame = 10000;
+	ExtStressSolver* incremental = createSolver(family, settings);
+	update(incremental, family, 1);
+
+	// the bonds within pairs carry no stress, take one between chunks, the chunk bound to the world being static
+	const std::vector<float> stresses = getBondStresses(incremental, family);
+	const NvBlastSupportGraph graph = NvBlastAssetGetSupportGraph(asset, messageLog);
+	uint32_t internalBond = UINT32_MAX;
+	for (uint32_t node = 0; node < graph.nodeCount; node++)
+	{
+		for (uint32_t i = graph.adjacencyPartition[node]; i < graph.adjacencyPartition[node + 1]; i++)
+		{
+			const uint32_t otherNode = graph.adjacentNodeIndices[i];
+			if (stresses[graph.adjacentBondIndices[i]] == 0.0f && graph.chunkIndices[node] != UINT32_MAX && graph.chunkIndices[otherNode] != UINT32_MAX)
+			{
+				internalBond = graph.adjacentBondIndices[i];
+			}
+		}
+	}
+	ASSERT_NE(UINT32_MAX, internalBond);
+
+	breakBond(incremental, family, internalBond);
+	ExtStressSolver* full = createSolver(family, settings);
+
+	update(incremental, family, 100);
+	update(full, family, 100);
+
+	EXPECT_EQ(full->getBondCount(), incremental->getBondCount());
+	expectBondStressesNear(getBondStresses(full, family), getBondStresses(incremental, family), 1.0e-3f);
+
+	incremental->release();
+	full->release();
+}
+
+TEST_F(StressSolverTest, OverstressedBondsFractureCommands)
+{
+	// rows of cantilevered chunks, hardness lowered until the most stressed bonds are twice above their health
+	NvBlastAsset* asset = createStructure(GeneratorAsset::Vec3(8, 1, 4), CubeAssetGenerator::X_BONDS | CubeAssetGenerator::X_MINUS_WORLD_BONDS);
+	NvBlastActor* actor = createFirstActor(asset);
+	NvBlastFamily* family = NvBlastActorGetFamily(actor, messageLog);
+
+	ExtStressSolverSettings settings;
+	settings.graphReductionLevel = 0;
+	settings.bondIterationsPerFrame = 100000;
+	ExtStressSolver* solver = createSolver(family, settings);
+	update(solver, family, 20);
+	EXPECT_EQ(0u, solver->getOverstressedBondCount());
+
+	std::vector<float> stresses = getBondStresses(solver, family);
+	settings.hardness *= *std::max_element(stresses.begin(), stresses.end()) / 2.0f;
+	solver->setSettings(settings);
+	update(solver, family, 1);
+
+	// every bond is at its full health of 1
+	stresses = getBondStresses(solver, family);
+	std::set<uint32_t> overstressedBonds;
+	for (uint32_t i = 0; i < stresses.size(); i++)
+	{
+		if (stresses[i] > 1.0f)
+		{
+			overstressedBonds.insert(i);
+		}
+	}
+	EXPECT_GT(overstressedBonds.size(), 0u);
+	EXPECT_LT(overstressedBonds.size(), stresses.size());
+	EXPECT_EQ(overstressedBonds.size(), solver->getOverstressedBondCount());
+
+	NvBlastFractureBuffers commands;
+	solver->generateFractureCommands(commands);
+	EXPECT_EQ(0u, commands.chunkFractureCount);
+	std::set<uint32_t> commandedBonds;
+	for (uint32_t i = 0; i < commands.bondFractureCount; i++)
+	{
+		const NvBlastBondFractureData& fracture = commands.bondFractures[i];
+		commandedBonds.insert(findBond(family, fracture.nodeIndex0, fracture.nodeIndex1));
+		EXPECT_EQ(1.0f, fracture.health);
+	}
+	EXPECT_EQ(overstressedBonds, commandedBonds);
+	EXPECT_EQ(overstressedBonds.size(), commands.bondFractureCount);
+
+	solver->generateFractureCommands(*actor, commands);
+	EXPECT_EQ(overstressedBonds.size(), commands.bondFractureCount);
+
+	const NvBlastActor* commandActor = nullptr;
+	ASSERT_EQ(1u, solver->generateFractureCommandsPerActor(&commandActor, &commands, 1));
+	EXPECT_EQ(actor, commandActor);
+	EXPECT_EQ(overstressedBonds.size(), commands.bondFractureCount);
+
+	// broken bonds are skipped until the next update
+	fractureActor(solver, actor, commands);
+	solver->generateFractureCommands(commands);
+	EXPECT_EQ(0u, commands.bondFractureCount);
+	EXPECT_EQ(0u, solver->generateFractureCommandsPerActor(&commandActor, &commands, 1));
+
+	solver->release();
+}
+
+TEST_F(StressSolverTest, BatchSameResultAsSolvers)
+{
+	// two large families solved in their own jobs of the batch dispatch and a small one
+	const GeneratorAsset::Vec3 slices[] = { GeneratorAsset::Vec3(16, 8, 16), GeneratorAsset::Vec3(32, 4, 16), GeneratorAsset::Vec3(4, 4, 4) };
+	const uint32_t familyCount = 3;
+
+	ThreadStressSolverDispatcher dispatcher(4);
+	ExtStressSolverBatch* batch = ExtStressSolverBatch::create(&dispatcher);
+
+	ExtStressSolverSettings settings;
+	settings.graphReductionLevel = 0;
+	std::vector<NvBlastFamily*> families;
+	std::vector<ExtStressSolver*> solvers;
+	std::vector<ExtStressSolver*> batchedSolvers;
+	for (uint32_t i = 0; i < familyCount; i++)
+	{
+		NvBlastAsset* asset = createStructure(slices[i], CubeAssetGenerator::ALL_INTERNAL_BONDS | CubeAssetGenerator::Y_MINUS_WORLD_BONDS);
+		families.push_back(NvBlastActorGetFamily(createFirstActor(asset), messageLog));
+		solvers.push_back(createSolver(families[i], settings));
+		batchedSolvers.push_back(createSolver(families[i], settings));
+		EXPECT_TRUE(batch->addSolver(*batchedSolvers[i]));
+	}
+	EXPECT_FALSE(batch->addSolver(*batchedSolvers[0]));
+	EXPECT_EQ(familyCount, batch->getSolverCount());
+
+	// without budget, every solver runs the iterations of its settings, as when updated alone
+	const NvcVec3 gravity = { 0.0f, -9.81f, 0.0f };
+	for (uint32_t frame = 0; frame < 4; frame++)
+	{
+		for (uint32_t i = 0; i < familyCount; i++)
+		{
+			update(solvers[i], families[i], 1);
+			for (NvBlastActor* actor : getActors(families[i]))
+			{
+				batchedSolvers[i]->addGravityForce(*actor, gravity);
+			}
+		}
+		batch->update();
+
+		for (uint32_t i = 0; i < familyCount; i++)
+		{
+			EXPECT_EQ(getBondStresses(solvers[i], families[i]), getBondStresses(batchedSolvers[i], families[i]));
+			EXPECT_EQ(solvers[i]->getStressErrorLinear(), batchedSolvers[i]->getStressErrorLinear());
+			EXPECT_EQ(solvers[i]->getStressErrorAngular(), batchedSolvers[i]->getStressErrorAngular());
+			EXPECT_EQ(solvers[i]->getFrameCount(), batchedSolvers[i]->getFrameCount());
+		}
+	}
+	EXPECT_GT(dispatcher.parallelForCount, 0u);
+	EXPECT_EQ(familyCount * settings.bondIterationsPerFrame, batch->getBondIterationsPerFrame());
+
+	for (uint32_t i = 0; i < familyCount; i++)
+	{
+		EXPECT_TRUE(batch->removeSolver(*batchedSolvers[i]));
+		batchedSolvers[i]->release();
+		solvers[i]->release();
+	}
+	EXPECT_EQ(0u, batch->getSolverCount());
+	batch->release();
+}
+
+TEST_F(StressSolverTest, SleepsUntilForcesChange)
+{
+	// rows of cantilevered chunks under gravity
+	NvBlastAsset* asset = createStructure(GeneratorAsset::Vec3(8, 1, 4), CubeAssetGenerator::X_BONDS | CubeAssetGenerator::X_MINUS_WORLD_BONDS);
+	NvBlastFamily* family = NvBlastActorGetFamily(createFirstActor(asset), messageLog);
+
+	ExtStressSolverSettings settings;
+	settings.graphReductionLevel = 0;
+	settings.bondIterationsPerFrame = 100000;
+	settings.sleepThreshold = 1.0e-5f;
+	ExtStressSolver* solver = createSolver(family, settings);
+
+	for (uint32_t frame = 0; frame < 100 && !solver->isSleeping(); frame++)
+	{
+		update(solver, family, 1);
+	}
+	ASSERT_TRUE(solver->isSleeping());
+	const std::vector<float> stresses = getBondStresses(solver, family);
+	const float errorLinear = solver->getStressErrorLinear();
+
+	// the same forces, up to a velocity change below the threshold, don't wake it up
+	const NvcVec3 gravity = { 0.0f, -9.81f + 0.5f * settings.sleepThreshold, 0.0f };
+	update(solver, family, 1, gravity);
+	EXPECT_TRUE(solver->isSleeping());
+	EXPECT_EQ(stresses, getBondStresses(solver, family));
+	EXPECT_EQ(errorLinear, solver->getStressErrorLinear());
+
+	// twice the gravity wakes it up, the stress grows towards twice the stress
+	const NvcVec3 doubleGravity = { 0.0f, -2.0f * 9.81f, 0.0f };
+	update(solver, family, 1, doubleGravity);
+	EXPECT_FALSE(solver->isSleeping());
+	const std::vector<float> grownStresses = getBondStresses(solver, family);
+	for (uint32_t i = 0; i < stresses.size(); i++)
+	{
+		EXPECT_GE(grownStresses[i], 1.5f * stresses[i]) << "bond " << i;
+	}
+
+	// back to gravity, it sleeps again once converged to the same stress
+	for (uint32_t frame = 0; frame < 100 && !solver->isSleeping(); frame++)
+	{
+		update(solver, family, 1);
+	}
+	EXPECT_TRUE(solver->isSleeping());
+	expectBondStressesNear(stresses, getBondStresses(solver, family), 1.0e-3f);
+
+	solver->release();
+}
+
+TEST_F(StressSolverTest, BudgetSharesBondIterations)
+{
+	ExtStressSolverBatch* batch = ExtStressSolverBatch::create();
+
+	ExtStressSolverSettings settings;
+	settings.graphReductionLevel = 0;
+	std::vector<NvBlastFamily*> families;
+	std::vector<ExtStressSolver*> solvers;
+	for (uint32_t i = 0; i < 2; i++)
+	{
+		NvBlastAsset* asset = createStructure(GeneratorAsset::Vec3(8, 4, 8), CubeAssetGenerator::ALL_INTERNAL_BONDS | CubeAssetGenerator::Y_MINUS_WORLD_BONDS);
+		families.push_back(NvBlastActorGetFamily(createFirstActor(asset), messageLog));
+		solvers.push_back(createSolver(families[i], settings));
+		batch->addSolver(*solvers[i]);
+	}
+	EXPECT_TRUE(batch->setSolverWeight(*solvers[1], 0.0f));
+
+	auto updateBatch = [&]()
+	{
+		const NvcVec3 gravity = { 0.0f, -9.81f, 0.0f };
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			for (NvBlastActor* actor : getActors(families[i]))
+			{
+				solvers[i]->addGravityForce(*actor, gravity);
+			}
+		}
+		batch->update();
+	};
+
+	// without budget, every solver runs the iterations of its settings
+	updateBatch();
+	EXPECT_EQ(2 * settings.bondIterationsPerFrame, batch->getBondIterationsPerFrame());
+
+	// every solver gets at least one iteration on all its bonds
+	const uint32_t minBondIterations = solvers[0]->getBondCount() + 1;
+	EXPECT_GT(minBondIterations, 1u);
+	EXPECT_EQ(solvers[0]->getBondCount(), solvers[1]->getBondCount());
+
+	// an unlimited budget goes to the solver with a weight, up to its settings, the one without weight gets the minimum
+	batch->setBudget(1.0e9f);
+	EXPECT_EQ(1.0e9f, batch->getBudget());
+	for (uint32_t frame = 0; frame < 2; frame++)
+	{
+		updateBatch();
+		EXPECT_EQ(settings.bondIterationsPerFrame + minBondIterations, batch->getBondIterationsPerFrame());
+	}
+
+	// an exhausted budget leaves them the minimum
+	batch->setBudget(1.0e-9f);
+	updateBatch();
+	EXPECT_EQ(2 * minBondIterations, batch->getBondIterationsPerFrame());
+
+	// the budget is shared, no solver going above its settings
+	batch->setBudget(1.0e9f);
+	EXPECT_TRUE(batch->setSolverWeight(*solvers[1], 1.0f));
+	updateBatch();
+	EXPECT_EQ(2 * settings.bondIterationsPerFrame, batch->getBondIterationsPerFrame());
+
+	for (ExtStressSolver* solver : solvers)
+	{
+		EXPECT_TRUE(batch->removeSolver(*solver));
+		EXPECT_FALSE(batch->setSolverWeight(*solver, 1.0f));
+		solver->release();
+	}
+	batch->release();
+}
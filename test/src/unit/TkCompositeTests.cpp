@@ -54,6 +54,37 @@ Composite and joint tests:
 */
 
 
+/**
+Counts the joint update events received, per subtype.
+*/
+class JointUpdateCounter : public TkEventListener
+{
+public:
+	JointUpdateCounter() : external(0), changed(0), unreferenced(0) {}
+
+	virtual void receive(const TkEvent* events, uint32_t eventCount) override
+	{
+		for (uint32_t i = 0; i < eventCount; ++i)
+		{
+			if (events[i].type == TkEvent::JointUpdate)
+			{
+				const TkJointUpdateEvent* jointEvent = events[i].getPayload<TkJointUpdateEvent>();
+				switch (jointEvent->subtype)
+				{
+				case TkJointUpdateEvent::External:		++external;		break;
+				case TkJointUpdateEvent::Changed:		++changed;		break;
+				case TkJointUpdateEvent::Unreferenced:	++unreferenced;	break;
+				}
+			}
+		}
+	}
+
+	uint32_t	external;
+	uint32_t	changed;
+	uint32_t	unreferenced;
+};
+
+
 struct Composite
 {
 	std::vector<TkActorDesc>		m_actorDescs;
@@ -618,6 +649,10 @@ public:
 		tracker.insertActor(actor1);
 		tracker.insertActor(actor2);
 
+		JointUpdateCounter jointUpdates;
+		family1->addListener(jointUpdates);
+		family2->addListener(jointUpdates);
+
 		TkJointDesc jdesc;
 		jdesc.families[0] = family1;
 		jdesc.families[1] = family2;
@@ -650,6 +685,14 @@ public:
 		EXPECT_TRUE(&jdata.actors[0]->getFamily() == family1);
 		EXPECT_TRUE(&jdata.actors[1]->getFamily() == family2);
 
+		// both split actors list the joint, it must be updated once
+		EXPECT_EQ(0, jointUpdates.external);
+		EXPECT_EQ(1, jointUpdates.changed);
+		EXPECT_EQ(0, jointUpdates.unreferenced);
+
+		family1->removeListener(jointUpdates);
+		family2->removeListener(jointUpdates);
+
 		// Clean up
 		if (explicitJointRelease)
 		{
@@ -38,6 +38,7 @@
 #include "NvBlastTime.h"
 
 #include "NvBlastExtPxTask.h"
+#include "NvBlastExtDamageCoalescer.h"
 
 struct ExpectedVisibleChunks 
 {
@@ -706,6 +707,230 @@ TEST_F(TkTestStrict, ActorDamageBufferedDamage)
 	releaseFramework();
 }
 
+/**
+Counts the damage passes of the counting programs, the coalescer combines any damage queued with them into one pass.
+*/
+static std::atomic<uint32_t> g_countedDamagePasses;
+
+static void CountingShader(NvBlastFractureBuffers* outbuf, const NvBlastGraphShaderActor*, const void*)
+{
+	g_countedDamagePasses++;
+	outbuf->bondFractureCount = 0;
+	outbuf->chunkFractureCount = 0;
+}
+
+static void OtherCountingShader(NvBlastFractureBuffers* outbuf, const NvBlastGraphShaderActor* actor, const void* params)
+{
+	CountingShader(outbuf, actor, params);
+}
+
+class CountingDamageCoalescer : public TkDamageCoalescer
+{
+public:
+	virtual size_t getCombinedParamsSize(const NvBlastDamageProgram&, const void* const*, uint32_t) const override
+	{
+		return sizeof(uint32_t);
+	}
+
+	virtual void combineParams(void*, const NvBlastDamageProgram&, const void* const*, uint32_t, float) const override
+	{
+	}
+};
+
+TEST_F(TkTestStrict, ActorDamageCoalesced)
+{
+	createFramework();
+	TkFramework* fwk = NvBlastTkFrameworkGet();
+
+	TkGroupDesc gdesc;
+	gdesc.workerCount = 1;
+	TkGroup* group = fwk->createGroup(gdesc);
+	EXPECT_TRUE(group != nullptr);
+
+	ExtDamageCoalescer coalescer;
+	group->setDamageCoalescer(&coalescer);
+
+	GeneratorAsset cube;
+	TkAssetDesc assetDesc;
+	generateCube(cube, assetDesc, 4, 2, 3);
+	assetDesc.bondFlags = nullptr;
+	TkAsset* cubeAsset = fwk->createAsset(assetDesc);
+	testAssets.push_back(cubeAsset);
+
+	TkActorDesc cubeAD(cubeAsset);
+
+	auto releaseFamily = [](TkFamily* family)
+	{
+		std::vector<TkActor*> actors(family->getActorCount());
+		family->getActors(actors.data(), static_cast<uint32_t>(actors.size()));
+		for (auto a : actors)
+			a->removeFromGroup();
+		family->release();
+	};
+
+	// same result as ActorDamageBufferedDamage, with the 4 falloff damages applied in one pass
+	{
+		TkActor* actor = fwk->createActor(cubeAD);
+		TkFamily* family = &actor->getFamily();
+		group->addActor(*actor);
+
+		const float P = 0.5f;
+		const float R = 0.35f;
+
+		CSParams csDamage0(0, 0.0f);
+		NvBlastExtProgramParams csDamageParams0 = { &csDamage0, nullptr };
+		CSParams csDamage1(1, 0.0f);
+		NvBlastExtProgramParams csDamageParams1 = { &csDamage1, nullptr };
+		CSParams csDamage2(2, 0.0f);
+		NvBlastExtProgramParams csDamageParams2 = { &csDamage2, nullptr };
+
+		NvBlastExtRadialDamageDesc r[4] = 
+		{
+			getRadialDamageDesc(P, P, 0, R, R),
+			getRadialDamageDesc(-P, P, 0, R, R),
+			getRadialDamageDesc(P, -P, 0, R, R),
+			getRadialDamageDesc(-P, -P, 0, R, R)
+		};
+		NvBlastExtProgramParams rDamageParams[4] = { { &r[0] }, { &r[1] }, { &r[2] }, { &r[3] } };
+
+		actor->damage(getFalloffProgram(), &rDamageParams[0]);
+		actor->damage(getCubeSlicerProgram(), &csDamageParams0);
+		actor->damage(getFalloffProgram(), &rDamageParams[1]);
+		actor->damage(getCubeSlicerProgram(), &csDamageParams1);
+		actor->damage(getFalloffProgram(), &rDamageParams[2]);
+		actor->damage(getCubeSlicerProgram(), &csDamageParams2);
+		actor->damage(getFalloffProgram(), &rDamageParams[3]);
+
+		group->process();
+
+		EXPECT_EQ(16u, family->getActorCount());
+		EXPECT_EQ(16u, group->getActorCount());
+
+		releaseFamily(family);
+	}
+
+	// over the damage count limit, the aggregate damage is scaled down to the limit
+	NvBlastExtRadialDamageDesc weakDamage = getRadialDamageDesc(0, 0, 0, 10.0f, 10.0f, 0.25f);
+	NvBlastExtProgramParams weakDamageParams = { &weakDamage, nullptr };
+	for (uint32_t maxDamageCount : { 2, 0 })
+	{
+		group->setMaxDamageCount(maxDamageCount);
+
+		TkActor* actor = fwk->createActor(cubeAD);
+		TkFamily* family = &actor->getFamily();
+		group->addActor(*actor);
+
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			actor->damage(getFalloffProgram(), &weakDamageParams);
+		}
+
+		group->process();
+
+		// 2 * 0.25 does not break bonds of health 1, 8 * 0.25 does
+		if (maxDamageCount > 0)
+		{
+			EXPECT_EQ(1u, family->getActorCount());
+		}
+		else
+		{
+			EXPECT_LT(1u, family->getActorCount());
+		}
+
+		releaseFamily(family);
+	}
+
+	// combined passes count towards the limit too
+	{
+		CountingDamageCoalescer countingCoalescer;
+		group->setDamageCoalescer(&countingCoalescer);
+		group->setMaxDamageCount(1);
+
+		TkActor* actor = fwk->createActor(cubeAD);
+		TkFamily* family = &actor->getFamily();
+		group->addActor(*actor);
+
+		const NvBlastDamageProgram countingProgram = { CountingShader, nullptr };
+		const NvBlastDamageProgram otherCountingProgram = { OtherCountingShader, nullptr };
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			actor->damage(countingProgram, nullptr);
+			actor->damage(otherCountingProgram, nullptr);
+		}
+
+		g_countedDamagePasses = 0;
+		group->process();
+		EXPECT_EQ(1u, g_countedDamagePasses);
+
+		group->setMaxDamageCount(0);
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			actor->damage(countingProgram, nullptr);
+			actor->damage(otherCountingProgram, nullptr);
+		}
+
+		g_countedDamagePasses = 0;
+		group->process();
+		EXPECT_EQ(2u, g_countedDamagePasses);
+
+		releaseFamily(family);
+		group->setDamageCoalescer(&coalescer);
+	}
+
+	group->release();
+	releaseFramework();
+}
+
+TEST_F(TkTestAllowWarnings, ActorDamageLimitNoCoalescer)
+{
+	createFramework();
+	TkFramework* fwk = NvBlastTkFrameworkGet();
+
+	TkGroupDesc gdesc;
+	gdesc.workerCount = 1;
+	TkGroup* group = fwk->createGroup(gdesc);
+	EXPECT_TRUE(group != nullptr);
+
+	GeneratorAsset cube;
+	TkAssetDesc assetDesc;
+	generateCube(cube, assetDesc, 4, 2, 3);
+	assetDesc.bondFlags = nullptr;
+	TkAsset* cubeAsset = fwk->createAsset(assetDesc);
+	testAssets.push_back(cubeAsset);
+
+	TkActor* actor = fwk->createActor(TkActorDesc(cubeAsset));
+	TkFamily* family = &actor->getFamily();
+	group->addActor(*actor);
+
+	// without a coalescer, only the first maxDamageCount damage calls are applied (and a warning is logged)
+	const NvBlastDamageProgram countingProgram = { CountingShader, nullptr };
+	group->setMaxDamageCount(2);
+	for (uint32_t i = 0; i < 5; i++)
+	{
+		actor->damage(countingProgram, nullptr);
+	}
+
+	g_countedDamagePasses = 0;
+	group->process();
+	EXPECT_EQ(2u, g_countedDamagePasses);
+
+	group->setMaxDamageCount(0);
+	for (uint32_t i = 0; i < 5; i++)
+	{
+		actor->damage(countingProgram, nullptr);
+	}
+
+	g_countedDamagePasses = 0;
+	group->process();
+	EXPECT_EQ(5u, g_countedDamagePasses);
+
+	actor->removeFromGroup();
+	family->release();
+	group->release();
+	releaseFramework();
+}
+
+
 TEST_F(TkTestStrict, CreateActor)
 {
 	createFramework();
@@ -788,6 +1013,68 @@ TEST_F(TkTestStrict, CreateActor)
 	releaseFramework();
 }
 
+TEST_F(TkTestStrict, ObjectHandles)
+{
+	createFramework();
+	createTestAssets();
+
+	TkFramework* framework = NvBlastTkFrameworkGet();
+
+	std::vector<TkActor*> actors;
+	std::vector<TkObjectHandle> handles;
+	for (int i = 0; i < 4; i++)
+	{
+		TkActorDesc desc(testAssets[0]);
+		TkActor* actor = framework->createActor(desc);
+		EXPECT_TRUE(actor != nullptr);
+		actors.push_back(actor);
+
+		const TkObjectHandle handle = framework->getObjectHandle(actor->getFamily());
+		EXPECT_TRUE(handle.isValid());
+		EXPECT_TRUE(framework->resolveObjectHandle(handle) == &actor->getFamily());
+		handles.push_back(handle);
+	}
+
+	// handles do not depend on the object's ID
+	NvBlastID id;
+	memset(&id, 0xAB, sizeof(NvBlastID));
+	actors[1]->getFamily().setID(id);
+	EXPECT_TRUE(framework->resolveObjectHandle(handles[1]) == &actors[1]->getFamily());
+	EXPECT_TRUE(framework->findObjectByID(id) == &actors[1]->getFamily());
+
+	// released objects do not resolve, neither once their slot is reused by new objects
+	actors[1]->getFamily().release();
+	actors[2]->getFamily().release();
+	EXPECT_TRUE(framework->resolveObjectHandle(handles[1]) == nullptr);
+	EXPECT_TRUE(framework->resolveObjectHandle(handles[2]) == nullptr);
+	EXPECT_TRUE(framework->resolveObjectHandle(handles[0]) == &actors[0]->getFamily());
+	EXPECT_TRUE(framework->resolveObjectHandle(handles[3]) == &actors[3]->getFamily());
+
+	TkActorDesc desc(testAssets[0]);
+	TkActor* actor = framework->createActor(desc);
+	const TkObjectHandle handle = framework->getObjectHandle(actor->getFamily());
+	EXPECT_TRUE(framework->resolveObjectHandle(handle) == &actor->getFamily());
+	EXPECT_TRUE(framework->resolveObjectHandle(handles[1]) == nullptr);
+	EXPECT_TRUE(framework->resolveObjectHandle(handles[2]) == nullptr);
+
+	// the object lists stay consistent
+	const TkType* familyType = framework->getType(TkTypeIndex::Family);
+	std::vector<TkIdentifiable*> families(framework->getObjectCount(*familyType));
+	EXPECT_EQ(3u, families.size());
+	framework->getObjects(families.data(), static_cast<uint32_t>(families.size()), *familyType);
+	EXPECT_TRUE(std::find(families.begin(), families.end(), &actors[0]->getFamily()) != families.end());
+	EXPECT_TRUE(std::find(families.begin(), families.end(), &actors[3]->getFamily()) != families.end());
+	EXPECT_TRUE(std::find(families.begin(), families.end(), &actor->getFamily()) != families.end());
+
+	actor->getFamily().release();
+	actors[0]->getFamily().release();
+	actors[3]->getFamily().release();
+
+	releaseTestAssets();
+	releaseFramework();
+}
+
+
 template<int FailMask, int Verbosity>
 TkFamily* TkBaseTest<FailMask, Verbosity>::familySerialization(TkFamily* family)
 {
@@ -1506,6 +1793,66 @@ TEST_F(TkTestStrict, ChangeThreadCountUp)
 	disp4->release();
 }
 
+TEST_F(TkTestStrict, GroupWorkerAcquisition)
+{
+	createFramework();
+	TkFramework* fwk = NvBlastTkFrameworkGet();
+
+	const uint32_t workerCount = 4;
+	TkGroupDesc gdesc;
+	gdesc.workerCount = workerCount;
+	TkGroup* group = fwk->createGroup(gdesc);
+	EXPECT_TRUE(group != nullptr);
+
+	// every worker can be acquired once at the same time
+	std::vector<TkGroupWorker*> workers;
+	for (uint32_t i = 0; i < workerCount; i++)
+	{
+		TkGroupWorker* worker = group->acquireWorker();
+		EXPECT_TRUE(worker != nullptr);
+		EXPECT_TRUE(std::find(workers.begin(), workers.end(), worker) == workers.end());
+		workers.push_back(worker);
+	}
+	EXPECT_TRUE(group->acquireWorker() == nullptr);
+	for (TkGroupWorker* worker : workers)
+	{
+		group->returnWorker(worker);
+	}
+
+	// thread-affine workers: a thread gets the worker it used last, other threads get other workers
+	group->setThreadAffineWorkers(true);
+
+	TkGroupWorker* mainWorker = group->acquireWorker();
+	EXPECT_TRUE(mainWorker != nullptr);
+	group->returnWorker(mainWorker);
+
+	TkGroupWorker* otherWorker = nullptr;
+	std::thread otherThread([&]()
+	{
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			TkGroupWorker* worker = group->acquireWorker();
+			EXPECT_TRUE(otherWorker == nullptr || otherWorker == worker);
+			otherWorker = worker;
+			group->returnWorker(worker);
+		}
+	});
+	otherThread.join();
+
+	EXPECT_TRUE(otherWorker != nullptr);
+	EXPECT_NE(mainWorker, otherWorker);
+
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		TkGroupWorker* worker = group->acquireWorker();
+		EXPECT_EQ(mainWorker, worker);
+		group->returnWorker(worker);
+	}
+
+	group->release();
+	releaseFramework();
+}
+
 TEST_F(TkTestAllowWarnings, GroupNoWorkers)
 {
 	// tests that group still works without a taskmanager